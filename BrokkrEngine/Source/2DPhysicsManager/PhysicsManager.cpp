@@ -3,10 +3,17 @@
 #include <cassert>
 
 #include "EventManager/Event/PayloadComponent/CollisionPayload/CollisionPayload.h"
+#include "Profiler/Profiler.h"
 
 void Brokkr::PhysicsManager::Init()
 {
+    // Hashed by the compiler, handlers are added by hash so the names are never seen otherwise
+    Collider::kUpdatePositionEvent.RegisterName();
+    kOnEnterEvent.RegisterName();
 
+    // A collider moved several times in a frame only needs its last position update, handled after its OnEnters
+    m_pEventManager->SetCoalescePolicy(Collider::kUpdatePositionEvent.GetTypeHash(), EventManager::CoalescePolicy::kLastWins);
+    m_pEventManager->SetCoalescePolicy(kOnEnterEvent.GetTypeHash(), EventManager::CoalescePolicy::kMergePayloads, &MergeOnEnterPayloads);
 }
 
 Brokkr::Collider* Brokkr::PhysicsManager::CreateCollider(const Rectangle<float>& rect, int ownerID, bool isMoveable, int overLap)
@@ -160,70 +167,57 @@ bool Brokkr::PhysicsManager::TestMove(const Collider* pCollider, const Vector2<f
 
 bool Brokkr::PhysicsManager::MoveNotify(Collider* pCollider, const Vector2<float>& newPosition, const Vector2<float>& displacementVector)
 {
-    bool noHit = true;
     Rectangle<float> testColliderMove = pCollider->m_collider;
 
     testColliderMove.MoveTo(newPosition);
     const int overLap = pCollider->m_overlapType;
 
     std::vector<int> result;
-    std::vector<int> resultTwo;
 
     // TODO: Switch to its own method ProcessOverlap or something to help readability
     if (overLap == BROKKR_OVERLAP_STATIC) // Add to the int requested 
     {
         // if it overlaps all static object
         result = m_staticColliderRoot.Query(testColliderMove);
-        for (auto& i : result)
-        {
-            if (pCollider->m_ownerID == i)
-            {
-                continue;
-            }
-
-            DispatchOnEnterEvent(pCollider, i, result, displacementVector);
-            noHit = false;
-        }
     }
     else if (overLap == BROKKR_OVERLAP_DYNAMIC)
     {
         // if it overlaps all dynamic object
         result = m_dynamicColliderRoot.Query(testColliderMove);
-        for (auto& i : result)
-        {
-            if (pCollider->m_ownerID == i)
-            {
-                continue;
-            }
-            DispatchOnEnterEvent(pCollider, i, result, displacementVector);
-            noHit = false;
-        }
     }
     else if (overLap == BROKKR_OVERLAP_ALL)
     {
         // if it overlaps all objects
         result = m_dynamicColliderRoot.Query(testColliderMove);
-        resultTwo = m_staticColliderRoot.Query(testColliderMove);
+        const std::vector<int> resultTwo = m_staticColliderRoot.Query(testColliderMove);
 
         result.insert(result.end(), resultTwo.begin(), resultTwo.end());
+    }
 
-        for (auto& i : result)
-        {
-            if (pCollider->m_ownerID == i)
-            {
-                continue;
-            }
-            DispatchOnEnterEvent(pCollider, i, result, displacementVector);
-            noHit = false;
-        }
+    // Hits other than the mover itself
+    const bool noHit = std::all_of(result.begin(), result.end(), [pCollider](int id) { return id == pCollider->m_ownerID; });
+    if (noHit)
+    {
+        return true;
     }
 
-    if (!noHit)
+    // One copy of the hit list for every event this move sends, it lives until the events are processed
+    const auto hitCount = static_cast<uint32_t>(result.size());
+    const int* pHitIDs = m_pEventManager->GetPayloadArena().Copy(result.data(), result.size());
+
+    for (const int id : result)
     {
-        DispatchOnEnterEvent(pCollider, pCollider->m_ownerID, result, displacementVector);
+        if (pCollider->m_ownerID == id)
+        {
+            continue;
+        }
+
+        DispatchOnEnterEvent(pCollider, id, pHitIDs, hitCount, displacementVector);
     }
 
-    return noHit;
+    DispatchOnEnterEvent(pCollider, pCollider->m_ownerID, pHitIDs, hitCount, displacementVector);
+
+    return false;
 }
 
 std::vector<Brokkr::PhysicsManager::ObjectID> Brokkr::PhysicsManager::QueryAreaDynamics(const Rectangle<float>& area) const
@@ -247,6 +241,12 @@ std::vector<Brokkr::PhysicsManager::ObjectID> Brokkr::PhysicsManager::QueryAreaA
     return resultDynamic;
 }
 
+void Brokkr::PhysicsManager::RegisterStages(FrameScheduler& scheduler)
+{
+    scheduler.AddStage<&PhysicsManager::ProcessUpdate>(EngineDefinitions::STAGE_PHYSICS, FrameScheduler::Phase::kSimulation, this);
+    scheduler.AddDependency(EngineDefinitions::STAGE_PHYSICS, EngineDefinitions::STAGE_UPDATE_ENTITIES);
+}
+
 void Brokkr::PhysicsManager::Destroy()
 {
     m_staticColliderRoot.Destroy();
@@ -259,6 +259,23 @@ void Brokkr::PhysicsManager::Destroy()
 //
 void Brokkr::PhysicsManager::Remove(const Collider* pCollider)
 {
+    m_pEventManager->RemoveHandler(pCollider->m_updateSubscription);
+
+    // A move requested this frame would otherwise be resolved on a freed collider
+    if (!m_processQueue.empty())
+    {
+        std::queue<Collider*> kept;
+        while (!m_processQueue.empty())
+        {
+            if (m_processQueue.front() != pCollider)
+            {
+                kept.push(m_processQueue.front());
+            }
+            m_processQueue.pop();
+        }
+        m_processQueue.swap(kept);
+    }
+
     if (pCollider->m_moveable)
     {
         m_dynamicRects.remove_if([pCollider](const std::unique_ptr<Collider>& collider)
@@ -300,33 +317,39 @@ void Brokkr::PhysicsManager::ProcessUpdate()
     // Create a temporary queue to hold the colliders to process
     std::queue<Collider*> tempQueue;
 
-    // Transfer colliders from the process queue to the temporary queue
-    while (!m_processQueue.empty())
     {
-        Collider* pTemp = m_processQueue.front();
-        auto currentPosition = pTemp->m_collider.GetPosition();
-
-        if (!pTemp->m_frameBlock)
+        // Transfer colliders from the process queue to the temporary queue
+        BROKKR_PROFILE_SCOPE("Resolve Moves");
+        while (!m_processQueue.empty())
         {
-            for (auto& i : pTemp->m_displacements)
+            Collider* pTemp = m_processQueue.front();
+            auto currentPosition = pTemp->m_collider.GetPosition();
+
+            if (!pTemp->m_frameBlock)
             {
-                currentPosition.m_x += i.m_x;
-                currentPosition.m_y += i.m_y;
-                MoveNotify(pTemp, currentPosition, i); // Check the future move
+                for (auto& i : pTemp->m_displacements)
+                {
+                    currentPosition.m_x += i.m_x;
+                    currentPosition.m_y += i.m_y;
+                    MoveNotify(pTemp, currentPosition, i); // Check the future move
+                }
             }
+            pTemp->m_frameBlock = false;
+            m_processQueue.pop();
+            tempQueue.push(pTemp);
         }
-        pTemp->m_frameBlock = false;
-        m_processQueue.pop();
-        tempQueue.push(pTemp);
     }
 
-    // Process the colliders in the temporary queue
-    while (!tempQueue.empty())
     {
-        Collider* pTemp = tempQueue.front();
-        tempQueue.pop();
+        // Process the colliders in the temporary queue
+        BROKKR_PROFILE_SCOPE("Dispatch Position Updates");
+        while (!tempQueue.empty())
+        {
+            Collider* pTemp = tempQueue.front();
+            tempQueue.pop();
 
-        pTemp->DispatchUpdateEvent(m_pEventManager);
+            pTemp->DispatchUpdateEvent(m_pEventManager);
+        }
     }
 
     RefreshDynamicTree();
@@ -336,6 +359,7 @@ void Brokkr::PhysicsManager::ProcessUpdate()
 
 void Brokkr::PhysicsManager::RefreshDynamicTree()
 {
+    BROKKR_PROFILE_FUNCTION();
     m_dynamicColliderRoot.Destroy();
     m_dynamicColliderRoot.Init(m_worldSize);
 
@@ -347,6 +371,7 @@ void Brokkr::PhysicsManager::RefreshDynamicTree()
 
 void Brokkr::PhysicsManager::RefreshStaticTree()
 {
+    BROKKR_PROFILE_FUNCTION();
     m_staticColliderRoot.Destroy();
     m_staticColliderRoot.Init(m_worldSize);
 
@@ -356,19 +381,39 @@ void Brokkr::PhysicsManager::RefreshStaticTree()
     }
 }
 
-void Brokkr::PhysicsManager::DispatchOnEnterEvent(Collider* movingObject, int IDofObjectSendingTo, const std::vector<ObjectID>& hitIDs, const Vector2<float>& displacementVector)
+bool Brokkr::PhysicsManager::MergeOnEnterPayloads(Event& pending, const Event& incoming, FrameArena& arena)
+{
+    const CollisionPayload* pPending = pending.GetComponent<CollisionPayload>();
+    const CollisionPayload* pIncoming = incoming.GetComponent<CollisionPayload>();
+
+    // Hits from different movers need their own corrections
+    if (pPending == nullptr || pIncoming == nullptr || pPending->GetObjectMoving() != pIncoming->GetObjectMoving())
+    {
+        return false;
+    }
+
+    // Both hit lists in one block, the corrections of the two moves add up to one
+    const uint32_t hitCount = pPending->GetHitCount() + pIncoming->GetHitCount();
+    auto* pHitIDs = static_cast<ObjectID*>(arena.Allocate(sizeof(ObjectID) * hitCount, alignof(ObjectID)));
+    std::copy_n(pPending->GetObjectsHit(), pPending->GetHitCount(), pHitIDs);
+    std::copy_n(pIncoming->GetObjectsHit(), pIncoming->GetHitCount(), pHitIDs + pPending->GetHitCount());
+
+    const Vector2<float> displacement = pPending->GetMovingObjectsDisplacement() + pIncoming->GetMovingObjectsDisplacement();
+    pending.AddComponent<CollisionPayload>(pPending->GetObjectMoving(), pHitIDs, hitCount, displacement);
+    return true;
+}
+
+void Brokkr::PhysicsManager::DispatchOnEnterEvent(Collider* movingObject, int IDofObjectSendingTo, const ObjectID* pHitIDs, uint32_t hitCount, const Vector2<float>& displacementVector)
 {
-    
-    const std::string pTemp = m_eventString + std::to_string(IDofObjectSendingTo);
-    m_event = Event::EventType(pTemp.c_str(), Event::kPriorityNormal);
+    Event event(kOnEnterEvent, IDofObjectSendingTo);
 
     //Loading a payload of Data to that allows for responses to the collision
-    m_event.AddComponent<CollisionPayload>(movingObject, hitIDs, displacementVector); // TODO: add logging for if the event payload fails
+    event.AddComponent<CollisionPayload>(movingObject, pHitIDs, hitCount, displacementVector);
 
-    m_pEventManager->PushEvent(m_event);
+    m_pEventManager->PushEvent(event);
 
 #if DEBUG_LOGGING
-    const std::string debugMessage = "Dispatched Collider Event " + pTemp;
+    const std::string debugMessage = "Dispatched Collider Event OnEnter " + std::to_string(IDofObjectSendingTo);
     //m_fileLog.Log(Logger::LogLevel::kDebug, debugMessage);
 #endif
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <queue>
 #include <string>
 
 #include <EventManager/EventManager.h>
@@ -8,6 +9,7 @@
 #include "QuadTree.h"
 #include "Rectangle.h"
 #include "Core/Core.h"
+#include "Core/EngineDefinitions.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 //                             CollisionManager: 
@@ -46,15 +48,12 @@ namespace Brokkr
         bool m_inprocess = false;
         bool m_frameBlock = false;
 
-        EventManager::EventHandler m_updateHandler;
-        Event m_event;
-        std::string m_eventString;
+        EventSubscription m_updateSubscription;
 
-        Collider()
-            : m_event(Event::EventType("ColliderError", Event::kPriorityNormal))
-        {
-            //
-        }
+        // Hashed once, the event is addressed to the owner by id
+        inline static constexpr Event::EventType kUpdatePositionEvent{ EngineDefinitions::UPDATE_TRANSFORM_POSITION_EVENT, Event::kPriorityNormal };
+
+        Collider() = default;
 
         Collider(const Collider&) = delete; // Disable copy constructor
         Collider& operator=(const Collider&) = delete; // Disable copy assignment operator
@@ -94,14 +93,8 @@ namespace Brokkr
 
         void init(EventManager* pEventManager)
         {
-            m_eventString = "UpdatePosition" + std::to_string(m_ownerID);
-
-           // Event Handler for Update Complete event
-            m_updateHandler.first = Event::kPriorityHigh; // update before render data is pushed
-            m_updateHandler.second = [this](auto&& event) { Update(std::forward<decltype(event)>(event)); };
-
-
-            pEventManager->AddHandler(m_eventString.c_str(), m_updateHandler); // this is kinda of hacked in i guess
+           // Event Handler for Update Complete event, update before render data is pushed
+            m_updateSubscription = pEventManager->AddHandler(kUpdatePositionEvent.GetTypeHash(), m_ownerID, Event::kPriorityHigh, EventDelegate::FromMethod<Collider, &Collider::Update>(this));
         }
 
         bool operator==(const Collider& other) const
@@ -111,8 +104,7 @@ namespace Brokkr
 
         void DispatchUpdateEvent(EventManager* pEventManager)
         {
-            m_event = Event::EventType(m_eventString.c_str(), Event::kPriorityNormal);
-            pEventManager->PushEvent(m_event);
+            pEventManager->PushEvent(Event(kUpdatePositionEvent, m_ownerID));
         }
     };
 
@@ -123,10 +115,7 @@ namespace Brokkr
 
         inline static constexpr size_t kMaxDepth = 10;
 
-        EventManager::EventHandler m_updateHandler;
         EventManager* m_pEventManager;
-        std::string m_eventString;
-        Event m_event;
 
         // TODO: sense moving trees to id only the colliders can now be in a vector
         std::list<std::unique_ptr<Collider>> m_dynamicRects;
@@ -140,10 +129,11 @@ namespace Brokkr
         QuadTree m_dynamicColliderRoot;
 
     public:
+        // Sent to each collider a move overlaps, addressed by owner id
+        inline static constexpr Event::EventType kOnEnterEvent{ EngineDefinitions::ON_ENTER_EVENT, Event::kPriorityNormal };
+
         explicit PhysicsManager(CoreSystems* pCoreManager)
             : System(pCoreManager)
-            , m_eventString("OnEnter") // Defaulting the starting world rect size
-            , m_event(Event::EventType("ColliderError", Event::kPriorityNormal))
             , m_staticColliderRoot()
             , m_dynamicColliderRoot()
         {
@@ -167,6 +157,7 @@ namespace Brokkr
         [[nodiscard]] std::vector<ObjectID> QueryAreaStatics(const Rectangle<float>& area) const;
         [[nodiscard]] std::vector<ObjectID> QueryAreaAll(const Rectangle<float>& area) const;
 
+        virtual void RegisterStages(FrameScheduler& scheduler) override;
         virtual void Destroy() override;
         void Remove(const Collider* pCollider);
 
@@ -184,6 +175,9 @@ namespace Brokkr
         void RefreshStaticTree();
 
         // Sends the event for overlap
-        void DispatchOnEnterEvent(Collider* movingObject, int IDofObjectSendingTo, const std::vector<ObjectID>& hitIDs, const Vector2<float>& displacementVector);
+        void DispatchOnEnterEvent(Collider* movingObject, int IDofObjectSendingTo, const ObjectID* pHitIDs, uint32_t hitCount, const Vector2<float>& displacementVector);
+
+        // Coalescing for OnEnter, folds a second hit from the same mover into the pending event
+        static bool MergeOnEnterPayloads(Event& pending, const Event& incoming, FrameArena& arena);
     };
 }
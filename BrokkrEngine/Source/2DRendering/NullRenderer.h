@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+
+#include "SDLRenderer.h"
+
+/////////////////////////////////////////////////
+//          Null Renderer
+//
+// An SDLRenderer that draws nothing, for headless runs (CI, benchmarks) on machines without a GPU. Every draw
+// call is counted and dropped, so the game does all of its own render work and only the backend is missing.
+// It never creates an SDL_Renderer: GetRenderer() is nullptr and textures made from it stay empty.
+//
+//  Example Use:
+//
+//      auto pWindow = pWindowSystem->AddHeadlessWindow<SDLWindow>(EngineDefinitions::GAME_WINDOW_NAME, 1024, 768);
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class NullRenderer final : public SDLRenderer
+    {
+        mutable uint64_t m_drawCalls = 0;
+        uint64_t m_lastFrameDrawCalls = 0;
+
+    public:
+        explicit NullRenderer(SDLWindow* pWindow)
+            : SDLRenderer(pWindow, NoSDLRenderer{})
+        {
+            //
+        }
+
+        virtual void BuildRenderer() override {}
+        virtual void ClearRenderer() override { m_drawCalls = 0; }
+
+        virtual void RenderCopy(SDL_Texture*, int, int, int, int) const override { ++m_drawCalls; }
+        virtual void RenderCopy(SDL_Texture*, Rectangle<int>, Rectangle<int>) const override { ++m_drawCalls; }
+
+        virtual void DisplayRender() override { m_lastFrameDrawCalls = m_drawCalls; }
+
+        virtual void SetRenderDrawColor(const Color*) const override {}
+
+        using SDLRenderer::RenderCircle;
+        using SDLRenderer::RenderSquareFilled;
+        using SDLRenderer::RenderLine;
+
+        virtual void RenderCircle(int, int, int, int, int, int) const override { ++m_drawCalls; }
+        virtual void RenderSquareFilled(int, int, int, int, int, int, int, int) const override { ++m_drawCalls; }
+        virtual void RenderLine(int, int, int, int, int, int, int) const override { ++m_drawCalls; }
+
+        virtual void Destroy() override {}
+
+        // Between the last clear and present
+        [[nodiscard]] uint64_t GetLastFrameDrawCalls() const { return m_lastFrameDrawCalls; }
+    };
+}
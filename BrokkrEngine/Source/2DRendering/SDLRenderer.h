@@ -26,25 +26,36 @@ namespace Brokkr
             BuildRenderer();
         }
 
+    protected:
+        // For renderers without an SDL_Renderer, the constructor above would make one before theirs runs
+        struct NoSDLRenderer {};
+        SDLRenderer(SDLWindow* pWindow, NoSDLRenderer)
+            :m_pWindow(pWindow)
+        {
+            //
+        }
+
+    public:
+
         virtual ~SDLRenderer();
 
         virtual void BuildRenderer();
         virtual void ClearRenderer();
 
-        void RenderCopy(SDL_Texture* texture, int x, int y, int w, int h) const;
-        void RenderCopy(SDL_Texture* texture, Rectangle<int> transform, Rectangle<int> sourceTransform) const;
+        virtual void RenderCopy(SDL_Texture* texture, int x, int y, int w, int h) const;
+        virtual void RenderCopy(SDL_Texture* texture, Rectangle<int> transform, Rectangle<int> sourceTransform) const;
 
         virtual void DisplayRender();
 
-        void SetRenderDrawColor(const Color* pColor) const;
+        virtual void SetRenderDrawColor(const Color* pColor) const;
 
         void RenderCircle(const Circle<int>& pCircle, const Color& pColor) const;
         void RenderSquareFilled(const Rectangle<int>& rectangle, const Color& color) const;
         void RenderLine(const Line<int>& line, const Color& color) const;
 
-        void RenderCircle(int centerX, int centerY, int radius, int red, int green, int blue) const;
-        void RenderSquareFilled(int x, int y, int h, int w, int red, int green, int blue, int opacity) const;
-        void RenderLine(int x1, int y1, int x2, int y2, int red, int green, int blue) const;
+        virtual void RenderCircle(int centerX, int centerY, int radius, int red, int green, int blue) const;
+        virtual void RenderSquareFilled(int x, int y, int h, int w, int red, int green, int blue, int opacity) const;
+        virtual void RenderLine(int x1, int y1, int x2, int y2, int red, int green, int blue) const;
 
         [[nodiscard]] SDL_Renderer* GetRenderer() const { return m_pRenderer; }
 
@@ -1,5 +1,7 @@
 #include "SDLWindowSystem.h"
+#include "NullRenderer.h"
 #include "3DRendering/VulkanRenderer.h"
+#include "Core/EngineDefinitions.h"
 
 void Brokkr::SDLWindowSystem::Render()
 {
@@ -17,6 +19,14 @@ void Brokkr::SDLWindowSystem::ClearRenders()
     }
 }
 
+void Brokkr::SDLWindowSystem::RegisterStages(FrameScheduler& scheduler)
+{
+    scheduler.AddStage<&SDLWindowSystem::ClearRenders>(EngineDefinitions::STAGE_CLEAR_RENDER, FrameScheduler::Phase::kRender, this);
+    scheduler.AddStage<&SDLWindowSystem::Render>(EngineDefinitions::STAGE_PRESENT, FrameScheduler::Phase::kRender, this);
+    scheduler.AddDependency(EngineDefinitions::STAGE_PRESENT, EngineDefinitions::STAGE_CLEAR_RENDER);
+    scheduler.AddDependency(EngineDefinitions::STAGE_PRESENT, EngineDefinitions::STAGE_RENDER_ENTITIES);
+}
+
 template <typename SDLRenderer, typename ... Args>
 SDLRenderer* Brokkr::SDLWindowSystem::AddRenderer(SDLWindow* window, Args&&... args)
 {
@@ -29,3 +39,6 @@ SDLRenderer* Brokkr::SDLWindowSystem::AddRenderer(SDLWindow* window, Args&&... a
 
     return result;
 }
+
+// The definition only lives here, headless windows are added from the game
+template Brokkr::NullRenderer* Brokkr::SDLWindowSystem::AddRenderer<Brokkr::NullRenderer>(SDLWindow* window);
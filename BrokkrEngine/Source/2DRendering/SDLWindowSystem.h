@@ -19,6 +19,7 @@ namespace Brokkr
 {
     class SDLRenderer;
     class VulkanRenderer;
+    class NullRenderer;
 
     class SDLWindowSystem final : public Brokkr::System
     {
@@ -67,6 +68,25 @@ namespace Brokkr
             return result;
         }
 
+        // Add a window that is never drawn to, for headless runs with SDL's dummy video driver
+        template <typename SDLWindow, typename... Args>
+        SDLWindow* AddHeadlessWindow(Args&&... args)
+        {
+            static_assert(std::is_base_of_v<Brokkr::SDLWindow, SDLWindow>,
+                "Window must derive from Brokkr::SDLWindow");
+
+            auto newWindow = std::make_unique<SDLWindow>(std::forward<Args>(args)...);
+            SDLWindow* result = newWindow.get();
+            m_pWindows.emplace_back(std::move(newWindow));
+
+            if (result)
+            {
+                AddRenderer<NullRenderer>(result);
+            }
+
+            return result;
+        }
+
         // Add a new window
         template <typename SDLWindow, typename... Args>
         SDLWindow* AddWindow(Args&&... args)
@@ -153,6 +173,8 @@ namespace Brokkr
         void Render();
         void ClearRenders();
 
+        virtual void RegisterStages(FrameScheduler& scheduler) override;
+
     private:
 
         // Get a renderer by its index
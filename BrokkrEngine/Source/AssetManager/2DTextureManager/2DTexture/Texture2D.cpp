@@ -2,6 +2,7 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include "2DRendering/SDLRenderer.h"
+#include "Profiler/Profiler.h"
 
 Brokkr::Texture2D::Texture2D(const std::string& texturePath, SDLRenderer* pRenderer)
     :m_texturePath(texturePath)
@@ -14,6 +15,7 @@ Brokkr::Texture2D::Texture2D(const void* pData, size_t size, SDLRenderer* pRende
     :m_texturePath("BinaryBuilt" + size)
     ,m_pRenderer(pRenderer)
 {
+    BROKKR_PROFILE_SCOPE("Decode Texture");
     SDL_RWops* pRWops = SDL_RWFromConstMem(pData, static_cast<int>(size));
 
     // SDL_Surface object
@@ -56,6 +58,7 @@ SDL_Texture* Brokkr::Texture2D::GetSDLTexture()
 
     if (m_pTexture == nullptr)    // If texture is not already loaded
     {
+        BROKKR_PROFILE_SCOPE("Load Texture");
         SDL_Surface* pSurface = IMG_Load(m_texturePath.c_str()); // Load the image
         if (pSurface == nullptr)
         {
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "Core/Core.h"
+#include "Utility/TypeSlots.h"
 
 /////////////////////////////////////////////////
 //  TODO: AssetManager
@@ -41,6 +42,7 @@ namespace Brokkr
         SDLWindow* m_pSdlWindow = nullptr;
 
         std::vector<std::unique_ptr<AssetSubsystem>> m_pAssetSystems{ };
+        TypeSlots<AssetSubsystem> m_assetSystemSlots;
 
     public:
         explicit AssetManager(CoreSystems* pCoreManager, SDLRenderer* pSdlRenderer, SDLWindow* pSdlWindow, const char* assetPath)
@@ -54,19 +56,11 @@ namespace Brokkr
 
         void Init();
 
+        // Found by the exact type it was added as, nullptr if there is none
         template <typename AssetSystem>
         AssetSystem* GetAssetSystem()
         {
-            // Iterate through all components in the vector
-            for (auto& component : m_pAssetSystems)
-            {
-                // If the cast is successful
-                if (AssetSystem* target = dynamic_cast<AssetSystem*>(component.get()))
-                {
-                    return target;
-                }
-            }
-            return nullptr; // If no system of type is found
+            return m_assetSystemSlots.Get<AssetSystem>();
         }
 
         template <typename AssetSystem, typename ... Args>
@@ -78,6 +72,7 @@ namespace Brokkr
             AssetSystem* result = newComponent.get(); // Get a raw pointer to the component
 
             m_pAssetSystems.emplace_back(std::move(newComponent)); // Add the system to the vector 
+            m_assetSystemSlots.Set<AssetSystem>(result);
             return result; // Return a pointer
         }
 
@@ -1,7 +1,9 @@
 #include "Core.h"
 
 #include <chrono>
+#include <fstream>
 #include <iostream>
+#include <random>
 
 #include <SDL.h>
 #include <SDL_image.h>
@@ -9,7 +11,14 @@
 #include <SDL_ttf.h>
 #include <SDL_events.h>
 
+#include "EngineDefinitions.h"
+#include "EventManager/EventManager.h"
+#include "Input/InputSystem.h"
+#include "JobSystem/JobSystem.h"
+#include "Profiler/Profiler.h"
 #include "SceneManager/SceneManager.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Random.h"
 
 namespace Core
 {
@@ -22,30 +31,54 @@ namespace Core
 
 void Brokkr::CoreSystems::Update()
 {
-    SDL_Event windowEvent;
+    BROKKR_PROFILE_FUNCTION();
+
     ++frameCount;
 
-    if (SDL_PollEvent(&windowEvent))
+    if (m_pInputSystem)
     {
-        if (SDL_QUIT == windowEvent.type)
+        // All of this frame's input, or the recorded frame's
+        m_pInputSystem->PollEvents();
+
+        if (m_pInputSystem->IsQuitRequested() || m_pInputSystem->HasReplayEnded())
         {
             isRunning = false;
         }
 
+        if (m_pInputSystem->WasKeyPressed(SDLK_F11))
+        {
+            Profiler::RequestCapture(static_cast<uint32_t>(EngineDefinitions::PROFILE_CAPTURE_FRAMES));
+        }
+    }
+    else
+    {
+        SDL_Event windowEvent;
+        while (SDL_PollEvent(&windowEvent))
+        {
+            if (SDL_QUIT == windowEvent.type)
+            {
+                isRunning = false;
+            }
+            else if (SDL_KEYDOWN == windowEvent.type && windowEvent.key.keysym.sym == SDLK_F11 && windowEvent.key.repeat == 0)
+            {
+                Profiler::RequestCapture(static_cast<uint32_t>(EngineDefinitions::PROFILE_CAPTURE_FRAMES));
+            }
+        }
     }
 
-    std::chrono::time_point<std::chrono::steady_clock> thisFrameTime;
-    thisFrameTime = std::chrono::high_resolution_clock::now();
+    // Time between frames, fills the fixed step accumulator
+    m_frameTimer.BeginFrame();
 
-    //Time between frames 
-    std::chrono::duration<double> lastFrameDuration = thisFrameTime - lastFrameTime;
+    // A replay runs the steps the recorded frame ran, the real time does not matter
+    if (m_pInputSystem && m_pInputSystem->IsReplaying())
+    {
+        m_frameTimer.SetStepsThisFrame(m_pInputSystem->GetReplaySteps());
+    }
 
     //Sets the Master copy of Delta Time
-    m_DeltaTime = lastFrameDuration.count();
-    lastFrameTime = thisFrameTime;
+    m_DeltaTime = m_frameTimer.GetFixedStep();
 
-
-    frameTimeMS += lastFrameDuration.count() * 1000.0;
+    frameTimeMS += m_frameTimer.GetFrameSeconds() * 1000.0;
     if (frameTimeMS >= 1000)
     {
         m_currentAverageFPS = frameCount;
@@ -60,8 +93,170 @@ void Brokkr::CoreSystems::Update()
     }
 }
 
+bool Brokkr::CoreSystems::BuildFrameSchedule()
+{
+    for (auto& pSubsystem : m_pCoreSubsystems)
+    {
+        pSubsystem->RegisterStages(m_frameScheduler);
+    }
+
+    m_frameScheduler.SetJobSystem(GetCoreSystem<JobSystem>());
+    if (m_frameScheduler.Build())
+    {
+        return true;
+    }
+
+    // Running in registration order would hide the broken ordering, stop instead
+    std::cout << "FrameScheduler: dependency cycle between";
+    for (const char* pName : m_frameScheduler.GetCycleStages())
+    {
+        std::cout << ' ' << pName;
+    }
+    std::cout << '\n';
+
+    isRunning = false;
+    return false;
+}
+
+void Brokkr::CoreSystems::RunFrame()
+{
+    const uint64_t frameStart = Profiler::GetNanoseconds();
+    uint64_t workEnd = frameStart;
+
+    {
+        BROKKR_PROFILE_SCOPE("Frame");
+
+        Update();
+
+        m_frameScheduler.BeginFrame();
+        m_frameScheduler.RunPhase(FrameScheduler::Phase::kFrameStart);
+
+        while (StepSimulation())
+        {
+            BROKKR_PROFILE_SCOPE("Simulation Step");
+            m_frameScheduler.RunPhase(FrameScheduler::Phase::kSimulation);
+        }
+
+        if (m_pInputSystem)
+        {
+            m_pInputSystem->EndFrame(m_frameTimer.GetStepsThisFrame());
+        }
+
+        m_frameScheduler.RunPhase(FrameScheduler::Phase::kRender);
+        m_frameScheduler.EndFrame();
+        workEnd = Profiler::GetNanoseconds();
+
+        BROKKR_PROFILE_SCOPE("Pace Frame");
+        PaceFrame();
+    }
+
+    // After the frame zone closed so it is part of this frame's collection
+    BROKKR_PROFILE_END_FRAME();
+
+    const bool isBenchmark = m_runOptions.IsBenchmark();
+    if (!m_hitchDetector.IsEnabled() && !isBenchmark)
+    {
+        return;
+    }
+
+    const EventManager* pEventManager = GetCoreSystem<EventManager>();
+    const HitchDetector::FrameSample sample{ frameStart, static_cast<double>(workEnd - frameStart) / 1'000'000.0,
+        pEventManager ? pEventManager->GetProcessedCount() : 0,
+        AllocationTracker::GetAllocationCount(), AllocationTracker::GetAllocatedBytes() };
+
+    m_hitchDetector.EndFrame(sample, m_frameScheduler);
+
+    if (!isBenchmark)
+    {
+        return;
+    }
+
+    ++m_framesRun;
+    if (m_framesRun <= m_runOptions.m_warmupFrames)
+    {
+        if (m_framesRun == m_runOptions.m_warmupFrames)
+        {
+            m_frameStatistics.SetBaseline(sample);
+        }
+        return;
+    }
+
+    m_frameStatistics.AddFrame(sample, m_frameScheduler);
+
+    // A replay that ends or a closed window still gets its report
+    if (m_framesRun - m_runOptions.m_warmupFrames >= m_runOptions.m_frameCount || !isRunning)
+    {
+        FinishBenchmark();
+    }
+}
+
+void Brokkr::CoreSystems::FinishBenchmark()
+{
+    m_frameStatistics.WriteReport(std::cout);
+
+    if (!m_runOptions.m_reportPath.empty())
+    {
+        std::ofstream file(m_runOptions.m_reportPath, std::ios::trunc);
+        m_frameStatistics.WriteJSON(file);
+        if (!file.good())
+        {
+            std::cout << "Benchmark: could not write " << m_runOptions.m_reportPath << '\n';
+        }
+    }
+
+    isRunning = false;
+}
+
+void Brokkr::CoreSystems::SetTickRate(double ticksPerSecond)
+{
+    m_frameTimer.SetTickRate(ticksPerSecond);
+    m_DeltaTime = m_frameTimer.GetFixedStep();
+}
+
+void Brokkr::CoreSystems::SetRunOptions(const RunOptions& options)
+{
+    m_runOptions = options;
+
+    if (m_runOptions.m_isHeadless)
+    {
+        // Read when SDL first starts video and audio, which the first SDL_CreateWindow does
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    }
+}
+
+Brokkr::CoreSystems::~CoreSystems()
+{
+    while (!m_pCoreSubsystems.empty())
+    {
+        m_pCoreSubsystems.pop_back();
+    }
+}
+
 void Brokkr::CoreSystems::Initialize()
 {
+    BROKKR_PROFILE_THREAD_NAME("Main");
+
+    SetTickRate(EngineDefinitions::TICK_RATE);
+    SetMaxCatchUpSteps(EngineDefinitions::MAX_CATCH_UP_STEPS);
+    SetFrameRateLimit(EngineDefinitions::FRAME_RATE_LIMIT);
+
+    // Headless runs the same steps on any machine, frame times are the only thing that differs
+    m_frameTimer.SetOneStepPerFrame(m_runOptions.m_isHeadless);
+
+    m_pInputSystem = GetCoreSystem<InputSystem>();
+    StartInputSession();
+
+    m_hitchDetector.Configure({ static_cast<size_t>(EngineDefinitions::HITCH_WINDOW_FRAMES), EngineDefinitions::HITCH_THRESHOLD,
+        EngineDefinitions::HITCH_MINIMUM_MILLISECONDS, static_cast<size_t>(EngineDefinitions::HITCH_FRAMES_AFTER), EngineDefinitions::HITCH_OUTPUT_PATH });
+    m_hitchDetector.SetEnabled((EngineDefinitions::HITCH_DETECTION || m_runOptions.m_isDetectingHitches) && !m_runOptions.IsBenchmark());
+
+    m_framesRun = 0;
+    if (m_runOptions.IsBenchmark() && m_runOptions.m_frameCount != RunOptions::kWholeReplay)
+    {
+        m_frameStatistics.Reserve(m_runOptions.m_frameCount);
+    }
+
     // attempt to initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
     {
@@ -108,6 +303,45 @@ void Brokkr::CoreSystems::Initialize()
     }
 }
 
+void Brokkr::CoreSystems::StartInputSession()
+{
+    uint32_t seed = m_runOptions.m_seed;
+
+    if (!m_runOptions.m_replayPath.empty())
+    {
+        // The recording's seed and tick rate, the rest of the run has to match it
+        InputSystem::SessionInfo info;
+        if (!m_pInputSystem || !m_pInputSystem->StartReplay(m_runOptions.m_replayPath, info))
+        {
+            std::cout << "Could not replay " << m_runOptions.m_replayPath << '\n';
+            isRunning = false;
+            return;
+        }
+
+        seed = info.m_seed;
+        SetTickRate(info.m_ticksPerSecond);
+    }
+    else if (!m_runOptions.m_recordPath.empty() && m_pInputSystem)
+    {
+        // A replay needs the seed, one from the system is picked here so it can be written down. Never 0, that is unseeded
+        if (seed == 0)
+        {
+            seed = std::random_device()() | 1;
+        }
+
+        m_pInputSystem->StartRecording(m_runOptions.m_recordPath, { seed, m_frameTimer.GetTickRate() });
+    }
+
+    if (seed != 0)
+    {
+        Random::Init(seed);
+    }
+    else
+    {
+        Random::Init();
+    }
+}
+
 void Brokkr::CoreSystems::Destroy()
 {
     // Quit SDL subsystems in reverse order of initialization
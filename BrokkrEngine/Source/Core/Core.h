@@ -2,15 +2,21 @@
 #include <algorithm>
 #include <chrono>
 #include <memory>
-#include <typeinfo>
 #include <vector>
+#include "FrameScheduler.h"
+#include "FrameTimer.h"
+#include "RunOptions.h"
+#include "Profiler/FrameStatistics.h"
+#include "Profiler/HitchDetector.h"
 #include "Utility/DeleteRuleOfFive.h"
+#include "Utility/TypeSlots.h"
 
 namespace Core { void PrintHelloWorld(); }
 
 namespace Brokkr
 {
     class SceneManager;
+    class InputSystem;
     class CoreSystems;
 
     class System : public DeleteRuleOfFive
@@ -26,6 +32,9 @@ namespace Brokkr
         virtual ~System() = default;
         virtual void Destroy() = 0;
 
+        // Adds this system's per frame work to the scheduler, see FrameScheduler.h
+        virtual void RegisterStages([[maybe_unused]] FrameScheduler& scheduler) {}
+
     protected:
         CoreSystems* m_pCoreManager;
     };
@@ -39,13 +48,28 @@ namespace Brokkr
         bool m_SceneManagerSystem = false;
 
         SceneManager* m_pSuperSceneManager = nullptr;
+        InputSystem* m_pInputSystem = nullptr;
 
         int frameCount = 0;
         std::vector<std::unique_ptr<System>> m_pCoreSubsystems;
 
+        // Lookup by type, m_pCoreSubsystems keeps ownership and order
+        TypeSlots<System> m_coreSubsystemSlots;
+
+        // Prints the report, writes the JSON one if asked for and ends the main loop
+        void FinishBenchmark();
+
+        // Starts recording or replaying input as the run options say, and seeds Random
+        void StartInputSession();
+
     protected:
 
-        std::chrono::time_point<std::chrono::steady_clock> lastFrameTime = std::chrono::high_resolution_clock::now();
+        FrameTimer m_frameTimer;
+        FrameScheduler m_frameScheduler;
+        HitchDetector m_hitchDetector;
+        RunOptions m_runOptions;
+        FrameStatistics m_frameStatistics;
+        uint32_t m_framesRun = 0;
         double m_DeltaTime = 0;
         double frameTimeMS = 0;
         int m_currentAverageFPS = 0;
@@ -54,25 +78,51 @@ namespace Brokkr
     public:
         void Update();
 
-        virtual ~CoreSystems() override = default;
+        // Systems are released last added first, entities still reach physics and events while they go
+        virtual ~CoreSystems() override;
         virtual void Initialize();
 
+        // Before any window is added, headless has to pick SDL's drivers first. See RunOptions
+        void SetRunOptions(const RunOptions& options);
+        [[nodiscard]] const RunOptions& GetRunOptions() const { return m_runOptions; }
+        [[nodiscard]] bool IsHeadless() const { return m_runOptions.m_isHeadless; }
+
+        // Simulation step length, fixed so physics and steering integrate the same way at any frame rate
         [[nodiscard]] double GetDeltaTime() const { return m_DeltaTime; }
 
+        // Real time the last frame took
+        [[nodiscard]] double GetFrameTime() const { return m_frameTimer.GetFrameSeconds(); }
+
+        // Blend factor between the previous and current simulation step, for rendering
+        [[nodiscard]] float GetInterpolationAlpha() const { return m_frameTimer.GetInterpolationAlpha(); }
+
+        // Fixed step loop, see FrameTimer. Update() starts the frame, then StepSimulation() until it is false
+        void SetTickRate(double ticksPerSecond);
+        void SetMaxCatchUpSteps(int maxSteps) { m_frameTimer.SetMaxCatchUpSteps(maxSteps); }
+        void SetFrameRateLimit(double framesPerSecond) { m_frameTimer.SetFrameRateLimit(framesPerSecond); }
+        bool StepSimulation() { return m_frameTimer.ConsumeStep(); }
+        void PaceFrame() const { m_frameTimer.PaceFrame(); }
+
+        // Collects every subsystem's stages, call once all systems are added. On a dependency cycle the stages
+        // involved are printed, the main loop is stopped and false is returned
+        bool BuildFrameSchedule();
+
+        // One pass of the main loop: frame start stages, the simulation steps that are due, render stages, pacing
+        void RunFrame();
+
+        [[nodiscard]] FrameScheduler& GetFrameScheduler() { return m_frameScheduler; }
+
+        // Writes the frames around a slow one to disk, see HitchDetector
+        [[nodiscard]] HitchDetector& GetHitchDetector() { return m_hitchDetector; }
+
+        // The measured frames of a benchmark run, see RunOptions
+        [[nodiscard]] const FrameStatistics& GetFrameStatistics() const { return m_frameStatistics; }
+
+        // Found by the exact type it was added as, nullptr if there is none
         template <typename CoreSubsystem>
         CoreSubsystem* GetCoreSystem()
         {
-            // Iterate through all components in the vector
-            for (auto& subsystem : m_pCoreSubsystems)
-            {
-                // If the cast is successful
-                if (CoreSubsystem* target = dynamic_cast<CoreSubsystem*>(subsystem.get()))
-                {
-                    return target;
-                }
-            }
-            // const std::string error = "Error Core System Failed to : Get a Subsystem!";
-            return nullptr; // If no system of type is found
+            return m_coreSubsystemSlots.Get<CoreSubsystem>();
         }
 
         template <typename CoreSubsystem, typename ... Args>
@@ -84,27 +134,30 @@ namespace Brokkr
             std::unique_ptr<CoreSubsystem> newCoreSubsystem = std::make_unique<CoreSubsystem>(this, std::forward<Args>(args)...);
             CoreSubsystem* result = newCoreSubsystem.get(); // Get a raw pointer
             m_pCoreSubsystems.emplace_back(std::move(newCoreSubsystem));
+            m_coreSubsystemSlots.Set<CoreSubsystem>(result);
             return result; // Return a pointer
         }
 
         template<typename CoreSubsystem>
         void RemoveCoreSystem(CoreSubsystem* System)
         {
-            // Iterate through all components in the vector
+            // Only the one registered for the type, compared by address
+            if (System == nullptr || m_coreSubsystemSlots.Get<CoreSubsystem>() != System)
+            {
+                return;
+            }
+
             for (size_t i = 0; i < m_pCoreSubsystems.size(); ++i)
             {
-                // If the cast is successful
-                if (CoreSubsystem* target = dynamic_cast<CoreSubsystem*>(m_pCoreSubsystems[i].get()))
+                if (m_pCoreSubsystems[i].get() == System)
                 {
-                    if (target == System) // If the found type
-                    {
-                        target->Destroy();
-
-                        // Swap and pop the element at index i
-                        std::swap(m_pCoreSubsystems[i], m_pCoreSubsystems.back());
-                        m_pCoreSubsystems.pop_back();
-                        break; // Stop searching
-                    }
+                    System->Destroy();
+                    m_coreSubsystemSlots.Remove<CoreSubsystem>();
+
+                    // Swap and pop the element at index i
+                    std::swap(m_pCoreSubsystems[i], m_pCoreSubsystems.back());
+                    m_pCoreSubsystems.pop_back();
+                    break; // Stop searching
                 }
             }
         }
@@ -113,11 +166,7 @@ namespace Brokkr
         template <typename CoreSubsystem>
         bool IsSystemAvailable()
         {
-            return std::any_of(m_pCoreSubsystems.begin(), m_pCoreSubsystems.end(),
-                [](const std::unique_ptr<System>& system)
-                {
-                    return typeid(*system) == typeid(CoreSubsystem);
-                });
+            return m_coreSubsystemSlots.Get<CoreSubsystem>() != nullptr;
         }
 
         virtual void Destroy();
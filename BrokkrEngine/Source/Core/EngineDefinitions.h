@@ -14,11 +14,50 @@ namespace Brokkr
         inline static const char* ASSETS_PATH = "Assets/";
 
         // Event System
-        inline static const char* UPDATE_EVENT = "Update";
-        inline static const char* UPDATE_TRANSFORM_POSITION_EVENT = "UpdatePosition";
+        inline static constexpr const char* UPDATE_EVENT = "Update";
+        inline static constexpr const char* UPDATE_TRANSFORM_POSITION_EVENT = "UpdatePosition";
+        inline static constexpr const char* ON_ENTER_EVENT = "OnEnter";
 
         inline static int MAX_EVENTS = 256; // No need for constexpr here
 
+        // Main Loop
+        inline static double TICK_RATE = 60.0;          // Simulation steps per second
+        inline static int MAX_CATCH_UP_STEPS = 5;       // Steps a slow frame may run before time is dropped
+        inline static double FRAME_RATE_LIMIT = 144.0;  // 0 for no limit
+
+        // Profiler
+        inline static int PROFILE_CAPTURE_FRAMES = 120;                // F11 or --profile without a count
+        inline static const char* PROFILE_OUTPUT_PATH = "Profiles/";
+
+        // Hitch Detection, see HitchDetector. It keeps the Profiler recording, release builds only do it with --hitches
+#if defined(DEBUG)
+        inline static bool HITCH_DETECTION = true;
+#else
+        inline static bool HITCH_DETECTION = false;
+#endif
+        inline static int HITCH_WINDOW_FRAMES = 120;                   // frames written per hitch
+        inline static int HITCH_FRAMES_AFTER = 10;                     // of those, how many after the hitch
+        inline static double HITCH_THRESHOLD = 2.0;                    // times the median frame
+        inline static double HITCH_MINIMUM_MILLISECONDS = 4.0;
+        inline static const char* HITCH_OUTPUT_PATH = "Profiles/Hitches/";
+
+        // Benchmark Runs, see RunOptions
+        inline static int BENCHMARK_FRAMES = 600;
+        inline static int BENCHMARK_WARMUP_FRAMES = 30;
+        inline static int BENCHMARK_SEED = 1337;
+
+        // Frame Stages, see FrameScheduler
+        inline static constexpr const char* STAGE_MAIN_THREAD_JOBS = "MainThreadJobs";
+        inline static constexpr const char* STAGE_SCENE_UPDATE = "SceneUpdate";
+        inline static constexpr const char* STAGE_UPDATE_ENTITIES = "UpdateEntities";
+        inline static constexpr const char* STAGE_PHYSICS = "Physics";
+        inline static constexpr const char* STAGE_LATE_UPDATE_ENTITIES = "LateUpdateEntities";
+        inline static constexpr const char* STAGE_PROCESS_EVENTS = "ProcessEvents";
+        inline static constexpr const char* STAGE_FLUSH_ENTITY_COMMANDS = "FlushEntityCommands";
+        inline static constexpr const char* STAGE_CLEAR_RENDER = "ClearRender";
+        inline static constexpr const char* STAGE_RENDER_ENTITIES = "RenderEntities";
+        inline static constexpr const char* STAGE_PRESENT = "Present";
+
         // Math
         //static constexpr double PI = 3.141592653589793;
         static constexpr double DEG_TO_RAD = PI / 180.0;
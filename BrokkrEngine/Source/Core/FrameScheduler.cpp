@@ -0,0 +1,232 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "JobSystem/JobSystem.h"
+#include "Profiler/Profiler.h"
+
+bool Brokkr::FrameScheduler::AddStage(const char* pName, Phase phase, StageFunction pFunction, void* pContext, uint32_t flags)
+{
+    const uint32_t id = StringID::FromString(pName).GetHash();
+
+    // A second stage under the same name would take over the first one's dependencies
+    if (!m_stageById.try_emplace(id, m_stages.size()).second)
+    {
+        std::cout << "FrameScheduler: stage " << pName << " was already added, ignored\n";
+        return false;
+    }
+
+    m_stages.push_back({ pName, id, phase, pFunction, pContext, flags });
+    m_isBuilt = false;
+    return true;
+}
+
+void Brokkr::FrameScheduler::AddDependency(const char* pStage, const char* pRunsAfter)
+{
+    m_dependencies.emplace_back(StringID::FromString(pStage).GetHash(), StringID::FromString(pRunsAfter).GetHash());
+    m_isBuilt = false;
+}
+
+bool Brokkr::FrameScheduler::Build()
+{
+    m_cycleStages.clear();
+
+    bool isValid = true;
+    for (size_t phase = 0; phase < static_cast<size_t>(Phase::kCount); ++phase)
+    {
+        isValid &= BuildPhase(static_cast<Phase>(phase));
+    }
+
+    m_timings.clear();
+    for (const Stage& stage : m_stages)
+    {
+        m_timings.push_back({ stage.m_pName, stage.m_phase, stage.m_level, 0, 0.0, 0.0 });
+    }
+
+    m_isBuilt = true;
+    return isValid;
+}
+
+bool Brokkr::FrameScheduler::BuildPhase(Phase phase)
+{
+    auto& levels = m_levels[static_cast<size_t>(phase)];
+    levels.clear();
+
+    std::vector<size_t> phaseStages;
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+        if (m_stages[i].m_phase == phase)
+        {
+            phaseStages.push_back(i);
+        }
+    }
+
+    // Edges between stages of this phase, others are ignored
+    std::vector<std::vector<size_t>> dependents(m_stages.size());
+    std::vector<size_t> waitingOn(m_stages.size(), 0);
+    for (const auto& [stageId, afterId] : m_dependencies)
+    {
+        const auto stageIt = m_stageById.find(stageId);
+        const auto afterIt = m_stageById.find(afterId);
+        if (stageIt == m_stageById.end() || afterIt == m_stageById.end())
+        {
+            continue;
+        }
+
+        const size_t stage = stageIt->second;
+        const size_t after = afterIt->second;
+        if (m_stages[stage].m_phase != phase || m_stages[after].m_phase != phase || stage == after)
+        {
+            continue;
+        }
+
+        dependents[after].push_back(stage);
+        ++waitingOn[stage];
+    }
+
+    // Level by level, a stage lands one past the deepest stage it waits on
+    std::vector<size_t> ready;
+    for (const size_t stage : phaseStages)
+    {
+        m_stages[stage].m_level = 0;
+        if (waitingOn[stage] == 0)
+        {
+            ready.push_back(stage);
+        }
+    }
+
+    size_t placed = 0;
+    while (!ready.empty())
+    {
+        std::sort(ready.begin(), ready.end());
+        levels.push_back(ready);
+        placed += ready.size();
+
+        std::vector<size_t> next;
+        for (const size_t stage : ready)
+        {
+            for (const size_t dependent : dependents[stage])
+            {
+                if (--waitingOn[dependent] == 0)
+                {
+                    m_stages[dependent].m_level = levels.size();
+                    next.push_back(dependent);
+                }
+            }
+        }
+        ready.swap(next);
+    }
+
+    if (placed == phaseStages.size())
+    {
+        return true;
+    }
+
+    // A cycle, fall back to one stage at a time in the order they were added
+    for (const size_t stage : phaseStages)
+    {
+        if (waitingOn[stage] > 0)
+        {
+            m_cycleStages.push_back(m_stages[stage].m_pName);
+        }
+    }
+
+    levels.clear();
+    for (const size_t stage : phaseStages)
+    {
+        m_stages[stage].m_level = levels.size();
+        levels.push_back({ stage });
+    }
+    return false;
+}
+
+void Brokkr::FrameScheduler::BeginFrame()
+{
+    if (!m_isBuilt)
+    {
+        Build();
+    }
+
+    for (Stage& stage : m_stages)
+    {
+        stage.m_frameMilliseconds = 0.0;
+        stage.m_frameRuns = 0;
+    }
+}
+
+void Brokkr::FrameScheduler::RunPhase(Phase phase)
+{
+    static constexpr const char* kPhaseZones[] = { "Frame Start", "Simulation", "Render" };
+    BROKKR_PROFILE_SCOPE(kPhaseZones[static_cast<size_t>(phase)]);
+
+    for (const auto& level : m_levels[static_cast<size_t>(phase)])
+    {
+        // Worker stages first so they run while the main thread gets through its own
+        JobCounter counter;
+        if (m_pJobSystem != nullptr && level.size() > 1)
+        {
+            for (const size_t index : level)
+            {
+                if (m_stages[index].m_flags & StageFlags::kAnyThread)
+                {
+                    m_pJobSystem->Run(&RunStageJob, &m_stages[index], &counter);
+                }
+            }
+        }
+
+        for (const size_t index : level)
+        {
+            Stage& stage = m_stages[index];
+            if (m_pJobSystem == nullptr || level.size() == 1 || (stage.m_flags & StageFlags::kAnyThread) == 0)
+            {
+                RunStage(stage);
+            }
+        }
+
+        if (m_pJobSystem != nullptr)
+        {
+            m_pJobSystem->Wait(counter);
+        }
+    }
+}
+
+void Brokkr::FrameScheduler::EndFrame()
+{
+    constexpr double kSmoothing = 0.1;
+
+    for (size_t i = 0; i < m_stages.size() && i < m_timings.size(); ++i)
+    {
+        StageTiming& timing = m_timings[i];
+        timing.m_runsLastFrame = m_stages[i].m_frameRuns;
+        timing.m_lastFrameMilliseconds = m_stages[i].m_frameMilliseconds;
+        timing.m_averageMilliseconds += (timing.m_lastFrameMilliseconds - timing.m_averageMilliseconds) * kSmoothing;
+    }
+}
+
+void Brokkr::FrameScheduler::WriteTimings(std::ostream& output) const
+{
+    static constexpr const char* kPhaseNames[] = { "FrameStart", "Simulation", "Render" };
+
+    for (const StageTiming& timing : m_timings)
+    {
+        output << kPhaseNames[static_cast<size_t>(timing.m_phase)] << ' ' << timing.m_level << ' ' << timing.m_pName
+            << " runs " << timing.m_runsLastFrame << " last " << timing.m_lastFrameMilliseconds
+            << "ms avg " << timing.m_averageMilliseconds << "ms\n";
+    }
+}
+
+void Brokkr::FrameScheduler::RunStage(Stage& stage)
+{
+    BROKKR_PROFILE_SCOPE(stage.m_pName);
+    const auto start = std::chrono::steady_clock::now();
+    stage.m_pFunction(stage.m_pContext);
+    stage.m_frameMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ++stage.m_frameRuns;
+}
+
+void Brokkr::FrameScheduler::RunStageJob(void* pContext)
+{
+    RunStage(*static_cast<Stage*>(pContext));
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "Utility/StringID.h"
+
+/////////////////////////////////////////////////
+//          Frame Scheduler
+//
+// The frame as a set of named stages instead of a hardcoded call list. Systems add their stages from
+// System::RegisterStages and say which stages they run after, the scheduler sorts each phase into levels:
+// every stage in a level only depends on earlier levels, so the stages of one level can run side by side.
+//
+//  Phases, in this order every frame:
+//      kFrameStart  - once, before the simulation
+//      kSimulation  - once per fixed step (see FrameTimer)
+//      kRender      - once, after the simulation
+//
+//  Example Use:
+//
+//      void PhysicsManager::RegisterStages(FrameScheduler& scheduler)
+//      {
+//          scheduler.AddStage<&PhysicsManager::ProcessUpdate>(EngineDefinitions::STAGE_PHYSICS, FrameScheduler::Phase::kSimulation, this);
+//          scheduler.AddDependency(EngineDefinitions::STAGE_PHYSICS, EngineDefinitions::STAGE_UPDATE_ENTITIES);
+//      }
+//
+// Stages run on the main thread unless added with StageFlags::kAnyThread, those go to the JobSystem when one
+// is set. A dependency on a stage nobody added is ignored, so a system can order itself against optional ones.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class JobSystem;
+
+    struct StageFlags
+    {
+        inline static constexpr uint32_t kMainThread = 0;
+        inline static constexpr uint32_t kAnyThread = 1 << 0;  // touches nothing another stage of its level does
+    };
+
+    class FrameScheduler
+    {
+    public:
+        using StageFunction = void(*)(void* pContext);
+
+        enum class Phase
+        {
+            kFrameStart,
+            kSimulation,
+            kRender,
+            kCount
+        };
+
+        struct StageTiming
+        {
+            const char* m_pName;
+            Phase m_phase;
+            size_t m_level;
+            uint32_t m_runsLastFrame;           // simulation stages run once per step
+            double m_lastFrameMilliseconds;     // all runs of the last frame together
+            double m_averageMilliseconds;       // per frame, smoothed
+        };
+
+    private:
+        struct Stage
+        {
+            const char* m_pName;
+            uint32_t m_id;
+            Phase m_phase;
+            StageFunction m_pFunction;
+            void* m_pContext;
+            uint32_t m_flags;
+            size_t m_level = 0;
+
+            // Written only by whichever thread runs the stage
+            double m_frameMilliseconds = 0.0;
+            uint32_t m_frameRuns = 0;
+        };
+
+        std::vector<Stage> m_stages;
+        std::unordered_map<uint32_t, size_t> m_stageById;
+
+        // stage id, id of the stage it runs after
+        std::vector<std::pair<uint32_t, uint32_t>> m_dependencies;
+
+        // Per phase, stage indices per level in registration order
+        std::vector<std::vector<size_t>> m_levels[static_cast<size_t>(Phase::kCount)];
+
+        // Stages a failed Build could not order, the ones in a cycle and any waiting on them
+        std::vector<const char*> m_cycleStages;
+
+        std::vector<StageTiming> m_timings;
+        JobSystem* m_pJobSystem = nullptr;
+        bool m_isBuilt = false;
+
+    public:
+        // The name is kept as a pointer, pass a literal or one of the EngineDefinitions names.
+        // Names are unique, adding one a second time is refused and returns false
+        bool AddStage(const char* pName, Phase phase, StageFunction pFunction, void* pContext, uint32_t flags = StageFlags::kMainThread);
+
+        template <auto Method, typename Type>
+        bool AddStage(const char* pName, Phase phase, Type* pInstance, uint32_t flags = StageFlags::kMainThread)
+        {
+            return AddStage(pName, phase, [](void* pContext) { std::invoke(Method, static_cast<Type*>(pContext)); }, pInstance, flags);
+        }
+
+        // stage runs after runsAfter, both in the same phase
+        void AddDependency(const char* pStage, const char* pRunsAfter);
+
+        // Sorts the stages into levels, false on a dependency cycle (the phase then runs in registration order)
+        bool Build();
+
+        // After a failed Build, the stages that could not be ordered
+        [[nodiscard]] const std::vector<const char*>& GetCycleStages() const { return m_cycleStages; }
+
+        void SetJobSystem(JobSystem* pJobSystem) { m_pJobSystem = pJobSystem; }
+
+        void BeginFrame();
+        void RunPhase(Phase phase);
+        void EndFrame();
+
+        [[nodiscard]] const std::vector<StageTiming>& GetStageTimings() const { return m_timings; }
+        void WriteTimings(std::ostream& output) const;
+
+    private:
+        bool BuildPhase(Phase phase);
+        static void RunStage(Stage& stage);
+        static void RunStageJob(void* pContext);
+    };
+}
@@ -0,0 +1,115 @@
+#include "FrameTimer.h"
+
+#include <thread>
+
+void Brokkr::FrameTimer::SetTickRate(double ticksPerSecond)
+{
+    if (ticksPerSecond > 0.0)
+    {
+        m_ticksPerSecond = ticksPerSecond;
+        m_fixedStep = 1.0 / ticksPerSecond;
+    }
+}
+
+void Brokkr::FrameTimer::SetFrameRateLimit(double framesPerSecond)
+{
+    if (framesPerSecond <= 0.0)
+    {
+        m_targetFrameTime = Clock::duration::zero();
+        return;
+    }
+
+    m_targetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond));
+}
+
+void Brokkr::FrameTimer::SetOneStepPerFrame(bool isOneStepPerFrame)
+{
+    m_isOneStepPerFrame = isOneStepPerFrame;
+    m_accumulator = 0.0;
+}
+
+void Brokkr::FrameTimer::BeginFrame()
+{
+    const Clock::time_point now = Clock::now();
+    m_frameSeconds = std::chrono::duration<double>(now - m_frameStart).count();
+    m_frameStart = now;
+    m_scriptedSteps = -1;
+
+    if (m_isOneStepPerFrame)
+    {
+        m_accumulator = m_fixedStep;
+        m_stepsThisFrame = 0;
+        return;
+    }
+
+    m_accumulator += m_frameSeconds < kMaxFrameSeconds ? m_frameSeconds : kMaxFrameSeconds;
+    m_stepsThisFrame = 0;
+
+    // Past the catch up limit, keep only what the allowed steps can use plus the partial step
+    const double maxAccumulated = m_fixedStep * (m_maxCatchUpSteps + 1);
+    if (m_accumulator >= maxAccumulated)
+    {
+        const double excess = m_accumulator - m_fixedStep * m_maxCatchUpSteps;
+        const int dropped = static_cast<int>(excess / m_fixedStep);
+        m_droppedSteps += dropped;
+        m_accumulator -= dropped * m_fixedStep;
+    }
+}
+
+void Brokkr::FrameTimer::SetStepsThisFrame(int steps)
+{
+    // Nothing carries over, the next real time frame starts from an empty accumulator
+    m_scriptedSteps = steps < 0 ? 0 : steps;
+    m_accumulator = 0.0;
+    m_stepsThisFrame = 0;
+}
+
+bool Brokkr::FrameTimer::ConsumeStep()
+{
+    if (m_scriptedSteps >= 0)
+    {
+        if (m_stepsThisFrame >= m_scriptedSteps)
+        {
+            return false;
+        }
+
+        ++m_stepsThisFrame;
+        return true;
+    }
+
+    if (m_accumulator < m_fixedStep || m_stepsThisFrame >= m_maxCatchUpSteps)
+    {
+        return false;
+    }
+
+    m_accumulator -= m_fixedStep;
+    ++m_stepsThisFrame;
+    return true;
+}
+
+void Brokkr::FrameTimer::PaceFrame() const
+{
+    if (m_targetFrameTime == Clock::duration::zero() || m_isOneStepPerFrame)
+    {
+        return;
+    }
+
+    const Clock::time_point frameEnd = m_frameStart + m_targetFrameTime;
+    for (;;)
+    {
+        const Clock::duration remaining = frameEnd - Clock::now();
+        if (remaining <= Clock::duration::zero())
+        {
+            return;
+        }
+
+        if (remaining > kSpinWindow)
+        {
+            std::this_thread::sleep_for(remaining - kSpinWindow);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <chrono>
+
+/////////////////////////////////////////////////
+//          Frame Timer
+//
+// Fixed step clock for the main loop. Each frame the real time since the last one goes into an accumulator,
+// the simulation then runs as many fixed steps as the accumulator holds and rendering blends the last two
+// steps with GetInterpolationAlpha(). PaceFrame() sleeps off whatever is left of the frame budget and only
+// spins for the last bit, where sleep is too coarse to hit the target.
+//
+//  Example Use:
+//
+//      timer.BeginFrame();
+//      while (timer.ConsumeStep())
+//      {
+//          Simulate(timer.GetFixedStep());
+//      }
+//      Render(timer.GetInterpolationAlpha());
+//      timer.PaceFrame();
+//
+// When a frame falls more than the catch up limit behind, the extra time is dropped instead of being run
+// later, the game slows down rather than locking up in ever longer catch up frames.
+//
+// With one step per frame set the real time is still measured but ignored: every frame runs exactly one step
+// and nothing is paced, so a run is the same however fast the machine is (headless benchmarks).
+//
+// A replay sets the step count of each frame to what the recorded frame ran, SetStepsThisFrame after BeginFrame.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class FrameTimer
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Spin rather than sleep when less than this is left, sleeps can overshoot by about this much
+        inline static constexpr std::chrono::microseconds kSpinWindow{ 1000 };
+
+        // A frame longer than this (a breakpoint, a window drag) counts as this long
+        inline static constexpr double kMaxFrameSeconds = 0.25;
+
+        Clock::time_point m_frameStart = Clock::now();
+
+        double m_ticksPerSecond = 60.0;
+        double m_fixedStep = 1.0 / 60.0;
+        int m_maxCatchUpSteps = 5;
+        Clock::duration m_targetFrameTime = Clock::duration::zero();
+
+        double m_accumulator = 0.0;
+        double m_frameSeconds = 0.0;
+        int m_stepsThisFrame = 0;
+        int m_droppedSteps = 0;
+        int m_scriptedSteps = -1;       // this frame's steps when set, -1 for real time
+        bool m_isOneStepPerFrame = false;
+
+    public:
+        // Simulation rate in steps per second
+        void SetTickRate(double ticksPerSecond);
+        void SetMaxCatchUpSteps(int maxSteps) { m_maxCatchUpSteps = maxSteps < 1 ? 1 : maxSteps; }
+
+        // 0 or less turns pacing off
+        void SetFrameRateLimit(double framesPerSecond);
+
+        // Exactly one fixed step each frame whatever the real time, and no pacing
+        void SetOneStepPerFrame(bool isOneStepPerFrame);
+        [[nodiscard]] bool IsOneStepPerFrame() const { return m_isOneStepPerFrame; }
+
+        // Measures the last frame and adds it to the accumulator
+        void BeginFrame();
+
+        // After BeginFrame, the frame runs exactly this many steps whatever the real time or the catch up limit
+        void SetStepsThisFrame(int steps);
+
+        // True while a fixed step is due this frame, call until it returns false
+        bool ConsumeStep();
+
+        // Waits until the frame has taken its target time, no-op without a frame rate limit
+        void PaceFrame() const;
+
+        [[nodiscard]] double GetTickRate() const { return m_ticksPerSecond; }
+        [[nodiscard]] double GetFixedStep() const { return m_fixedStep; }
+        [[nodiscard]] double GetFrameSeconds() const { return m_frameSeconds; }
+
+        // How far between the previous and the latest step the current time is, 0 to 1
+        [[nodiscard]] float GetInterpolationAlpha() const { return static_cast<float>(m_accumulator / m_fixedStep); }
+
+        [[nodiscard]] int GetStepsThisFrame() const { return m_stepsThisFrame; }
+
+        // Steps thrown away because of the catch up limit, since start
+        [[nodiscard]] int GetDroppedSteps() const { return m_droppedSteps; }
+    };
+}
@@ -0,0 +1,91 @@
+#include "RunOptions.h"
+
+#include <cstdlib>
+#include <string_view>
+
+#include "EngineDefinitions.h"
+
+namespace
+{
+    // The value of --name=value, nullptr if the argument is something else
+    const char* GetValue(std::string_view argument, std::string_view name)
+    {
+        if (argument.size() > name.size() && argument.substr(0, name.size()) == name && argument[name.size()] == '=')
+        {
+            return argument.data() + name.size() + 1;
+        }
+        return nullptr;
+    }
+}
+
+Brokkr::RunOptions Brokkr::RunOptions::FromCommandLine(int argc, char* argv[])
+{
+    RunOptions options;
+    bool hasFrames = false;
+    bool hasWarmup = false;
+    bool hasSeed = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        if (argument == "--headless")
+        {
+            options.m_isHeadless = true;
+        }
+        else if (argument == "--hitches")
+        {
+            options.m_isDetectingHitches = true;
+        }
+        else if (argument == "--tests")
+        {
+            options.m_isTestingForced = true;
+        }
+        else if (const char* pFrames = GetValue(argument, "--frames"))
+        {
+            options.m_frameCount = static_cast<uint32_t>(std::strtoul(pFrames, nullptr, 10));
+            hasFrames = true;
+        }
+        else if (const char* pWarmup = GetValue(argument, "--warmup"))
+        {
+            options.m_warmupFrames = static_cast<uint32_t>(std::strtoul(pWarmup, nullptr, 10));
+            hasWarmup = true;
+        }
+        else if (const char* pSeed = GetValue(argument, "--seed"))
+        {
+            options.m_seed = static_cast<uint32_t>(std::strtoul(pSeed, nullptr, 10));
+            hasSeed = true;
+        }
+        else if (const char* pPath = GetValue(argument, "--benchmark-report"))
+        {
+            options.m_reportPath = pPath;
+        }
+        else if (const char* pRecord = GetValue(argument, "--record"))
+        {
+            options.m_recordPath = pRecord;
+        }
+        else if (const char* pReplay = GetValue(argument, "--replay"))
+        {
+            options.m_replayPath = pReplay;
+        }
+    }
+
+    // Headless is for benchmarks, it needs an end and the same random numbers every run
+    if (options.m_isHeadless)
+    {
+        if (!hasFrames)
+        {
+            options.m_frameCount = options.m_replayPath.empty() ? static_cast<uint32_t>(EngineDefinitions::BENCHMARK_FRAMES) : kWholeReplay;
+        }
+        if (!hasSeed)
+        {
+            options.m_seed = static_cast<uint32_t>(EngineDefinitions::BENCHMARK_SEED);
+        }
+    }
+
+    if (options.IsBenchmark() && !hasWarmup)
+    {
+        options.m_warmupFrames = static_cast<uint32_t>(EngineDefinitions::BENCHMARK_WARMUP_FRAMES);
+    }
+
+    return options;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/////////////////////////////////////////////////
+//          Run Options
+//
+// How the game is run, from the command line. Applied with CoreSystems::SetRunOptions before any window exists,
+// SDL picks its video driver when the first window is made.
+//
+//  Command line:
+//
+//      --headless              SDL dummy video and audio drivers, a NullRenderer, one fixed step per frame
+//      --frames=N              measure N frames, print the report and quit (headless defaults to BENCHMARK_FRAMES)
+//      --warmup=N              frames run before measuring starts, scene loading stays out of the numbers
+//      --seed=N                seeds Random, headless defaults to BENCHMARK_SEED
+//      --benchmark-report=path also writes the report as JSON, for CI to compare runs
+//      --record=path           records the input of the session, see InputSystem
+//      --replay=path           plays a recording back instead of live input, the run ends with it
+//      --hitches               hitch detection in any build, debug builds have it on (EngineDefinitions::HITCH_DETECTION)
+//      --tests                 runs the unit tests even for a benchmark, recording or replay
+//
+// A headless run with a seed runs the same simulation every time, only the timings change between machines.
+// Replaying a recording headless runs a played session the same way, its whole length unless --frames is given.
+// The unit tests run before the game, but not ahead of a benchmark, a recording or a replay unless asked for: they
+// touch the same world and random numbers, and their time would land in the run.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    struct RunOptions
+    {
+        // Frame count of a headless replay, it measures until the recording ends
+        inline static constexpr uint32_t kWholeReplay = UINT32_MAX;
+
+        bool m_isHeadless = false;
+        bool m_isDetectingHitches = false;
+        bool m_isTestingForced = false;
+        uint32_t m_frameCount = 0;      // 0 runs until the window is closed
+        uint32_t m_warmupFrames = 0;
+        uint32_t m_seed = 0;            // 0 seeds from the system
+        std::string m_reportPath;
+        std::string m_recordPath;
+        std::string m_replayPath;
+
+        [[nodiscard]] bool IsBenchmark() const { return m_frameCount > 0; }
+        [[nodiscard]] bool IsRunningTests() const { return m_isTestingForced || (!IsBenchmark() && m_recordPath.empty() && m_replayPath.empty()); }
+
+        static RunOptions FromCommandLine(int argc, char* argv[]);
+    };
+}
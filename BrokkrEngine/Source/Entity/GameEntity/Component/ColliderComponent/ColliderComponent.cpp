@@ -5,7 +5,9 @@
 #include "GameEntity.h"
 #include "TransformComponent.h"
 
+#include "Entity/GameEntityManager/GameEntityManager.h"
 #include "EventManager/Event/PayloadComponent/CollisionPayload/CollisionPayload.h"
+#include "Utility/BinaryStream.h"
 #include "XMLManager/Parsers/EntityXMLParser/EntityXMLParser.h"
 
 /*
@@ -33,15 +35,20 @@ bool Brokkr::ColliderComponent::Init()
 
     if (!m_isPassable)
     {
-        const auto eventStr = "OnEnter" + std::to_string(m_pOwner->GetId());
-        m_onEnterHandler.first = Event::kPriorityNormal;
-        m_onEnterHandler.second = [this](auto&& event) { BlockMove(std::forward<decltype(event)>(event)); };
-        m_pEventManager->AddHandler(eventStr.c_str(), m_onEnterHandler);
+        m_pEventManager->RemoveHandler(m_onEnterSubscription);
+        m_onEnterSubscription = m_pEventManager->AddHandler(PhysicsManager::kOnEnterEvent.GetTypeHash(), m_pOwner->GetId(), Event::kPriorityNormal, EventDelegate::FromMethod<ColliderComponent, &ColliderComponent::BlockMove>(this));
     }
 
     const auto newPos = m_pOwner->GetComponent<TransformComponent>()->GetStartingPos();
     m_transformStart.MoveTo(newPos);
 
+    // Init again replaces the collider instead of leaving the old one in the world
+    if (m_transform)
+    {
+        m_pPhysicsManager->Remove(m_transform);
+        m_transform = nullptr;
+    }
+
     // During init recenter the transform 
     if (m_overlapType == 1)
     {
@@ -79,8 +86,14 @@ void Brokkr::ColliderComponent::Update()
 
 void Brokkr::ColliderComponent::Destroy()
 {
-    //TODO: FIX this later
-    // m_pPhysicsManager->Remove(m_transform);
+    m_pEventManager->RemoveHandler(m_onEnterSubscription);
+
+    // Never Init (a discarded snapshot load) means there is no collider to remove
+    if (m_transform)
+    {
+        m_pPhysicsManager->Remove(m_transform);
+        m_transform = nullptr;
+    }
 }
 
 //void Brokkr::ColliderComponent::Render()
@@ -183,6 +196,48 @@ void Brokkr::ColliderComponent::CreateComponent(GameEntity* entity, tinyxml2::XM
     transformComponent->AddCollider(hax);
 }
 
+namespace
+{
+    struct ColliderSnapshot
+    {
+        float m_width, m_height;
+        int32_t m_overlapType;
+        uint8_t m_isPassable;
+    };
+}
+
+void Brokkr::ColliderComponent::Serialize(BinaryWriter& writer) const
+{
+    // Position comes from the transform, only the shape and its settings are saved
+    const ColliderSnapshot snapshot
+    {
+        m_transformStart.GetWidth(), m_transformStart.GetHeight(), m_overlapType, static_cast<uint8_t>(m_isPassable)
+    };
+
+    writer.Write(snapshot);
+}
+
+void Brokkr::ColliderComponent::RegisterSnapshotFunction(GameEntityManager* pEntityManager)
+{
+    pEntityManager->RegisterSnapshotCreationFunction(kSnapshotID, RestoreComponent);
+}
+
+void Brokkr::ColliderComponent::RestoreComponent(GameEntity* entity, BinaryReader& reader, CoreSystems* coreSystems)
+{
+    ColliderSnapshot snapshot{};
+    const auto transformComponent = entity->GetComponent<TransformComponent>();
+
+    if (!reader.Read(snapshot) || transformComponent == nullptr)
+    {
+        return;
+    }
+
+    const Rectangle<float> rect(transformComponent->GetTransform().GetPosition(), { snapshot.m_width, snapshot.m_height });
+    const auto pCollider = entity->AddComponent<ColliderComponent>(coreSystems, rect, snapshot.m_overlapType, snapshot.m_isPassable != 0);
+
+    transformComponent->AddCollider(pCollider);
+}
+
 void Brokkr::ColliderComponent::Enable()
 {
     Component::Enable();
@@ -5,6 +5,7 @@
 #include "2DPhysicsManager/PhysicsManager.h"
 #include "Core/Core.h"
 #include "EventManager/EventManager.h"
+#include "Utility/StringID.h"
 
 
 namespace tinyxml2
@@ -18,17 +19,18 @@ namespace Brokkr
     class PhysicsManager;
     class Collider;
     class TransformComponent;
+    class GameEntityManager;
+    class BinaryReader;
 
     class ColliderComponent final : public Component
     {
-        Collider* m_transform;
+        Collider* m_transform = nullptr;
 
         GameEntity* m_pOwner = nullptr;
         PhysicsManager* m_pPhysicsManager = nullptr;
         EventManager* m_pEventManager = nullptr;
 
-        EventManager::EventHandler m_blockedHandler;
-        EventManager::EventHandler m_onEnterHandler;
+        EventSubscription m_onEnterSubscription;
 
         std::string m_eventStr;
         Event m_blockEvent;
@@ -54,11 +56,19 @@ namespace Brokkr
         void AdjustBy(float x, float y);
         void AbsoluteMove(Vector2<float> pos) { m_pPhysicsManager->AbsoluteMove(m_transform, pos); }
 
+        // Snapshot
+        [[nodiscard]] virtual uint32_t GetSnapshotID() const override { return kSnapshotID; }
+        virtual void Serialize(BinaryWriter& writer) const override;
+
         // Static registration function
         static void RegisterCreationFunction(EntityXMLParser* parser);
         static void CreateComponent(GameEntity* entity, tinyxml2::XMLElement* element, CoreSystems* coreSystems);
+        static void RegisterSnapshotFunction(GameEntityManager* pEntityManager);
+        static void RestoreComponent(GameEntity* entity, BinaryReader& reader, CoreSystems* coreSystems);
         virtual void Enable() override;
         virtual void Disable() override;
+
+        inline static constexpr uint32_t kSnapshotID = "ColliderComponent"_sid;
     };
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 
 //These are needed for components to create them self from XML 
 namespace tinyxml2
@@ -8,6 +9,8 @@ namespace tinyxml2
 
 namespace Brokkr
 {
+    class BinaryWriter;
+
     class Component
     {
     protected:
@@ -23,6 +26,12 @@ namespace Brokkr
         virtual void Enable() {}   // : This method could be called when the component is enabled.
         virtual void Disable() {}  // : This method could be called when the component is disabled.
         virtual void LateUpdate() {}
+
+        // Snapshot support: components returning 0 are left out of world snapshots. Serialize writes the
+        // component's data, the static creation function registered with the same id reads it back.
+        [[nodiscard]] virtual uint32_t GetSnapshotID() const { return 0; }
+        virtual void Serialize([[maybe_unused]] BinaryWriter& writer) const {}
+        virtual void OnSnapshotRestored() {} // : Called after every entity in a snapshot has been created and Init.
     };
 }
 
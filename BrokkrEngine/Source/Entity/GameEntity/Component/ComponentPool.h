@@ -0,0 +1,148 @@
+#pragma once
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Component.h"
+#include "Utility/PoolAllocator.h"
+
+/////////////////////////////////////////////////
+//  Component Pools
+//
+//  Every component type gets its own PoolAllocator so components of one type
+//  live together in memory (Transform / Collider iteration stays in cache) and
+//  tearing down a scene does not go through the heap once per component.
+//
+//  GameEntity::AddComponent creates through ComponentPool<Type>::Create and the
+//  ComponentDeleter hands the memory back to the right pool. Once a scene is
+//  cleared ComponentPoolRegistry::ResetAll() re-threads every pool so the next
+//  scene allocates front to back again.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    // Type erased handle so the registry can reset pools without knowing the type
+    class ComponentPoolBase
+    {
+    public:
+        virtual ~ComponentPoolBase() = default;
+
+        virtual bool Reset() = 0;
+        virtual bool Release() = 0;
+        [[nodiscard]] virtual const PoolStats& GetStats() const = 0;
+    };
+
+    class ComponentPoolRegistry
+    {
+    public:
+        static void Register(ComponentPoolBase* pPool) { GetPools().push_back(pPool); }
+
+        // Re-thread every pool that has nothing alive, call after a scene is torn down
+        static void ResetAll()
+        {
+            for (const auto pPool : GetPools())
+            {
+                pPool->Reset();
+            }
+        }
+
+        // Give the memory of every empty pool back to the heap
+        static void ReleaseAll()
+        {
+            for (const auto pPool : GetPools())
+            {
+                pPool->Release();
+            }
+        }
+
+        // Summed stats across all component types
+        static PoolStats GetTotals()
+        {
+            PoolStats totals;
+            for (const auto pPool : GetPools())
+            {
+                const PoolStats& stats = pPool->GetStats();
+                totals.m_liveCount += stats.m_liveCount;
+                totals.m_peakCount += stats.m_peakCount;
+                totals.m_capacity += stats.m_capacity;
+                totals.m_chunkAllocations += stats.m_chunkAllocations;
+                totals.m_allocations += stats.m_allocations;
+            }
+            return totals;
+        }
+
+    private:
+        static std::vector<ComponentPoolBase*>& GetPools()
+        {
+            static std::vector<ComponentPoolBase*> s_pools;
+            return s_pools;
+        }
+    };
+
+    template<typename ComponentType>
+    class ComponentPool final : public ComponentPoolBase
+    {
+        static_assert(std::is_base_of_v<Component, ComponentType>, "Pooled types must derive from Brokkr::Component");
+
+        PoolAllocator<ComponentType> m_allocator;
+
+        ComponentPool() { ComponentPoolRegistry::Register(this); }
+
+    public:
+        static ComponentPool& Get()
+        {
+            static ComponentPool s_pool;
+            return s_pool;
+        }
+
+        template<typename ... Args>
+        static ComponentType* Create(Args&&... args)
+        {
+            ComponentPool& pool = Get();
+            void* pMemory = pool.m_allocator.Allocate();
+
+            try
+            {
+                return new (pMemory) ComponentType(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                pool.m_allocator.Deallocate(pMemory);
+                throw;
+            }
+        }
+
+        static void Destroy(Component* pComponent)
+        {
+            auto* pTarget = static_cast<ComponentType*>(pComponent);
+            pTarget->~ComponentType();
+            Get().m_allocator.Deallocate(pTarget);
+        }
+
+        virtual bool Reset() override { return m_allocator.Reset(); }
+        virtual bool Release() override { return m_allocator.Release(); }
+        [[nodiscard]] virtual const PoolStats& GetStats() const override { return m_allocator.GetStats(); }
+    };
+
+    // unique_ptr deleter that returns the component to the pool it came from
+    struct ComponentDeleter
+    {
+        void (*m_pDestroy)(Component*) = nullptr;
+
+        void operator()(Component* pComponent) const
+        {
+            if (m_pDestroy)
+            {
+                m_pDestroy(pComponent);
+            }
+            else
+            {
+                delete pComponent;
+            }
+        }
+    };
+
+    using ComponentPtr = std::unique_ptr<Component, ComponentDeleter>;
+}
@@ -7,6 +7,8 @@
 #include "TransformComponent.h"
 #include "2DRendering/SDLWindowSystem.h"
 #include "AssetManager/2DTextureManager/2DTexture/Texture2D.h"
+#include "Entity/GameEntityManager/GameEntityManager.h"
+#include "Utility/BinaryStream.h"
 #include "XMLManager/Parsers/EntityXMLParser/EntityXMLParser.h"
 
 #define DEBUG_LOGGING 0
@@ -54,12 +56,13 @@ void Brokkr::SpriteComponent::Destroy()
 void Brokkr::SpriteComponent::Render()
 {
     const auto transform = m_pTransformComponent->GetTransform();
+    const auto position = m_pTransformComponent->GetInterpolatedPosition(m_pCoreSystems->GetInterpolationAlpha());
 
     m_pSDLRenderer->RenderCopy
     (
         m_texture->GetSDLTexture(),
-        static_cast<int>(transform.GetX()),
-        static_cast<int>(transform.GetY()),
+        static_cast<int>(position.m_x),
+        static_cast<int>(position.m_y),
         static_cast<int>(transform.GetWidth()),
         static_cast<int>(transform.GetHeight())
     );
@@ -103,3 +106,26 @@ void Brokkr::SpriteComponent::CreateComponent(GameEntity* entity, tinyxml2::XMLE
     entity->AddComponent<SpriteComponent>(coreSystems, texturePath, center);
 }
 
+void Brokkr::SpriteComponent::Serialize(BinaryWriter& writer) const
+{
+    writer.WriteString(m_textureName);
+    writer.Write(static_cast<uint8_t>(m_centerTransform));
+}
+
+void Brokkr::SpriteComponent::RegisterSnapshotFunction(GameEntityManager* pEntityManager)
+{
+    pEntityManager->RegisterSnapshotCreationFunction(kSnapshotID, RestoreComponent);
+}
+
+void Brokkr::SpriteComponent::RestoreComponent(GameEntity* entity, BinaryReader& reader, CoreSystems* coreSystems)
+{
+    std::string textureName;
+    uint8_t center = 0;
+
+    if (!reader.ReadString(textureName) || !reader.Read(center))
+    {
+        return;
+    }
+
+    entity->AddComponent<SpriteComponent>(coreSystems, textureName, center != 0);
+}
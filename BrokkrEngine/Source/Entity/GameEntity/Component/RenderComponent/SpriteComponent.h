@@ -3,6 +3,7 @@
 #include <string>
 #include "GameEntity.h"
 #include "Core/Core.h"
+#include "Utility/StringID.h"
 
 namespace tinyxml2
 {
@@ -18,6 +19,8 @@ namespace Brokkr
     class Texture2D;
     class GameEntity;
     class TransformComponent;
+    class GameEntityManager;
+    class BinaryReader;
 
     class SpriteComponent final : public Component
     {
@@ -43,6 +46,7 @@ namespace Brokkr
         );
 
         [[nodiscard]] const char* GetTextureName() const { return m_textureName.c_str(); }
+        [[nodiscard]] GameEntity* GetOwner() const { return m_pOwner; }
 
         virtual bool Init() override;
         virtual void Update() override;
@@ -57,8 +61,16 @@ namespace Brokkr
         void CenterToTransform() { m_centerTransform = true; }
         void CenterToTransformOff() { m_centerTransform = false; }
 
+        // Snapshot
+        [[nodiscard]] virtual uint32_t GetSnapshotID() const override { return kSnapshotID; }
+        virtual void Serialize(BinaryWriter& writer) const override;
+
         // Static registration function
         static void RegisterCreationFunction(EntityXMLParser* parser);
         static void CreateComponent(GameEntity* entity, tinyxml2::XMLElement* element, CoreSystems* coreSystems);
+        static void RegisterSnapshotFunction(GameEntityManager* pEntityManager);
+        static void RestoreComponent(GameEntity* entity, BinaryReader& reader, CoreSystems* coreSystems);
+
+        inline static constexpr uint32_t kSnapshotID = "SpriteComponent"_sid;
     };
 }
@@ -3,9 +3,12 @@
 #include <tinyxml2.h>
 
 #include "ColliderComponent.h"
+#include "TransformHierarchy.h"
 #include "GameEntity.h"
 #include "Core/EngineDefinitions.h"
+#include "Entity/GameEntityManager/GameEntityManager.h"
 #include "EventManager/EventManager.h"
+#include "Utility/BinaryStream.h"
 #include "XMLManager/Parsers/EntityXMLParser/EntityXMLParser.h"
 
 #define DEBUG_RENDER 0
@@ -22,37 +25,99 @@ Brokkr::TransformComponent::TransformComponent(GameEntity* pOwner, CoreSystems*
 bool Brokkr::TransformComponent::Init()
 {
     m_transform.MoveTo(m_startPos);
+    MarkMoved();
+    SnapInterpolation();
 
     return true; //default
 }
 
 void Brokkr::TransformComponent::Update()
 {
-    // not needed for this component for now
+    // Runs at the start of each simulation step, before anything has moved this step
+    SnapInterpolation();
+}
+
+Brokkr::Vector2<float> Brokkr::TransformComponent::GetInterpolatedPosition(float alpha) const
+{
+    const Vector2<float> current(m_transform.GetX(), m_transform.GetY());
+    return m_previousPosition + (current - m_previousPosition) * alpha;
 }
 
 void Brokkr::TransformComponent::Destroy()
 {
+    m_pEventManager->RemoveHandler(m_updateSubscription);
 
+    if (m_pHierarchy)
+    {
+        m_pHierarchy->Remove(this);
+    }
 }
 
 void Brokkr::TransformComponent::AddCollider(ColliderComponent* pColliderComponent)
 {
     m_collider = pColliderComponent;
 
-    const std::string eventStr = EngineDefinitions::UPDATE_TRANSFORM_POSITION_EVENT + std::to_string(m_pOwner->GetId());
+    // update before render data is pushed
+    m_pEventManager->RemoveHandler(m_updateSubscription);
+    m_updateSubscription = m_pEventManager->AddHandler(kUpdatePositionEvent.GetTypeHash(), m_pOwner->GetId(), Event::kPriorityNormal, EventDelegate::FromMethod<TransformComponent, &TransformComponent::UpdatePosition>(this));
+
+}
+
+bool Brokkr::TransformComponent::SetParent(TransformComponent* pParent)
+{
+    TransformHierarchy& hierarchy = m_systemRef->GetCoreSystem<GameEntityManager>()->GetTransformHierarchy();
+    return hierarchy.SetParent(this, pParent);
+}
+
+Brokkr::TransformComponent* Brokkr::TransformComponent::GetParent() const
+{
+    return m_pHierarchy ? m_pHierarchy->GetParent(this) : nullptr;
+}
+
+void Brokkr::TransformComponent::SetLocalPosition(const Vector2<float>& localPos)
+{
+    if (GetParent() == nullptr)
+    {
+        MoveTo(localPos);
+        return;
+    }
 
-    m_updateHandler.first = Event::kPriorityNormal; // update before render data is pushed
-    m_updateHandler.second = [this](auto&& event) { UpdatePosition(std::forward<decltype(event)>(event)); };
-    m_pEventManager->AddHandler(eventStr.c_str(), m_updateHandler);
+    m_pHierarchy->SetLocalPosition(this, localPos);
+}
 
+Brokkr::Vector2<float> Brokkr::TransformComponent::GetLocalPosition() const
+{
+    return m_pHierarchy ? m_pHierarchy->GetLocalPosition(this) : GetTransform().GetPosition();
+}
+
+void Brokkr::TransformComponent::SnapToWorld(const Vector2<float>& position)
+{
+    m_transform.MoveTo(position);
+
+    if (m_collider)
+    {
+        m_collider->AbsoluteMove(position);
+    }
+}
+
+void Brokkr::TransformComponent::MarkMoved()
+{
+    if (m_pHierarchy)
+    {
+        m_pHierarchy->MarkMoved(this);
+    }
 }
 
 void Brokkr::TransformComponent::UpdatePosition([[maybe_unused]] const Event& event)
 {
     if (m_collider)
     {
-        m_transform.MoveTo(m_collider->GetTransform().GetPosition());
+        const Vector2<float> position = m_collider->GetTransform().GetPosition();
+        if (position != m_transform.GetPosition())
+        {
+            m_transform.MoveTo(position);
+            MarkMoved();
+        }
     }
 }
 
@@ -84,4 +149,46 @@ void Brokkr::TransformComponent::CreateComponent(GameEntity* entity, tinyxml2::X
     component->SetStartingPos({ x,y });
 }
 
+namespace
+{
+    struct TransformSnapshot
+    {
+        float m_x, m_y, m_width, m_height;
+        float m_startX, m_startY;
+    };
+}
+
+void Brokkr::TransformComponent::Serialize(BinaryWriter& writer) const
+{
+    const TransformSnapshot snapshot
+    {
+        m_transform.GetX(), m_transform.GetY(), m_transform.GetWidth(), m_transform.GetHeight(),
+        m_startPos.m_x, m_startPos.m_y
+    };
+
+    writer.Write(snapshot);
+}
 
+void Brokkr::TransformComponent::RegisterSnapshotFunction(GameEntityManager* pEntityManager)
+{
+    pEntityManager->RegisterSnapshotCreationFunction(kSnapshotID, RestoreComponent);
+}
+
+void Brokkr::TransformComponent::RestoreComponent(GameEntity* entity, BinaryReader& reader, CoreSystems* coreSystems)
+{
+    TransformSnapshot snapshot{};
+    if (!reader.Read(snapshot))
+    {
+        return;
+    }
+
+    const auto component = entity->AddComponent<TransformComponent>
+        (
+            coreSystems
+            , Brokkr::Rectangle<float>({ snapshot.m_x, snapshot.m_y }, { snapshot.m_width, snapshot.m_height })
+            );
+
+    // Init places the transform and its collider at the start position, so start from where it was saved
+    component->SetStartingPos({ snapshot.m_x, snapshot.m_y });
+    component->m_snapshotStartPos = { snapshot.m_startX, snapshot.m_startY };
+}
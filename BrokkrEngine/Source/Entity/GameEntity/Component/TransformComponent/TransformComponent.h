@@ -3,8 +3,10 @@
 
 #include <EventManager/EventManager.h>
 
+#include "Core/EngineDefinitions.h"
 #include "Entity/GameEntity/GameEntity.h"
 #include "Rectangle.h"
+#include "Utility/StringID.h"
 
 /*#define BROKKR_IGNORE_COORDINATE_Y 1
 #define BROKKR_IGNORE_COORDINATE_X 2
@@ -17,6 +19,9 @@ namespace Brokkr
     class EntityXMLParser;
     class ColliderComponent;
     class GameEntity;
+    class GameEntityManager;
+    class BinaryReader;
+    class TransformHierarchy;
 
     class TransformComponent final : public Component
     {
@@ -27,10 +32,22 @@ namespace Brokkr
         GameEntity* m_pOwner = nullptr;
         EventManager* m_pEventManager = nullptr;
 
-        EventManager::EventHandler m_updateHandler;
+        EventSubscription m_updateSubscription;
 
         Vector2<float> m_startPos;
 
+        // Position at the start of the current simulation step, rendering blends from it to m_transform
+        Vector2<float> m_previousPosition;
+
+        // Set by the TransformHierarchy while this transform has a parent or children
+        TransformHierarchy* m_pHierarchy = nullptr;
+        int m_hierarchyIndex = -1;
+
+        friend class TransformHierarchy;
+
+        // Start position read from a snapshot, Init runs from the saved position so this is applied after
+        Vector2<float> m_snapshotStartPos;
+
     public:
         TransformComponent(GameEntity* pOwner, CoreSystems* pCoreSystems, Rectangle<float> transform);
 
@@ -45,26 +62,57 @@ namespace Brokkr
             return m_transform;
         }
         [[nodiscard]] Vector2<float> GetStartingPos() const { return m_startPos; }
+        [[nodiscard]] GameEntity* GetOwner() const { return m_pOwner; }
+
+        // Where to draw between the last two simulation steps, alpha from CoreSystems::GetInterpolationAlpha
+        [[nodiscard]] Vector2<float> GetInterpolatedPosition(float alpha) const;
+
+        // Skip the blend for this step, for teleports
+        void SnapInterpolation() { m_previousPosition = { m_transform.GetX(), m_transform.GetY() }; }
 
         void MoveTo(Vector2<float> newPos)
         {
-  
             m_transform.MoveTo(newPos);
-            const std::string eventStr = "UpdatePosition" + std::to_string(m_pOwner->GetId());
-            const Event outEvent = Event::EventType(eventStr.c_str(), Event::kPriorityNormal);
-            m_pEventManager->PushEvent(outEvent);
+            MarkMoved();
+            m_pEventManager->PushEvent(Event(kUpdatePositionEvent, m_pOwner->GetId()));
         }
 
         void AddCollider(ColliderComponent* pColliderComponent);
 
+        // Hierarchy: children follow their parent, resolved once per frame after LateUpdate
+        ///////////////////////////////////////////
+        bool SetParent(TransformComponent* pParent);
+        [[nodiscard]] TransformComponent* GetParent() const;
+
+        // Offset from the parent, for a transform without a parent this is its world position
+        void SetLocalPosition(const Vector2<float>& localPos);
+        [[nodiscard]] Vector2<float> GetLocalPosition() const;
+
         // When ever Physics updates the final displacement for the frame update this after
         void UpdatePosition([[maybe_unused]] const Event& event);
 
         void Resize(float width, float height);
 
+        // Snapshot
+        [[nodiscard]] virtual uint32_t GetSnapshotID() const override { return kSnapshotID; }
+        virtual void Serialize(BinaryWriter& writer) const override;
+        virtual void OnSnapshotRestored() override { m_startPos = m_snapshotStartPos; }
+
         // Static registration function
         static void RegisterCreationFunction(EntityXMLParser* parser);
         static void CreateComponent(GameEntity* entity, tinyxml2::XMLElement* element, CoreSystems* coreSystems);
+        static void RegisterSnapshotFunction(GameEntityManager* pEntityManager);
+        static void RestoreComponent(GameEntity* entity, BinaryReader& reader, CoreSystems* coreSystems);
+
+        inline static constexpr uint32_t kSnapshotID = "TransformComponent"_sid;
+        inline static constexpr Event::EventType kUpdatePositionEvent{ EngineDefinitions::UPDATE_TRANSFORM_POSITION_EVENT, Event::kPriorityNormal };
+
+    private:
+        // Used by the hierarchy, moves the transform and its collider without sending an event
+        void SnapToWorld(const Vector2<float>& position);
+
+        // Queues this transform in the hierarchy so its children follow it
+        void MarkMoved();
 
     };
 }
@@ -0,0 +1,291 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+
+#include "TransformComponent.h"
+
+bool Brokkr::TransformHierarchy::SetParent(TransformComponent* pChild, TransformComponent* pParent)
+{
+    if (pChild == nullptr || pChild == pParent || GetParent(pChild) == pParent)
+    {
+        return pChild != pParent;
+    }
+
+    // Refuse links that would make the child its own ancestor
+    for (const TransformComponent* pAncestor = pParent; pAncestor != nullptr; pAncestor = GetParent(pAncestor))
+    {
+        if (pAncestor == pChild)
+        {
+            return false;
+        }
+    }
+
+    FindOrAddNode(pChild);
+
+    if (TransformComponent* pOldParent = m_nodes[pChild->m_hierarchyIndex].m_pParent)
+    {
+        RemoveChild(pOldParent, pChild);
+        m_nodes[pChild->m_hierarchyIndex].m_pParent = nullptr;
+        ReleaseIfUnlinked(pOldParent);
+    }
+
+    if (pParent == nullptr)
+    {
+        ReleaseIfUnlinked(pChild);
+        return true;
+    }
+
+    // Adding the parent can move the child's node, indices are only read after it
+    const int parentIndex = FindOrAddNode(pParent);
+    m_nodes[parentIndex].m_children.push_back(pChild);
+
+    // Keep the child where it is, its offset is taken from the current world positions
+    Node& childNode = m_nodes[pChild->m_hierarchyIndex];
+    childNode.m_pParent = pParent;
+    childNode.m_local = pChild->GetTransform().GetPosition() - pParent->GetTransform().GetPosition();
+    MarkDirty(pChild, true);
+
+    return true;
+}
+
+Brokkr::TransformComponent* Brokkr::TransformHierarchy::GetParent(const TransformComponent* pChild) const
+{
+    if (pChild == nullptr || pChild->m_hierarchyIndex < 0)
+    {
+        return nullptr;
+    }
+
+    return m_nodes[pChild->m_hierarchyIndex].m_pParent;
+}
+
+void Brokkr::TransformHierarchy::SetLocalPosition(TransformComponent* pChild, const Vector2<float>& localPos)
+{
+    if (pChild->m_hierarchyIndex < 0)
+    {
+        return;
+    }
+
+    m_nodes[pChild->m_hierarchyIndex].m_local = localPos;
+    MarkDirty(pChild, true);
+}
+
+Brokkr::Vector2<float> Brokkr::TransformHierarchy::GetLocalPosition(const TransformComponent* pChild) const
+{
+    if (pChild->m_hierarchyIndex < 0 || m_nodes[pChild->m_hierarchyIndex].m_pParent == nullptr)
+    {
+        return pChild->GetTransform().GetPosition();
+    }
+
+    return m_nodes[pChild->m_hierarchyIndex].m_local;
+}
+
+void Brokkr::TransformHierarchy::MarkMoved(TransformComponent* pTransform)
+{
+    if (pTransform->m_hierarchyIndex >= 0)
+    {
+        MarkDirty(pTransform, false);
+    }
+}
+
+void Brokkr::TransformHierarchy::Remove(TransformComponent* pTransform)
+{
+    if (pTransform->m_hierarchyIndex < 0)
+    {
+        return;
+    }
+
+    // Orphan the children first, they stay at their current world position as roots
+    Node& node = m_nodes[pTransform->m_hierarchyIndex];
+    const std::vector<TransformComponent*> pOrphans = std::move(node.m_children);
+    for (TransformComponent* pOrphan : pOrphans)
+    {
+        Node& orphan = m_nodes[pOrphan->m_hierarchyIndex];
+        orphan.m_pParent = nullptr;
+        orphan.m_world = pOrphan->GetTransform().GetPosition();
+    }
+
+    TransformComponent* pParent = node.m_pParent;
+    if (pParent != nullptr)
+    {
+        RemoveChild(pParent, pTransform);
+    }
+
+    EraseNode(pTransform->m_hierarchyIndex);
+
+    for (TransformComponent* pOrphan : pOrphans)
+    {
+        ReleaseIfUnlinked(pOrphan);
+    }
+
+    if (pParent != nullptr)
+    {
+        ReleaseIfUnlinked(pParent);
+    }
+}
+
+void Brokkr::TransformHierarchy::Resolve()
+{
+    if (m_dirty.empty())
+    {
+        return;
+    }
+
+    // A child moved on its own keeps where it was put, its offset is taken from where the parent was last
+    // resolved since the parent may have moved too
+    for (TransformComponent* pTransform : m_dirty)
+    {
+        Node& node = m_nodes[pTransform->m_hierarchyIndex];
+        if (node.m_pParent != nullptr && !node.m_isLocalSet)
+        {
+            node.m_local = pTransform->GetTransform().GetPosition() - m_nodes[node.m_pParent->m_hierarchyIndex].m_world;
+        }
+    }
+
+    // A queued ancestor's walk covers the whole subtree, only start from the top most ones
+    for (TransformComponent* pTransform : m_dirty)
+    {
+        if (!HasDirtyAncestor(pTransform))
+        {
+            ResolveSubtree(pTransform);
+        }
+    }
+
+    for (TransformComponent* pTransform : m_dirty)
+    {
+        Node& node = m_nodes[pTransform->m_hierarchyIndex];
+        node.m_dirtySlot = -1;
+        node.m_isLocalSet = false;
+    }
+
+    m_dirty.clear();
+}
+
+void Brokkr::TransformHierarchy::Clear()
+{
+    for (const Node& node : m_nodes)
+    {
+        node.m_pTransform->m_hierarchyIndex = -1;
+        node.m_pTransform->m_pHierarchy = nullptr;
+    }
+
+    m_nodes.clear();
+    m_dirty.clear();
+}
+
+int Brokkr::TransformHierarchy::FindOrAddNode(TransformComponent* pTransform)
+{
+    if (pTransform->m_hierarchyIndex >= 0)
+    {
+        return pTransform->m_hierarchyIndex;
+    }
+
+    Node& node = m_nodes.emplace_back();
+    node.m_pTransform = pTransform;
+    node.m_world = pTransform->GetTransform().GetPosition();
+
+    pTransform->m_hierarchyIndex = static_cast<int>(m_nodes.size() - 1);
+    pTransform->m_pHierarchy = this;
+    return pTransform->m_hierarchyIndex;
+}
+
+void Brokkr::TransformHierarchy::MarkDirty(TransformComponent* pTransform, bool isLocalSet)
+{
+    Node& node = m_nodes[pTransform->m_hierarchyIndex];
+    node.m_isLocalSet |= isLocalSet;
+
+    if (node.m_dirtySlot < 0)
+    {
+        node.m_dirtySlot = static_cast<int>(m_dirty.size());
+        m_dirty.push_back(pTransform);
+    }
+}
+
+void Brokkr::TransformHierarchy::RemoveChild(TransformComponent* pParent, const TransformComponent* pChild)
+{
+    // Siblings are few, their order does not matter
+    auto& children = m_nodes[pParent->m_hierarchyIndex].m_children;
+    const auto it = std::find(children.begin(), children.end(), pChild);
+    if (it != children.end())
+    {
+        *it = children.back();
+        children.pop_back();
+    }
+}
+
+void Brokkr::TransformHierarchy::ReleaseIfUnlinked(TransformComponent* pTransform)
+{
+    const int index = pTransform->m_hierarchyIndex;
+    if (index < 0)
+    {
+        return;
+    }
+
+    // Transforms with no parent and no children do not need a node
+    if (m_nodes[index].m_pParent == nullptr && m_nodes[index].m_children.empty())
+    {
+        EraseNode(index);
+    }
+}
+
+void Brokkr::TransformHierarchy::EraseNode(int index)
+{
+    Node& node = m_nodes[index];
+
+    // Out of the queue too, the last queued transform takes its slot
+    if (node.m_dirtySlot >= 0)
+    {
+        TransformComponent* pLastDirty = m_dirty.back();
+        m_dirty[node.m_dirtySlot] = pLastDirty;
+        m_nodes[pLastDirty->m_hierarchyIndex].m_dirtySlot = node.m_dirtySlot;
+        m_dirty.pop_back();
+    }
+
+    node.m_pTransform->m_hierarchyIndex = -1;
+    node.m_pTransform->m_pHierarchy = nullptr;
+
+    // Swap and pop, the last node takes the index
+    if (static_cast<size_t>(index) != m_nodes.size() - 1)
+    {
+        node = std::move(m_nodes.back());
+        node.m_pTransform->m_hierarchyIndex = index;
+    }
+    m_nodes.pop_back();
+}
+
+bool Brokkr::TransformHierarchy::HasDirtyAncestor(const TransformComponent* pTransform) const
+{
+    for (const TransformComponent* pParent = GetParent(pTransform); pParent != nullptr; pParent = GetParent(pParent))
+    {
+        if (m_nodes[pParent->m_hierarchyIndex].m_dirtySlot >= 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Brokkr::TransformHierarchy::ResolveSubtree(TransformComponent* pTransform)
+{
+    // Parents are written before their children are taken off the stack
+    m_resolveStack.clear();
+    m_resolveStack.push_back(pTransform);
+
+    while (!m_resolveStack.empty())
+    {
+        TransformComponent* pCurrent = m_resolveStack.back();
+        m_resolveStack.pop_back();
+
+        Node& node = m_nodes[pCurrent->m_hierarchyIndex];
+        const Vector2<float> position = pCurrent->GetTransform().GetPosition();
+
+        // Roots are moved by gameplay and physics, the hierarchy only follows them
+        node.m_world = node.m_pParent ? m_nodes[node.m_pParent->m_hierarchyIndex].m_world + node.m_local : position;
+        if (position != node.m_world)
+        {
+            pCurrent->SnapToWorld(node.m_world);
+        }
+
+        m_resolveStack.insert(m_resolveStack.end(), node.m_children.begin(), node.m_children.end());
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Vector2.h"
+
+namespace Brokkr
+{
+    class TransformComponent;
+
+    // Parent / child links between TransformComponents.
+    // Only transforms that have a parent or children live here, in one unordered array each transform knows
+    // its index into, so linking and unlinking are O(1) swap and pops. Transforms that move or get a new offset
+    // are queued, Resolve only walks down from those, a frame where nothing in a hierarchy moved costs nothing.
+    class TransformHierarchy
+    {
+        struct Node
+        {
+            TransformComponent* m_pTransform = nullptr;
+            TransformComponent* m_pParent = nullptr;
+            std::vector<TransformComponent*> m_children;
+
+            Vector2<float> m_local;  // offset from the parent, unused for roots
+            Vector2<float> m_world;  // world position written by the last Resolve
+
+            int m_dirtySlot = -1;       // index into m_dirty, -1 while clean
+            bool m_isLocalSet = false;  // given a new offset, otherwise it was moved and the offset follows it
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<TransformComponent*> m_dirty;
+        std::vector<TransformComponent*> m_resolveStack;
+
+    public:
+        // Links pChild under pParent keeping its current world position, nullptr parent detaches.
+        // Returns false if the link would make a cycle.
+        bool SetParent(TransformComponent* pChild, TransformComponent* pParent);
+
+        [[nodiscard]] TransformComponent* GetParent(const TransformComponent* pChild) const;
+
+        void SetLocalPosition(TransformComponent* pChild, const Vector2<float>& localPos);
+        [[nodiscard]] Vector2<float> GetLocalPosition(const TransformComponent* pChild) const;
+
+        // Called by the transform when it moves, its children follow it at the next Resolve
+        void MarkMoved(TransformComponent* pTransform);
+
+        // Detaches the transform and its children, the children become roots where they stand
+        void Remove(TransformComponent* pTransform);
+
+        // Walks down from every transform queued since the last pass: children follow moved parents, children
+        // that were moved themselves keep their new offset
+        void Resolve();
+
+        void Clear();
+
+        [[nodiscard]] size_t GetNodeCount() const { return m_nodes.size(); }
+        [[nodiscard]] size_t GetDirtyCount() const { return m_dirty.size(); }
+
+    private:
+        int FindOrAddNode(TransformComponent* pTransform);
+        void MarkDirty(TransformComponent* pTransform, bool isLocalSet);
+        void RemoveChild(TransformComponent* pParent, const TransformComponent* pChild);
+        void ReleaseIfUnlinked(TransformComponent* pTransform);
+        void EraseNode(int index);
+        [[nodiscard]] bool HasDirtyAncestor(const TransformComponent* pTransform) const;
+        void ResolveSubtree(TransformComponent* pTransform);
+    };
+}
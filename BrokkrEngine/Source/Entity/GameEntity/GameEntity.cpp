@@ -1,5 +1,7 @@
 #include "GameEntity.h"
 
+#include "Utility/BinaryStream.h"
+
 void Brokkr::GameEntity::Init() const
 {
     for (size_t i = 0; i < m_pComponents.size(); ++i)
@@ -57,18 +59,73 @@ void Brokkr::GameEntity::Enable()
     isEnabled = true;
 }
 
-void Brokkr::GameEntity::Serialize([[maybe_unused]] const std::string& filePath) const
+void Brokkr::GameEntity::Serialize(BinaryWriter& writer) const
+{
+    writer.Write(static_cast<uint8_t>(isEnabled));
+
+    uint32_t componentCount = 0;
+    for (const auto& pComponent : m_pComponents)
+    {
+        if (pComponent->GetSnapshotID() != 0)
+        {
+            ++componentCount;
+        }
+    }
+
+    writer.Write(componentCount);
+
+    for (const auto& pComponent : m_pComponents)
+    {
+        const uint32_t snapshotId = pComponent->GetSnapshotID();
+        if (snapshotId == 0)
+        {
+            continue;
+        }
+
+        // id then a size prefixed block so unknown components can be skipped on load
+        writer.Write(snapshotId);
+        const size_t mark = writer.BeginBlock();
+        pComponent->Serialize(writer);
+        writer.EndBlock(mark);
+    }
+}
+
+bool Brokkr::GameEntity::Deserialize(BinaryReader& reader, const SnapshotCreationTable& creationTable, CoreSystems* pCoreSystems)
 {
-    /*for (size_t i = 0; i < m_pComponents.size(); ++i)
+    uint8_t enabled = 1;
+    uint32_t componentCount = 0;
+    reader.Read(enabled);
+    reader.Read(componentCount);
+
+    for (uint32_t i = 0; i < componentCount && !reader.HasFailed(); ++i)
     {
-        m_pComponents[i]->Serialize(filePath);
-    }*/
+        uint32_t snapshotId = 0;
+        uint32_t blockSize = 0;
+        reader.Read(snapshotId);
+        reader.Read(blockSize);
+
+        const size_t blockEnd = reader.GetOffset() + blockSize;
+
+        if (const auto it = creationTable.find(snapshotId); it != creationTable.end())
+        {
+            it->second(this, reader, pCoreSystems);
+        }
+
+        // Land on the end of the block whether it was read, partly read or unknown
+        if (reader.GetOffset() > blockEnd || !reader.Skip(blockEnd - reader.GetOffset()))
+        {
+            return false;
+        }
+    }
+
+    isEnabled = enabled != 0;
+    return !reader.HasFailed();
 }
 
-void Brokkr::GameEntity::Deserialize([[maybe_unused]] const std::string& filePath) const
+void Brokkr::GameEntity::OnSnapshotRestored() const
 {
-    /*for (size_t i = 0; i < m_pComponents.size(); ++i)
+    for (size_t i = 0; i < m_pComponents.size(); ++i)
     {
-        m_pComponents[i]->Deserialize(filePath);
-    }*/
+        m_pComponents[i]->OnSnapshotRestored();
+    }
 }
@@ -1,35 +1,89 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "Component/Component.h"
+#include "Component/ComponentPool.h"
 #include "Utility/IDGenerator.h"
 
 
 namespace Brokkr
 {
     class GameEntityManager;
+    class CoreSystems;
+    class BinaryWriter;
+    class BinaryReader;
+    class GameEntity;
+    class TransformComponent;
+    class ColliderComponent;
+
+    // Rebuilds one component from a snapshot, registered per snapshot id with the GameEntityManager
+    using SnapshotCreationFunction = std::function<void(GameEntity*, BinaryReader&, CoreSystems*)>;
+    using SnapshotCreationTable = std::unordered_map<uint32_t, SnapshotCreationFunction>;
 
     class GameEntity
     {
+    public:
+        // Interned name / tag handle, handed out by GameEntityManager::InternName
+        using NameID = uint32_t;
+        inline static constexpr NameID kNoName = UINT32_MAX;
+
+    private:
         int m_id;
         std::string m_name;
+        NameID m_nameId = kNoName;
+        std::vector<NameID> m_tags;
+
+        // Where the entity sits in the manager's name bucket and in each tag bucket, lines up with m_tags
+        uint32_t m_nameSlot = 0;
+        std::vector<uint32_t> m_tagSlots;
         bool isEnabled = true;
-        std::vector<std::unique_ptr<Component>> m_pComponents;
+        std::vector<ComponentPtr> m_pComponents;
+
+        // Bumped on every add and remove so cached component lookups know when to look again
+        uint32_t m_componentVersion = 0;
+
+        // Activity region state, owned by the GameEntityManager
+        bool m_isSuspended = false;
+        uint32_t m_activityStamp = 0;
+
+        // Components the activity pass reads every frame, looked up again only when m_componentVersion moves on
+        TransformComponent* m_pActivityTransform = nullptr;
+        ColliderComponent* m_pActivityCollider = nullptr;
+        uint32_t m_activityComponentVersion = UINT32_MAX;
     protected:
         friend GameEntityManager;
 
-        void SetName(const std::string& name) { m_name = name; }
+        // Names and tags go through the GameEntityManager so its lookup index stays in sync
+        void SetName(const std::string& name, NameID nameId) { m_name = name; m_nameId = nameId; }
+        void AddTag(NameID tag, uint32_t slot) { m_tags.push_back(tag); m_tagSlots.push_back(slot); }
+        void RemoveTagAt(size_t index)
+        {
+            m_tags.erase(m_tags.begin() + static_cast<std::ptrdiff_t>(index));
+            m_tagSlots.erase(m_tagSlots.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+        [[nodiscard]] size_t FindTag(NameID tag) const { return static_cast<size_t>(std::find(m_tags.begin(), m_tags.end(), tag) - m_tags.begin()); }
     public:
 
         // Create Object Creation / Deletion 
         ///////////////////////////////////////////
         GameEntity() : m_id(IDGenerator::GenerateUniqueID()){}
 
+        // Used when restoring a snapshot so the entity keeps its saved id
+        explicit GameEntity(int id) : m_id(id) { IDGenerator::ReserveID(id); }
+
         GameEntity(const GameEntity& other) = delete;
         GameEntity& operator=(const GameEntity& other) = delete;
-        const std::string& GetName() { return m_name; }
+        [[nodiscard]] const std::string& GetName() const { return m_name; }
+        [[nodiscard]] NameID GetNameID() const { return m_nameId; }
+
+        [[nodiscard]] const std::vector<NameID>& GetTags() const { return m_tags; }
+        [[nodiscard]] bool HasTag(NameID tag) const { return std::find(m_tags.begin(), m_tags.end(), tag) != m_tags.end(); }
 
         GameEntity(GameEntity&& other) noexcept = default;
         GameEntity& operator=(GameEntity&& other) noexcept = default;
@@ -53,13 +107,21 @@ namespace Brokkr
         ///////////////////////////////////////////
         void Enable();
 
-        // Object Serialize TODO: Flesh out this system more
+        [[nodiscard]] bool IsEnabled() const { return isEnabled; }
+
+        // Suspended entities are outside the activity region, they skip update and render
+        [[nodiscard]] bool IsSuspended() const { return m_isSuspended; }
+
+        // Object Serialize: enabled state and every component that supports snapshots
         ///////////////////////////////////////////
-        void Serialize(const std::string& filePath) const;
+        void Serialize(BinaryWriter& writer) const;
 
-        // Object Deserialize TODO: Flesh out this system more
+        // Object Deserialize: rebuilds components through the creation table, unknown ones are skipped
         ///////////////////////////////////////////
-        void Deserialize(const std::string& filePath) const;
+        bool Deserialize(BinaryReader& reader, const SnapshotCreationTable& creationTable, CoreSystems* pCoreSystems);
+
+        // Let components fix themselves up once the whole snapshot is loaded
+        void OnSnapshotRestored() const;
 
         // Object Get a Component 
         ///////////////////////////////////////////
@@ -84,6 +146,7 @@ namespace Brokkr
 
                     std::swap(*it, m_pComponents.back());
                     m_pComponents.pop_back();
+                    ++m_componentVersion;
                     return;
                 }
                 ++it;
@@ -285,14 +348,12 @@ namespace Brokkr
     template <typename ComponentType, typename ... Args>
     ComponentType* GameEntity::AddComponent(Args&&... args)
     {
-        // Create a instance of the component type passing in the current GameEntity pointer
-        std::unique_ptr<ComponentType> newComponent = std::make_unique<ComponentType>(this, std::forward<Args>(args)...);
+        // Create a instance of the component type out of its pool passing in the current GameEntity pointer
+        ComponentType* result = ComponentPool<ComponentType>::Create(this, std::forward<Args>(args)...);
 
-        // Get a raw pointer to the component
-        ComponentType* result = newComponent.get();
-
-        // Add the component to the vector
-        m_pComponents.emplace_back(std::move(newComponent));
+        // Add the component to the vector, the deleter hands it back to the same pool
+        m_pComponents.emplace_back(result, ComponentDeleter{ &ComponentPool<ComponentType>::Destroy });
+        ++m_componentVersion;
 
         // Return a pointer
         return result;
@@ -0,0 +1,185 @@
+#include "EntityCommandBuffer.h"
+
+#include "GameEntityManager.h"
+#include "Entity/GameEntity/GameEntity.h"
+
+Brokkr::EntityCommandBuffer::~EntityCommandBuffer()
+{
+    Clear();
+}
+
+void Brokkr::EntityCommandBuffer::Spawn(const std::string& prefabName, const std::string& fileName, EntityCallback onSpawned)
+{
+    Command command(CommandType::kSpawn);
+    command.m_prefabName = prefabName;
+    command.m_fileName = fileName;
+    command.m_callback = std::move(onSpawned);
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Spawn(const std::string& prefabName, const std::string& fileName, const Vector2<float>& position, EntityCallback onSpawned)
+{
+    Command command(CommandType::kSpawnAt);
+    command.m_prefabName = prefabName;
+    command.m_fileName = fileName;
+    command.m_position = position;
+    command.m_callback = std::move(onSpawned);
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Add(GameEntity* pEntity)
+{
+    Command command(CommandType::kAdd);
+    command.m_entityId = pEntity->GetId();
+    command.m_pEntity = pEntity;
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Destroy(int entityId)
+{
+    Command command(CommandType::kDestroy);
+    command.m_entityId = entityId;
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Enable(int entityId)
+{
+    Command command(CommandType::kEnable);
+    command.m_entityId = entityId;
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Disable(int entityId)
+{
+    Command command(CommandType::kDisable);
+    command.m_entityId = entityId;
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Edit(int entityId, EntityCallback edit)
+{
+    Command command(CommandType::kEdit);
+    command.m_entityId = entityId;
+    command.m_callback = std::move(edit);
+    Record(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::RecordComponentChange(int entityId, ComponentCallback change)
+{
+    Command command(CommandType::kComponent);
+    command.m_entityId = entityId;
+    command.m_componentCallback = std::move(change);
+    Record(std::move(command));
+}
+
+bool Brokkr::EntityCommandBuffer::IsEmpty()
+{
+    std::lock_guard lock(m_mutex);
+    return m_recording.empty();
+}
+
+void Brokkr::EntityCommandBuffer::Playback(GameEntityManager* pEntityManager)
+{
+    // Commands can record more commands (spawn callbacks etc.) so keep going until it settles
+    for (int pass = 0; pass < kMaxPlaybackPasses; ++pass)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_recording.empty())
+            {
+                return;
+            }
+
+            // Swap so recording can carry on while this batch is applied
+            std::swap(m_recording, m_playback);
+        }
+
+        for (auto& command : m_playback)
+        {
+            Apply(pEntityManager, command);
+        }
+
+        // clear keeps the capacity for the next frame
+        m_playback.clear();
+    }
+}
+
+void Brokkr::EntityCommandBuffer::Clear()
+{
+    std::lock_guard lock(m_mutex);
+    for (const auto& command : m_recording)
+    {
+        delete command.m_pEntity;
+    }
+    m_recording.clear();
+}
+
+void Brokkr::EntityCommandBuffer::Record(Command&& command)
+{
+    std::lock_guard lock(m_mutex);
+    m_recording.emplace_back(std::move(command));
+}
+
+void Brokkr::EntityCommandBuffer::Apply(GameEntityManager* pEntityManager, Command& command)
+{
+    switch (command.m_type)
+    {
+    case CommandType::kSpawn:
+    case CommandType::kSpawnAt:
+    {
+        GameEntity* pEntity = (command.m_type == CommandType::kSpawnAt)
+            ? pEntityManager->Construct(command.m_prefabName.c_str(), command.m_fileName.c_str(), command.m_position)
+            : pEntityManager->Construct(command.m_prefabName.c_str(), command.m_fileName.c_str());
+
+        if (pEntity == nullptr)
+        {
+            return; // prefab not found
+        }
+
+        pEntityManager->SetEntityName(pEntity, command.m_prefabName);
+
+        if (command.m_callback)
+        {
+            command.m_callback(pEntity);
+        }
+        break;
+    }
+
+    case CommandType::kAdd:
+        pEntityManager->AddEntity(command.m_pEntity);
+        command.m_pEntity = nullptr;
+        break;
+
+    case CommandType::kDestroy:
+        pEntityManager->DeleteEntity(command.m_entityId);
+        break;
+
+    case CommandType::kEdit:
+        if (GameEntity* pEntity = pEntityManager->GetEntityById(command.m_entityId))
+        {
+            command.m_callback(pEntity);
+        }
+        break;
+
+    case CommandType::kComponent:
+        if (GameEntity* pEntity = pEntityManager->GetEntityById(command.m_entityId))
+        {
+            command.m_componentCallback(pEntityManager, pEntity);
+        }
+        break;
+
+    case CommandType::kEnable:
+        if (GameEntity* pEntity = pEntityManager->GetEntityById(command.m_entityId))
+        {
+            pEntity->Enable();
+        }
+        break;
+
+    case CommandType::kDisable:
+        if (GameEntity* pEntity = pEntityManager->GetEntityById(command.m_entityId))
+        {
+            pEntity->Disable();
+        }
+        break;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Vector2.h"
+#include "Entity/GameEntity/GameEntity.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//                             EntityCommandBuffer:
+//
+// Records structural changes (spawns, destroys, component add / remove) so they can be
+// applied at one sync point in the frame instead of while something is iterating the
+// entities. Recording is guarded by a mutex so any thread can fill the buffer, playback
+// always happens on the main thread through GameEntityManager::FlushCommands().
+//
+//      auto& commands = pEntityManager->GetCommandBuffer();
+//      commands.Spawn("Collider", "GameEntities.XML", { 64.f, 32.f });
+//      commands.Destroy(pEntity->GetId());
+//      commands.AddComponent<KinematicComponent>(pEntity->GetId(), pCoreSystems, 1.f, 1.f, 1.f, 1.f);
+//
+// Commands are applied in the order they were recorded. Entities handed out by
+// GameEntityManager::GetNextEntityAvailable while deferring are recorded here too and join
+// the manager at playback, dropping the commands with Clear() frees them.
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class GameEntityManager;
+
+    class EntityCommandBuffer
+    {
+    public:
+        using EntityCallback = std::function<void(GameEntity*)>;
+        using ComponentCallback = std::function<void(GameEntityManager*, GameEntity*)>;
+
+    private:
+        enum class CommandType
+        {
+            kSpawn,
+            kSpawnAt,
+            kAdd,
+            kDestroy,
+            kEdit,
+            kComponent,
+            kEnable,
+            kDisable
+        };
+
+        struct Command
+        {
+            explicit Command(CommandType type) : m_type(type) {}
+
+            CommandType m_type;
+            int m_entityId = -1;
+            GameEntity* m_pEntity = nullptr;    // kAdd, owned by the command until it is applied
+            std::string m_prefabName;
+            std::string m_fileName;
+            Vector2<float> m_position;
+            EntityCallback m_callback;
+            ComponentCallback m_componentCallback;
+        };
+
+        // Max times playback will loop when commands record more commands
+        inline static constexpr int kMaxPlaybackPasses = 8;
+
+        std::mutex m_mutex;
+        std::vector<Command> m_recording;
+        std::vector<Command> m_playback;
+
+    public:
+        EntityCommandBuffer() = default;
+        ~EntityCommandBuffer();
+
+        EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+        EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+        // Spawn a prefab, the callback gets the new entity once it exists
+        void Spawn(const std::string& prefabName, const std::string& fileName, EntityCallback onSpawned = nullptr);
+        void Spawn(const std::string& prefabName, const std::string& fileName, const Vector2<float>& position, EntityCallback onSpawned = nullptr);
+
+        // An entity already built, added to the manager at playback. Used by GameEntityManager while deferring
+        void Add(GameEntity* pEntity);
+
+        void Destroy(int entityId);
+        void Enable(int entityId);
+        void Disable(int entityId);
+
+        // Run any change against an entity at the sync point
+        void Edit(int entityId, EntityCallback edit);
+
+        // Arguments are copied now and forwarded to the component at playback. Both go through the
+        // GameEntityManager so sprites join and leave the render list, defined in GameEntityManager.h
+        template<typename ComponentType, typename... Args>
+        void AddComponent(int entityId, Args&&... args);
+
+        template<typename ComponentType>
+        void RemoveComponent(int entityId);
+
+        [[nodiscard]] bool IsEmpty();
+
+        // Apply everything recorded so far, main thread only
+        void Playback(GameEntityManager* pEntityManager);
+
+        // Drops everything recorded and not yet applied, entities waiting to be added are deleted
+        void Clear();
+
+    private:
+        void Record(Command&& command);
+        void RecordComponentChange(int entityId, ComponentCallback change);
+        static void Apply(GameEntityManager* pEntityManager, Command& command);
+    };
+}
@@ -1,10 +1,16 @@
 #include "GameEntityManager.h"
 
+#include <algorithm>
+#include <fstream>
+
 #include <ColliderComponent.h>
 #include <GameEntity.h>
 #include <TransformComponent.h>
 #include "AssetManager/AssetManager.h"
+#include "Core/EngineDefinitions.h"
+#include "EventManager/EventManager.h"
 #include "RenderComponent/SpriteComponent.h"
+#include "Utility/BinaryStream.h"
 #include "XMLManager/Parsers/EntityXMLParser/EntityXMLParser.h"
 #include "XMLManager/Parsers/PositionDataParser/PositionDataParser.h"
 
@@ -17,7 +23,9 @@ namespace Brokkr
 
 Brokkr::GameEntityManager::GameEntityManager(CoreSystems* pCoreManager): System(pCoreManager)
 {
-    //
+    TransformComponent::RegisterSnapshotFunction(this);
+    ColliderComponent::RegisterSnapshotFunction(this);
+    SpriteComponent::RegisterSnapshotFunction(this);
 }
 
 Brokkr::GameEntityManager::~GameEntityManager()
@@ -32,6 +40,12 @@ void Brokkr::GameEntityManager::Init()
 {
     m_pPhysicsManager = m_pCoreManager->GetCoreSystem<PhysicsManager>();
 
+    // Event handlers record their spawns, destroys and component changes like entity updates do
+    if (const auto pEventManager = m_pCoreManager->GetCoreSystem<EventManager>())
+    {
+        pEventManager->SetDispatchScope(&GameEntityManager::OnEventDispatch, this);
+    }
+
     if (!m_pXmlManager) // get xml Manager
     {
         m_pXmlManager = m_pCoreManager->GetCoreSystem<XMLManager>();
@@ -51,59 +65,298 @@ Brokkr::GameEntity* Brokkr::GameEntityManager::GetNextEntityAvailable()
 {
     auto pEntity = new GameEntity;
 
+    // Never grow the entity list under an update loop or an event dispatch
+    if (IsDeferring())
+    {
+        m_commandBuffer.Add(pEntity);
+        return pEntity;
+    }
+
+    AddEntity(pEntity);
+
+    return pEntity;
+}
+
+void Brokkr::GameEntityManager::AddEntity(GameEntity* pEntity)
+{
     m_entities.push_back(pEntity);
     m_entityLookup[pEntity->GetId()] = m_entities.size() - 1;
 
-    return pEntity;
+    // New entities start active, move it from the end into the active partition
+    SwapEntities(m_activeCount, m_entities.size() - 1);
+    ++m_activeCount;
+}
+
+void Brokkr::GameEntityManager::SwapEntities(size_t left, size_t right)
+{
+    if (left == right)
+    {
+        return;
+    }
+
+    std::swap(m_entities[left], m_entities[right]);
+    m_entityLookup[m_entities[left]->GetId()] = left;
+    m_entityLookup[m_entities[right]->GetId()] = right;
 }
 
 void Brokkr::GameEntityManager::DeleteEntity(int entityID)
 {
+    // Never pull an entity out from under an update loop or an event dispatch
+    if (IsDeferring())
+    {
+        m_commandBuffer.Destroy(entityID);
+        return;
+    }
+
     const auto it = m_entityLookup.find(entityID);
     if (it == m_entityLookup.end())
     {
         return;
     }
 
-    const size_t index = it->second;
+    size_t index = it->second;
+    GameEntity* pEntity = m_entities[index];
 
-    // Delete the entity being removed
-    delete m_entities[index];
+    // Drop the entity from the name and tag index before it is freed
+    UnindexEntity(pEntity);
 
-    // Swap the entity to be deleted with the last entity in the vector
-    m_entities[index] = std::move(m_entities.back());
+    // Stop rendering its sprite
+    if (const auto pSprite = pEntity->GetComponent<SpriteComponent>())
+    {
+        UntrackRenderComponent(pSprite);
+    }
 
-    // Update the lookup map
-    m_entityLookup[m_entities[index]->GetId()] = index;
+    // The region stays where the focus entity was last seen
+    if (pEntity == m_pActivityFocusEntity)
+    {
+        m_pActivityFocusEntity = nullptr;
+    }
 
-    // Remove the last entity in the vector
+    // Keep the [active | suspended] partition: fill the hole from the end of the active range first
+    if (index < m_activeCount)
+    {
+        SwapEntities(index, m_activeCount - 1);
+        index = --m_activeCount;
+    }
+
+    // Swap the entity to be deleted with the last entity in the vector and remove it
+    SwapEntities(index, m_entities.size() - 1);
     m_entities.pop_back();
+    m_entityLookup.erase(entityID);
+
+    // Delete the entity being removed
+    delete pEntity;
+}
 
-    // Remove the entity from the lookup map
-    m_entityLookup.erase(it);
+void Brokkr::GameEntityManager::FlushCommands()
+{
+    m_commandBuffer.Playback(this);
 }
 
-void Brokkr::GameEntityManager::UpdateEntities() const
+void Brokkr::GameEntityManager::OnEventDispatch(void* pContext, bool isDispatching)
 {
-    for (auto& pEntity : m_entities)
+    auto* pEntityManager = static_cast<GameEntityManager*>(pContext);
+    if (isDispatching)
+    {
+        ++pEntityManager->m_deferDepth;
+    }
+    else
     {
-        pEntity->Update();
+        --pEntityManager->m_deferDepth;
     }
 }
 
+void Brokkr::GameEntityManager::SetActivityRegion(const Vector2<float>& focus, float radius)
+{
+    m_hasActivityRegion = true;
+    m_activityFocus = focus;
+    m_pActivityFocusEntity = nullptr;
+    m_activityRadius = radius;
+}
+
+void Brokkr::GameEntityManager::SetActivityRegion(GameEntity* pFocusEntity, float radius)
+{
+    m_hasActivityRegion = true;
+    m_pActivityFocusEntity = pFocusEntity;
+    m_activityRadius = radius;
+}
+
+void Brokkr::GameEntityManager::ClearActivityRegion()
+{
+    m_hasActivityRegion = false;
+    m_pActivityFocusEntity = nullptr;
+
+    // Everything wakes back up
+    while (m_activeCount < m_entities.size())
+    {
+        ResumeEntity(m_activeCount);
+    }
+}
+
+void Brokkr::GameEntityManager::UpdateActivity()
+{
+    if (!m_hasActivityRegion)
+    {
+        return;
+    }
+
+    // The region works off the broadphase, managers that never ran Init look it up here
+    if (m_pPhysicsManager == nullptr)
+    {
+        m_pPhysicsManager = m_pCoreManager->GetCoreSystem<PhysicsManager>();
+        if (m_pPhysicsManager == nullptr)
+        {
+            return;
+        }
+    }
+
+    if (m_pActivityFocusEntity)
+    {
+        if (const auto pTransform = m_pActivityFocusEntity->GetComponent<TransformComponent>())
+        {
+            m_activityFocus = pTransform->GetTransform().GetCenter();
+        }
+    }
+
+    const Vector2<float> focus = m_activityFocus;
+    const float radius = m_activityRadius;
+
+    // Stamp everything the broadphase finds in range, resuming the ones that were suspended
+    ++m_activityStamp;
+
+    const Rectangle<float> area({ focus.m_x - radius, focus.m_y - radius }, { radius * 2.f, radius * 2.f });
+    for (const int objectId : m_pPhysicsManager->QueryAreaAll(area))
+    {
+        const auto it = m_entityLookup.find(objectId);
+        if (it == m_entityLookup.end())
+        {
+            continue;
+        }
+
+        GameEntity* pEntity = m_entities[it->second];
+        if (pEntity->m_activityStamp == m_activityStamp)
+        {
+            continue;
+        }
+
+        RefreshActivityComponents(pEntity);
+        if (!IsInRange(pEntity, focus, radius))
+        {
+            continue;
+        }
+
+        pEntity->m_activityStamp = m_activityStamp;
+
+        if (it->second >= m_activeCount)
+        {
+            ResumeEntity(it->second);
+        }
+    }
+
+    // Only the active range is walked, so the cost follows the neighbourhood not the map.
+    // Entities without a collider are not in the broadphase and could never be resumed, they stay active.
+    for (size_t i = 0; i < m_activeCount;)
+    {
+        GameEntity* pEntity = m_entities[i];
+        if (pEntity->m_activityStamp == m_activityStamp)
+        {
+            ++i;
+            continue;
+        }
+
+        RefreshActivityComponents(pEntity);
+        if (pEntity->m_pActivityCollider != nullptr && !IsInRange(pEntity, focus, radius + kSuspendMargin))
+        {
+            // Swaps another active entity into i, so check i again
+            SuspendEntity(i);
+            continue;
+        }
+
+        ++i;
+    }
+}
+
+void Brokkr::GameEntityManager::SuspendEntity(size_t index)
+{
+    m_entities[index]->m_isSuspended = true;
+    SwapEntities(index, m_activeCount - 1);
+    --m_activeCount;
+}
+
+void Brokkr::GameEntityManager::ResumeEntity(size_t index)
+{
+    m_entities[index]->m_isSuspended = false;
+    SwapEntities(index, m_activeCount);
+    ++m_activeCount;
+}
+
+bool Brokkr::GameEntityManager::IsInRange(const GameEntity* pEntity, const Vector2<float>& focus, float radius)
+{
+    const TransformComponent* pTransform = pEntity->m_pActivityTransform;
+    if (pTransform == nullptr)
+    {
+        return true;
+    }
+
+    // Distance from the focus to the closest point on the entity's rectangle
+    const Rectangle<float> rect = pTransform->GetTransform();
+    const float closestX = std::clamp(focus.m_x, rect.GetLeft(), rect.GetRight());
+    const float closestY = std::clamp(focus.m_y, rect.GetTop(), rect.GetBottom());
+    const float deltaX = focus.m_x - closestX;
+    const float deltaY = focus.m_y - closestY;
+
+    return (deltaX * deltaX + deltaY * deltaY) <= radius * radius;
+}
+
+void Brokkr::GameEntityManager::RefreshActivityComponents(GameEntity* pEntity)
+{
+    // Components rarely change after spawn, the dynamic_cast scans only run again when they do
+    if (pEntity->m_activityComponentVersion != pEntity->m_componentVersion)
+    {
+        pEntity->m_pActivityTransform = pEntity->GetComponent<TransformComponent>();
+        pEntity->m_pActivityCollider = pEntity->GetComponent<ColliderComponent>();
+        pEntity->m_activityComponentVersion = pEntity->m_componentVersion;
+    }
+}
+
+void Brokkr::GameEntityManager::UpdateEntities()
+{
+    UpdateActivity();
+
+    ++m_deferDepth;
+
+    // Suspended entities sit after m_activeCount and are skipped
+    for (size_t i = 0; i < m_activeCount; ++i)
+    {
+        m_entities[i]->Update();
+    }
+
+    --m_deferDepth;
+}
+
 void Brokkr::GameEntityManager::LateUpdateEntities()
 {
-    for (auto& pEntity : m_entities)
+    ++m_deferDepth;
+
+    for (size_t i = 0; i < m_activeCount; ++i)
     {
-        pEntity->LateUpdate();
+        m_entities[i]->LateUpdate();
     }
+
+    --m_deferDepth;
+
+    // Physics and LateUpdate have moved the parents, carry their children along
+    m_transformHierarchy.Resolve();
 }
 
 void Brokkr::GameEntityManager::RenderEntities() const
 {
     for (auto& pEntity : m_pRenderComponents)
     {
-        pEntity->Render();
+        if (!pEntity->GetOwner()->IsSuspended())
+        {
+            pEntity->Render();
+        }
     }
 }
 
@@ -118,17 +371,124 @@ Brokkr::GameEntity* Brokkr::GameEntityManager::GetEntityById(int entityID)
     return m_entities[it->second];
 }
 
+Brokkr::GameEntity::NameID Brokkr::GameEntityManager::InternName(const std::string& name)
+{
+    if (const auto it = m_internedNames.find(name); it != m_internedNames.end())
+    {
+        return it->second;
+    }
+
+    // New names get the next slot in both buckets so the NameID can index them directly
+    const auto nameId = static_cast<GameEntity::NameID>(m_nameIndex.size());
+    m_internedNames.emplace(name, nameId);
+    m_nameIndex.emplace_back();
+    m_tagIndex.emplace_back();
+
+    return nameId;
+}
+
+Brokkr::GameEntity::NameID Brokkr::GameEntityManager::FindNameID(const std::string& name) const
+{
+    if (const auto it = m_internedNames.find(name); it != m_internedNames.end())
+    {
+        return it->second;
+    }
+
+    return GameEntity::kNoName;
+}
+
+void Brokkr::GameEntityManager::SetEntityName(GameEntity* pEntity, const std::string& name)
+{
+    const GameEntity::NameID nameId = InternName(name);
+
+    if (pEntity->GetNameID() == nameId)
+    {
+        return;
+    }
+
+    // Move the entity from its old name bucket into the new one
+    if (pEntity->GetNameID() != GameEntity::kNoName)
+    {
+        RemoveFromNameBucket(pEntity);
+    }
+
+    pEntity->SetName(name, nameId);
+    pEntity->m_nameSlot = static_cast<uint32_t>(m_nameIndex[nameId].size());
+    m_nameIndex[nameId].push_back(pEntity);
+}
+
+void Brokkr::GameEntityManager::AddEntityTag(GameEntity* pEntity, const std::string& tag)
+{
+    const GameEntity::NameID tagId = InternName(tag);
+
+    if (pEntity->HasTag(tagId))
+    {
+        return;
+    }
+
+    pEntity->AddTag(tagId, static_cast<uint32_t>(m_tagIndex[tagId].size()));
+    m_tagIndex[tagId].push_back(pEntity);
+}
+
+void Brokkr::GameEntityManager::RemoveEntityTag(GameEntity* pEntity, const std::string& tag)
+{
+    const GameEntity::NameID tagId = FindNameID(tag);
+
+    if (tagId == GameEntity::kNoName || !pEntity->HasTag(tagId))
+    {
+        return;
+    }
+
+    const size_t tagIndex = pEntity->FindTag(tagId);
+    RemoveFromTagBucket(pEntity, tagIndex);
+    pEntity->RemoveTagAt(tagIndex);
+}
+
 Brokkr::GameEntity* Brokkr::GameEntityManager::GetEntityByName(const std::string& name) const
 {
-    for (GameEntity* entity : m_entities)
+    return GetEntityByName(FindNameID(name));
+}
+
+Brokkr::GameEntity* Brokkr::GameEntityManager::GetEntityByName(GameEntity::NameID nameId) const
+{
+    const auto& entities = GetEntitiesByName(nameId);
+
+    if (entities.empty())
     {
-        if (entity->GetName() == name)
-        {
-            return entity;
-        }
+        return nullptr;
     }
 
-    return nullptr;
+    return entities.front();
+}
+
+const std::vector<Brokkr::GameEntity*>& Brokkr::GameEntityManager::GetEntitiesByName(const std::string& name) const
+{
+    return GetEntitiesByName(FindNameID(name));
+}
+
+const std::vector<Brokkr::GameEntity*>& Brokkr::GameEntityManager::GetEntitiesByName(GameEntity::NameID nameId) const
+{
+    if (nameId >= m_nameIndex.size())
+    {
+        return s_kNoEntities;
+    }
+
+    return m_nameIndex[nameId];
+}
+
+const std::vector<Brokkr::GameEntity*>& Brokkr::GameEntityManager::GetEntitiesByTag(const std::string& tag) const
+{
+    return GetEntitiesByTag(FindNameID(tag));
+}
+
+const std::vector<Brokkr::GameEntity*>& Brokkr::GameEntityManager::GetEntitiesByTag(GameEntity::NameID tagId) const
+{
+    if (tagId >= m_tagIndex.size())
+    {
+        return s_kNoEntities;
+    }
+
+    return m_tagIndex[tagId];
 }
 
 std::vector<Brokkr::GameEntity*> Brokkr::GameEntityManager::GetEntitiesInArea(const Rectangle<float>& area)
@@ -191,7 +551,7 @@ std::list<Brokkr::GameEntity*> Brokkr::GameEntityManager::ConstructWithLocation(
         if (pCollider != nullptr)
             pCollider->AdjustByPos(data);
 
-        pInitList.back()->SetName(prefabName);
+        SetEntityName(pInitList.back(), prefabName);
 
     }
 
@@ -205,6 +565,36 @@ std::list<Brokkr::GameEntity*> Brokkr::GameEntityManager::ConstructWithLocation(
 }
 
 Brokkr::GameEntity* Brokkr::GameEntityManager::Construct(const char* prefabName, const char* fileName)
+{
+    GameEntity* pEntity = BuildEntity(prefabName, fileName);
+    if (pEntity == nullptr)
+    {
+        return nullptr;
+    }
+
+    FinishConstruct(pEntity);
+    return pEntity;
+}
+
+Brokkr::GameEntity* Brokkr::GameEntityManager::Construct(const char* prefabName, const char* fileName, const Vector2<float>& position)
+{
+    GameEntity* pEntity = BuildEntity(prefabName, fileName);
+    if (pEntity == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Place it before Init so the collider is created at the right spot
+    if (const auto pTransform = pEntity->GetComponent<TransformComponent>())
+    {
+        pTransform->SetStartingPos(position);
+    }
+
+    FinishConstruct(pEntity);
+    return pEntity;
+}
+
+Brokkr::GameEntity* Brokkr::GameEntityManager::BuildEntity(const char* prefabName, const char* fileName)
 {
     if (!m_pXmlManager) // get xml Manager
     {
@@ -216,21 +606,262 @@ Brokkr::GameEntity* Brokkr::GameEntityManager::Construct(const char* prefabName,
         m_pEntityParser = m_pXmlManager->GetParser<EntityXMLParser>();
     }
 
-    const auto init = m_pEntityParser->BuildEntity(prefabName, m_pXmlManager->Get(fileName));
-    init->Init();
+    return m_pEntityParser->BuildEntity(prefabName, m_pXmlManager->Get(fileName));
+}
+
+void Brokkr::GameEntityManager::FinishConstruct(GameEntity* pEntity)
+{
+    pEntity->Init();
 
-    if (auto spriteComponent = init->GetComponent<SpriteComponent>()) 
+    if (auto spriteComponent = pEntity->GetComponent<SpriteComponent>()) 
     {
         m_pRenderComponents.emplace_back(spriteComponent);
     }
+}
+
+void Brokkr::GameEntityManager::TrackRenderComponent(Component* pComponent)
+{
+    if (auto pSprite = dynamic_cast<SpriteComponent*>(pComponent))
+    {
+        m_pRenderComponents.emplace_back(pSprite);
+    }
+}
+
+void Brokkr::GameEntityManager::UntrackRenderComponent(const Component* pComponent)
+{
+    m_pRenderComponents.erase(std::remove(m_pRenderComponents.begin(), m_pRenderComponents.end(), pComponent), m_pRenderComponents.end());
+}
+
+void Brokkr::GameEntityManager::RegisterSnapshotCreationFunction(uint32_t snapshotId, SnapshotCreationFunction creationFunction)
+{
+    m_snapshotCreationFunctions[snapshotId] = std::move(creationFunction);
+}
+
+namespace
+{
+    // A child transform's parent, its offset is kept as is rather than rebuilt from float positions
+    struct TransformLink
+    {
+        int32_t m_childId, m_parentId;
+        float m_localX, m_localY;
+    };
+}
+
+void Brokkr::GameEntityManager::WriteSnapshot(BinaryWriter& writer) const
+{
+    writer.Write(kSnapshotMagic);
+    writer.Write(kSnapshotVersion);
+    writer.Write(static_cast<uint32_t>(m_entities.size()));
+
+    // Reverse of the interned names so tags can be written as strings
+    std::vector<const std::string*> names(m_nameIndex.size(), nullptr);
+    for (const auto& [name, nameId] : m_internedNames)
+    {
+        names[nameId] = &name;
+    }
+
+    for (const auto& pEntity : m_entities)
+    {
+        writer.Write(static_cast<int32_t>(pEntity->GetId()));
+        writer.WriteString(pEntity->GetName());
+
+        writer.Write(static_cast<uint32_t>(pEntity->GetTags().size()));
+        for (const GameEntity::NameID tagId : pEntity->GetTags())
+        {
+            writer.WriteString(*names[tagId]);
+        }
+
+        pEntity->Serialize(writer);
+
+        // Large worlds stream out entity by entity instead of growing one big buffer
+        writer.FlushIfFull();
+    }
+
+    // Parent links go last, by entity id, so every parent exists by the time they are read back
+    std::vector<TransformLink> links;
+    for (const auto& pEntity : m_entities)
+    {
+        const auto pTransform = pEntity->GetComponent<TransformComponent>();
+        const TransformComponent* pParent = pTransform ? pTransform->GetParent() : nullptr;
+        if (pParent)
+        {
+            const Vector2<float> local = pTransform->GetLocalPosition();
+            links.push_back({ pEntity->GetId(), pParent->GetOwner()->GetId(), local.m_x, local.m_y });
+        }
+    }
+
+    writer.Write(static_cast<uint32_t>(links.size()));
+    for (const TransformLink& link : links)
+    {
+        writer.Write(link);
+    }
+}
+
+bool Brokkr::GameEntityManager::SaveSnapshot(const char* filePath) const
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    BinaryWriter writer(&file, kSnapshotFlushSize);
+    WriteSnapshot(writer);
+    writer.Flush();
+
+    return !writer.HasFailed() && file.good();
+}
+
+bool Brokkr::GameEntityManager::ReadSnapshot(BinaryReader& reader)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t entityCount = 0;
+
+    if (!reader.Read(magic) || magic != kSnapshotMagic || !reader.Read(version) || version != kSnapshotVersion
+        || !reader.Read(entityCount))
+    {
+        return false;
+    }
+
+    // Everything is read into a staging set first, the current world is only replaced once the whole
+    // snapshot read cleanly. A cut short or corrupt file leaves the world as it was
+    struct StagedEntity
+    {
+        GameEntity* m_pEntity = nullptr;
+        std::string m_name;
+        std::vector<std::string> m_tags;
+    };
+
+    std::vector<StagedEntity> staged;
+    staged.reserve(std::min<size_t>(entityCount, reader.GetRemaining()));
+
+    const auto discardStaged = [&staged]()
+    {
+        for (const auto& entity : staged)
+        {
+            delete entity.m_pEntity;
+        }
+        return false;
+    };
+
+    for (uint32_t i = 0; i < entityCount; ++i)
+    {
+        int32_t id = 0;
+        uint32_t tagCount = 0;
+        StagedEntity entity;
+
+        if (!reader.Read(id) || !reader.ReadString(entity.m_name) || !reader.Read(tagCount))
+        {
+            return discardStaged();
+        }
+
+        for (uint32_t t = 0; t < tagCount; ++t)
+        {
+            if (!reader.ReadString(entity.m_tags.emplace_back()))
+            {
+                return discardStaged();
+            }
+        }
+
+        entity.m_pEntity = new GameEntity(id);
+        staged.push_back(std::move(entity));
+
+        if (!staged.back().m_pEntity->Deserialize(reader, m_snapshotCreationFunctions, m_pCoreManager))
+        {
+            return discardStaged();
+        }
+    }
+
+    uint32_t linkCount = 0;
+    if (!reader.Read(linkCount))
+    {
+        return discardStaged();
+    }
+
+    std::vector<TransformLink> links(std::min<size_t>(linkCount, reader.GetRemaining() / sizeof(TransformLink)));
+    if (links.size() != linkCount)
+    {
+        return discardStaged();
+    }
+
+    for (TransformLink& link : links)
+    {
+        if (!reader.Read(link))
+        {
+            return discardStaged();
+        }
+    }
+
+    // Commit: the snapshot is good, swap the world over
+    ClearEntities();
+
+    for (const auto& entity : staged)
+    {
+        AddEntity(entity.m_pEntity);
+
+        if (!entity.m_name.empty())
+        {
+            SetEntityName(entity.m_pEntity, entity.m_name);
+        }
+
+        for (const auto& tag : entity.m_tags)
+        {
+            AddEntityTag(entity.m_pEntity, tag);
+        }
+    }
+
+    // Init only once every entity exists, components may look each other up by name
+    for (const auto& entity : staged)
+    {
+        FinishConstruct(entity.m_pEntity);
+
+        if (!entity.m_pEntity->IsEnabled())
+        {
+            entity.m_pEntity->Disable();
+        }
+    }
+
+    // Relink the hierarchy once every transform is placed, links to entities without a transform are dropped
+    for (const TransformLink& link : links)
+    {
+        GameEntity* pChild = GetEntityById(link.m_childId);
+        GameEntity* pParent = GetEntityById(link.m_parentId);
+        const auto pChildTransform = pChild ? pChild->GetComponent<TransformComponent>() : nullptr;
+        const auto pParentTransform = pParent ? pParent->GetComponent<TransformComponent>() : nullptr;
+
+        if (pChildTransform && pParentTransform && m_transformHierarchy.SetParent(pChildTransform, pParentTransform))
+        {
+            m_transformHierarchy.SetLocalPosition(pChildTransform, { link.m_localX, link.m_localY });
+        }
+    }
+
+    for (const auto& entity : staged)
+    {
+        entity.m_pEntity->OnSnapshotRestored();
+    }
+
+    return true;
+}
+
+bool Brokkr::GameEntityManager::LoadSnapshot(const char* filePath)
+{
+    BinaryReader reader;
+    if (!reader.LoadFromFile(filePath))
+    {
+        return false;
+    }
 
-    return init;
+    return ReadSnapshot(reader);
 }
 
 void Brokkr::GameEntityManager::ClearEntities()
 {
     try
     {
+        // Recorded changes belong to the world being cleared, entities still waiting to be added go with it
+        m_commandBuffer.Clear();
+
         for (auto& entity : m_entities)
         {
             if (entity != nullptr)
@@ -241,6 +872,23 @@ void Brokkr::GameEntityManager::ClearEntities()
         }
         m_entities.clear();
         m_entityLookup.clear();
+        m_activeCount = 0;
+        m_pActivityFocusEntity = nullptr;
+        m_pRenderComponents.clear();
+
+        // Every component went back to its pool, re-thread them for the next scene
+        ComponentPoolRegistry::ResetAll();
+
+        // Interned names stay valid between scenes only the buckets are emptied
+        for (auto& bucket : m_nameIndex)
+        {
+            bucket.clear();
+        }
+
+        for (auto& bucket : m_tagIndex)
+        {
+            bucket.clear();
+        }
     }
     catch ([[maybe_unused]] const std::exception& e)
     {
@@ -249,8 +897,69 @@ void Brokkr::GameEntityManager::ClearEntities()
     }
 }
 
+void Brokkr::GameEntityManager::UnindexEntity(const GameEntity* pEntity)
+{
+    if (pEntity->GetNameID() != GameEntity::kNoName)
+    {
+        RemoveFromNameBucket(pEntity);
+    }
+
+    for (size_t i = 0; i < pEntity->GetTags().size(); ++i)
+    {
+        RemoveFromTagBucket(pEntity, i);
+    }
+}
+
+void Brokkr::GameEntityManager::RemoveFromNameBucket(const GameEntity* pEntity)
+{
+    // Swap and pop, bucket order is not meaningful. The entity moved into the hole takes over the slot
+    auto& bucket = m_nameIndex[pEntity->GetNameID()];
+    const uint32_t slot = pEntity->m_nameSlot;
+    GameEntity* pMoved = bucket.back();
+    bucket[slot] = pMoved;
+    pMoved->m_nameSlot = slot;
+    bucket.pop_back();
+}
+
+void Brokkr::GameEntityManager::RemoveFromTagBucket(const GameEntity* pEntity, size_t tagIndex)
+{
+    const GameEntity::NameID tagId = pEntity->m_tags[tagIndex];
+    auto& bucket = m_tagIndex[tagId];
+    const uint32_t slot = pEntity->m_tagSlots[tagIndex];
+    GameEntity* pMoved = bucket.back();
+    bucket[slot] = pMoved;
+    pMoved->m_tagSlots[pMoved->FindTag(tagId)] = slot;
+    bucket.pop_back();
+}
+
+void Brokkr::GameEntityManager::RegisterStages(FrameScheduler& scheduler)
+{
+    constexpr auto kSimulation = FrameScheduler::Phase::kSimulation;
+    scheduler.AddStage<&GameEntityManager::UpdateEntities>(EngineDefinitions::STAGE_UPDATE_ENTITIES, kSimulation, this);
+    scheduler.AddStage<&GameEntityManager::LateUpdateEntities>(EngineDefinitions::STAGE_LATE_UPDATE_ENTITIES, kSimulation, this);
+    scheduler.AddStage<&GameEntityManager::FlushCommands>(EngineDefinitions::STAGE_FLUSH_ENTITY_COMMANDS, kSimulation, this);
+    scheduler.AddStage<&GameEntityManager::RenderEntities>(EngineDefinitions::STAGE_RENDER_ENTITIES, FrameScheduler::Phase::kRender, this);
+
+    // Scene first, then entities, physics in between update and late update when there is one
+    scheduler.AddDependency(EngineDefinitions::STAGE_UPDATE_ENTITIES, EngineDefinitions::STAGE_SCENE_UPDATE);
+    scheduler.AddDependency(EngineDefinitions::STAGE_LATE_UPDATE_ENTITIES, EngineDefinitions::STAGE_UPDATE_ENTITIES);
+    scheduler.AddDependency(EngineDefinitions::STAGE_LATE_UPDATE_ENTITIES, EngineDefinitions::STAGE_PHYSICS);
+
+    // Structural changes once the step's events have been handled
+    scheduler.AddDependency(EngineDefinitions::STAGE_FLUSH_ENTITY_COMMANDS, EngineDefinitions::STAGE_LATE_UPDATE_ENTITIES);
+    scheduler.AddDependency(EngineDefinitions::STAGE_FLUSH_ENTITY_COMMANDS, EngineDefinitions::STAGE_PROCESS_EVENTS);
+
+    scheduler.AddDependency(EngineDefinitions::STAGE_RENDER_ENTITIES, EngineDefinitions::STAGE_CLEAR_RENDER);
+}
+
 void Brokkr::GameEntityManager::Destroy()
 {
+    const auto pEventManager = m_pCoreManager ? m_pCoreManager->GetCoreSystem<EventManager>() : nullptr;
+    if (pEventManager)
+    {
+        pEventManager->SetDispatchScope(nullptr, nullptr);
+    }
+
     //TODO:
     ClearEntities();
 }
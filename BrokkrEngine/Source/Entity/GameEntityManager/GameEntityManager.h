@@ -1,9 +1,14 @@
 #pragma once
 
+#include <list>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 #include "Core/Core.h"
+#include "EntityCommandBuffer.h"
+#include "Entity/GameEntity/GameEntity.h"
+#include "Entity/GameEntity/Component/TransformComponent/TransformHierarchy.h"
 
 #include "Rectangle.h"
 #include "Vector2.h"
@@ -16,14 +21,17 @@ namespace Brokkr
 {
     class SpriteComponent;
     class PhysicsManager;
-    class GameEntity;
     class EntityXMLParser;
     class PositionDataParser;
     class XMLManager;
+    class BinaryWriter;
+    class BinaryReader;
 
     class GameEntityManager final : public System
     {
+        // Partitioned as [active | suspended], only the first m_activeCount entities update
         std::vector<GameEntity*> m_entities;
+        size_t m_activeCount = 0;
         std::unordered_map<int, size_t> m_entityLookup;
         std::vector<SpriteComponent*> m_pRenderComponents;
 
@@ -34,6 +42,38 @@ namespace Brokkr
 
         std::unordered_map<std::string, Vector2<float>> m_entitiesStartingPositions;
 
+        // Interned names and tags, the NameID is the index into the name and tag buckets
+        std::unordered_map<std::string, GameEntity::NameID> m_internedNames;
+        std::vector<std::vector<GameEntity*>> m_nameIndex;
+        std::vector<std::vector<GameEntity*>> m_tagIndex;
+
+        inline static const std::vector<GameEntity*> s_kNoEntities{};
+
+        // Structural changes recorded during the frame, applied in FlushCommands. While the entities are
+        // updated or events are dispatched the depth is above 0 and changes are recorded instead of applied
+        EntityCommandBuffer m_commandBuffer;
+        uint32_t m_deferDepth = 0;
+
+        // Activity region, a focus point (or entity) and radius, entities outside it are suspended
+        bool m_hasActivityRegion = false;
+        Vector2<float> m_activityFocus;
+        GameEntity* m_pActivityFocusEntity = nullptr;
+        float m_activityRadius = 0.f;
+        uint32_t m_activityStamp = 0;
+
+        // Extra distance before an active entity is suspended so edge entities don't flicker
+        inline static constexpr float kSuspendMargin = 32.f;
+
+        // Parent / child transform links, resolved at the end of LateUpdateEntities
+        TransformHierarchy m_transformHierarchy;
+
+        // Component restore functions keyed on Component::GetSnapshotID
+        SnapshotCreationTable m_snapshotCreationFunctions;
+
+        inline static constexpr uint32_t kSnapshotMagic = 0x534B5242; // "BRKS"
+        inline static constexpr uint32_t kSnapshotVersion = 2;
+        inline static constexpr size_t kSnapshotFlushSize = 64 * 1024;
+
     public:
 
         explicit GameEntityManager(CoreSystems* pCoreManager);
@@ -46,21 +86,78 @@ namespace Brokkr
 
         // Create Object Creation / Deletion 
         ///////////////////////////////////////////
+        // The entity is usable right away. While deferring it only joins the manager (updates, GetEntityById,
+        // the activity region) at FlushCommands, so nothing iterating the entities sees the list grow
         GameEntity* GetNextEntityAvailable();
 
+        // Deletes right away, unless the entities are being iterated then it is deferred to FlushCommands
         void DeleteEntity(int entityID);
 
+        // Components added to or removed from a live entity, deferred like DeleteEntity. Adding Inits the
+        // component, both keep the render list up to date. Returns nullptr when deferred
+        template<typename ComponentType, typename... Args>
+        ComponentType* AddComponent(GameEntity* pEntity, Args&&... args);
+
+        template<typename ComponentType>
+        void RemoveComponent(GameEntity* pEntity);
+
+        // Deferred Structural Changes
+        ///////////////////////////////////////////
+        [[nodiscard]] EntityCommandBuffer& GetCommandBuffer() { return m_commandBuffer; }
+
+        // Sync point: applies every recorded spawn / destroy / component change
+        void FlushCommands();
+
+        // True while structural changes are being recorded instead of applied
+        [[nodiscard]] bool IsDeferring() const { return m_deferDepth > 0; }
+
+        // Set as the EventManager's dispatch scope by Init, handlers never change entities under a dispatch
+        static void OnEventDispatch(void* pContext, bool isDispatching);
+
+        // Activity Region
+        ///////////////////////////////////////////
+        void SetActivityRegion(const Vector2<float>& focus, float radius);
+        // Region follows the entity's transform, cleared if the entity is deleted
+        void SetActivityRegion(GameEntity* pFocusEntity, float radius);
+        void ClearActivityRegion();
+
+        // Suspends entities that left the region and resumes the ones that came back, called by UpdateEntities
+        void UpdateActivity();
+
+        [[nodiscard]] size_t GetActiveEntityCount() const { return m_activeCount; }
+        [[nodiscard]] size_t GetEntityCount() const { return m_entities.size(); }
+
         // Object Update Components
         ///////////////////////////////////////////
-        void UpdateEntities() const;
+        void UpdateEntities();
         void LateUpdateEntities();
 
+        [[nodiscard]] TransformHierarchy& GetTransformHierarchy() { return m_transformHierarchy; }
+
         // Object Rendering
         ///////////////////////////////////////////
         void RenderEntities() const;
+        [[nodiscard]] size_t GetRenderComponentCount() const { return m_pRenderComponents.size(); }
 
         GameEntity* GetEntityById(int entityID);
+
+        // Name & Tag Index
+        ///////////////////////////////////////////
+        GameEntity::NameID InternName(const std::string& name);
+        [[nodiscard]] GameEntity::NameID FindNameID(const std::string& name) const;
+
+        void SetEntityName(GameEntity* pEntity, const std::string& name);
+        void AddEntityTag(GameEntity* pEntity, const std::string& tag);
+        void RemoveEntityTag(GameEntity* pEntity, const std::string& tag);
+
         GameEntity* GetEntityByName(const std::string& name) const;
+        GameEntity* GetEntityByName(GameEntity::NameID nameId) const;
+
+        // All entities sharing a name (every instance of a prefab) or a tag
+        [[nodiscard]] const std::vector<GameEntity*>& GetEntitiesByName(const std::string& name) const;
+        [[nodiscard]] const std::vector<GameEntity*>& GetEntitiesByName(GameEntity::NameID nameId) const;
+        [[nodiscard]] const std::vector<GameEntity*>& GetEntitiesByTag(const std::string& tag) const;
+        [[nodiscard]] const std::vector<GameEntity*>& GetEntitiesByTag(GameEntity::NameID tagId) const;
 
         std::vector<GameEntity*> GetEntitiesInArea(const Rectangle<float>& area);
 
@@ -68,9 +165,99 @@ namespace Brokkr
         ///////////////////////////////////////////
         std::list<GameEntity*> ConstructWithLocation(const char* prefabName, const char* prefabFileName, const char* mapFileName);
         GameEntity* Construct(const char* prefabName, const char* fileName);
+        GameEntity* Construct(const char* prefabName, const char* fileName, const Vector2<float>& position);
+
+        // World Snapshots
+        ///////////////////////////////////////////
+        void RegisterSnapshotCreationFunction(uint32_t snapshotId, SnapshotCreationFunction creationFunction);
+
+        // Writes every entity, its name, tags and snapshot components, then the transform parent links
+        void WriteSnapshot(BinaryWriter& writer) const;
+        bool SaveSnapshot(const char* filePath) const;
+
+        // Replaces the current world with the one in the snapshot, entities keep their saved ids
+        bool ReadSnapshot(BinaryReader& reader);
+        bool LoadSnapshot(const char* filePath);
 
         void ClearEntities();
+        virtual void RegisterStages(FrameScheduler& scheduler) override;
         virtual void Destroy() override;
         virtual ~GameEntityManager() override;
+
+    private:
+        friend EntityCommandBuffer;
+
+        void AddEntity(GameEntity* pEntity);
+        void SwapEntities(size_t left, size_t right);
+        void SuspendEntity(size_t index);
+        void ResumeEntity(size_t index);
+        [[nodiscard]] static bool IsInRange(const GameEntity* pEntity, const Vector2<float>& focus, float radius);
+        static void RefreshActivityComponents(GameEntity* pEntity);
+
+        GameEntity* BuildEntity(const char* prefabName, const char* fileName);
+        void FinishConstruct(GameEntity* pEntity);
+        void TrackRenderComponent(Component* pComponent);
+        void UntrackRenderComponent(const Component* pComponent);
+        void UnindexEntity(const GameEntity* pEntity);
+        void RemoveFromNameBucket(const GameEntity* pEntity);
+        void RemoveFromTagBucket(const GameEntity* pEntity, size_t tagIndex);
     };
+
+    template <typename ComponentType, typename ... Args>
+    ComponentType* GameEntityManager::AddComponent(GameEntity* pEntity, Args&&... args)
+    {
+        if (IsDeferring())
+        {
+            m_commandBuffer.AddComponent<ComponentType>(pEntity->GetId(), std::forward<Args>(args)...);
+            return nullptr;
+        }
+
+        // The entity is already live so the new component has to Init itself
+        ComponentType* pComponent = pEntity->AddComponent<ComponentType>(std::forward<Args>(args)...);
+        if (pComponent)
+        {
+            pComponent->Init();
+            TrackRenderComponent(pComponent);
+        }
+        return pComponent;
+    }
+
+    template <typename ComponentType>
+    void GameEntityManager::RemoveComponent(GameEntity* pEntity)
+    {
+        if (IsDeferring())
+        {
+            m_commandBuffer.RemoveComponent<ComponentType>(pEntity->GetId());
+            return;
+        }
+
+        // The same component GameEntity::RemoveComponent finds, off the render list before it is freed
+        if (const ComponentType* pComponent = pEntity->GetComponent<ComponentType>())
+        {
+            UntrackRenderComponent(pComponent);
+            pEntity->RemoveComponent<ComponentType>();
+        }
+    }
+
+    // Declared in EntityCommandBuffer.h, they need the whole GameEntityManager
+    template <typename ComponentType, typename ... Args>
+    void EntityCommandBuffer::AddComponent(int entityId, Args&&... args)
+    {
+        RecordComponentChange(entityId, [arguments = std::make_tuple(std::forward<Args>(args)...)](GameEntityManager* pEntityManager, GameEntity* pEntity) mutable
+        {
+            std::apply([pEntityManager, pEntity](auto&&... unpacked)
+            {
+                pEntityManager->AddComponent<ComponentType>(pEntity, std::forward<decltype(unpacked)>(unpacked)...);
+            }, std::move(arguments));
+        });
+    }
+
+    template <typename ComponentType>
+    void EntityCommandBuffer::RemoveComponent(int entityId)
+    {
+        RecordComponentChange(entityId, [](GameEntityManager* pEntityManager, GameEntity* pEntity)
+        {
+            pEntityManager->RemoveComponent<ComponentType>(pEntity);
+        });
+    }
 }
@@ -0,0 +1,118 @@
+#include "ConcurrentEventQueue.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Fills the ring slots before any real event is written to them
+    constexpr Brokkr::Event::EventType kEmptyType("None", Brokkr::Event::kPriorityMin);
+}
+
+thread_local Brokkr::ConcurrentEventQueue::ThreadCache Brokkr::ConcurrentEventQueue::t_cache;
+
+Brokkr::ConcurrentEventQueue::Producer::Producer(std::thread::id threadId, uint32_t key)
+    : m_threadId(threadId)
+    , m_key(key)
+    , m_ring(kRingCapacity, Entry{ Event(kEmptyType), 0 })
+{
+    static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "kRingCapacity must be a power of two");
+}
+
+bool Brokkr::ConcurrentEventQueue::RegisterProducer(uint32_t key)
+{
+    std::lock_guard lock(m_producerLock);
+    if (FindProducer(std::this_thread::get_id()) != nullptr)
+    {
+        return false;
+    }
+
+    t_cache.m_pProducer = AddProducer(key);
+    t_cache.m_queueId = m_queueId;
+    return true;
+}
+
+void Brokkr::ConcurrentEventQueue::Push(const Event& event)
+{
+    Producer* pProducer = GetProducer();
+    const uint64_t sequence = pProducer->m_nextSequence++;
+
+    const size_t tail = pProducer->m_tail.load(std::memory_order_relaxed);
+    if (tail - pProducer->m_head.load(std::memory_order_acquire) < kRingCapacity)
+    {
+        Entry& entry = pProducer->m_ring[tail & (kRingCapacity - 1)];
+        entry.m_event = event;
+        entry.m_sequence = sequence;
+        pProducer->m_tail.store(tail + 1, std::memory_order_release);
+        return;
+    }
+
+    // Ring is full, the consumer is behind. Spill rather than block.
+    std::lock_guard lock(pProducer->m_overflowLock);
+    pProducer->m_overflow.push_back({ event, sequence });
+}
+
+size_t Brokkr::ConcurrentEventQueue::Drain(EventQueue& queue)
+{
+    return Drain([&queue](const Event& event) { queue.Push(event); });
+}
+
+void Brokkr::ConcurrentEventQueue::Clear()
+{
+    std::lock_guard lock(m_producerLock);
+    for (const auto& pProducer : m_producers)
+    {
+        DrainProducer(*pProducer, [](const Event&) {});
+    }
+}
+
+size_t Brokkr::ConcurrentEventQueue::GetProducerCount()
+{
+    std::lock_guard lock(m_producerLock);
+    return m_producers.size();
+}
+
+Brokkr::ConcurrentEventQueue::Producer* Brokkr::ConcurrentEventQueue::GetProducer()
+{
+    if (t_cache.m_queueId == m_queueId)
+    {
+        return t_cache.m_pProducer;
+    }
+
+    // The thread last pushed to another queue, or never pushed at all
+    std::lock_guard lock(m_producerLock);
+    Producer* pProducer = FindProducer(std::this_thread::get_id());
+    if (pProducer == nullptr)
+    {
+        pProducer = AddProducer(kAutoKeyBase + m_autoKeyCount++);
+    }
+
+    t_cache.m_pProducer = pProducer;
+    t_cache.m_queueId = m_queueId;
+    return pProducer;
+}
+
+Brokkr::ConcurrentEventQueue::Producer* Brokkr::ConcurrentEventQueue::FindProducer(std::thread::id threadId) const
+{
+    for (const auto& pProducer : m_producers)
+    {
+        if (pProducer->m_threadId == threadId)
+        {
+            return pProducer.get();
+        }
+    }
+
+    return nullptr;
+}
+
+Brokkr::ConcurrentEventQueue::Producer* Brokkr::ConcurrentEventQueue::AddProducer(uint32_t key)
+{
+    auto pProducer = std::make_unique<Producer>(std::this_thread::get_id(), key);
+    Producer* pResult = pProducer.get();
+
+    // Stable on equal keys so duplicates still merge in registration order
+    const auto where = std::upper_bound(m_producers.begin(), m_producers.end(), key,
+        [](uint32_t value, const std::unique_ptr<Producer>& pOther) { return value < pOther->m_key; });
+    m_producers.insert(where, std::move(pProducer));
+
+    return pResult;
+}
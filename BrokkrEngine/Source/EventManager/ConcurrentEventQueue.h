@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Event/Event.h"
+#include "EventQueue.h"
+
+namespace Brokkr
+{
+    // Ingestion path for events pushed from threads other than the one running ProcessEvents.
+    //
+    // Every producer thread gets its own single producer / single consumer ring so pushing is lock free and
+    // producers never touch each other's memory. A push into a full ring goes to that producer's overflow list
+    // behind a mutex, only the consumer ever contends for it and only while draining.
+    //
+    // Drain() moves everything into an EventQueue, producer by producer in key order and each producer's events
+    // in the order it pushed them. With keys set through RegisterProducer (a worker index for example) the merged
+    // order only depends on which events made it in before the drain, not on how the threads were scheduled.
+    //
+    // Events pushed here must carry their payload inline, the EventManager's payload arena is not thread safe.
+    class ConcurrentEventQueue
+    {
+    public:
+        // Per producer ring size, must be a power of two
+        inline static constexpr size_t kRingCapacity = 1024;
+
+        // Threads that never registered get a key past this, in the order they first pushed
+        inline static constexpr uint32_t kAutoKeyBase = 0x80000000;
+
+    private:
+        struct Entry
+        {
+            Event m_event;
+            uint64_t m_sequence;
+        };
+
+        struct Producer
+        {
+            std::thread::id m_threadId;
+            uint32_t m_key = 0;
+
+            std::vector<Entry> m_ring;
+
+            // Producer owns the tail, consumer owns the head. Kept on separate cache lines.
+            alignas(64) std::atomic<size_t> m_head{ 0 };
+            alignas(64) std::atomic<size_t> m_tail{ 0 };
+
+            // Only touched by the producer
+            uint64_t m_nextSequence = 0;
+
+            std::mutex m_overflowLock;
+            std::vector<Entry> m_overflow;
+
+            Producer(std::thread::id threadId, uint32_t key);
+        };
+
+        // Last producer used by this thread, checked against the queue id so a dead queue's producer is never reused
+        struct ThreadCache
+        {
+            uint64_t m_queueId = 0;
+            Producer* m_pProducer = nullptr;
+        };
+
+        inline static std::atomic<uint64_t> s_nextQueueId{ 1 };
+        static thread_local ThreadCache t_cache;
+
+        const uint64_t m_queueId;
+
+        // Sorted by key, only locked when a thread registers and while draining
+        std::mutex m_producerLock;
+        std::vector<std::unique_ptr<Producer>> m_producers;
+        uint32_t m_autoKeyCount = 0;
+
+        // Consumer side scratch, kept so a warmed up drain does not allocate
+        std::vector<Entry> m_drainOverflow;
+
+    public:
+        ConcurrentEventQueue() : m_queueId(s_nextQueueId.fetch_add(1, std::memory_order_relaxed)) { }
+
+        ConcurrentEventQueue(const ConcurrentEventQueue&) = delete;
+        ConcurrentEventQueue& operator=(const ConcurrentEventQueue&) = delete;
+
+        // Gives the calling thread a fixed merge key, call before its first Push.
+        // Keys should be unique per thread, returns false if the thread is already registered.
+        bool RegisterProducer(uint32_t key);
+
+        // Safe from any number of threads at once
+        void Push(const Event& event);
+
+        // Consumer only. Moves every event pushed so far into the queue, returns how many were moved.
+        size_t Drain(EventQueue& queue);
+
+        // Consumer only. Same as above but hands each event to a callback (void(const Event&)) instead.
+        template <typename Callback>
+        size_t Drain(Callback&& callback);
+
+        // Consumer only. Throws away everything pushed so far.
+        void Clear();
+
+        [[nodiscard]] size_t GetProducerCount();
+
+    private:
+        Producer* GetProducer();
+        // Both expect m_producerLock to be held
+        [[nodiscard]] Producer* FindProducer(std::thread::id threadId) const;
+        Producer* AddProducer(uint32_t key);
+        template <typename Callback>
+        void DrainProducer(Producer& producer, Callback&& callback);
+    };
+
+    template <typename Callback>
+    size_t ConcurrentEventQueue::Drain(Callback&& callback)
+    {
+        size_t count = 0;
+
+        std::lock_guard lock(m_producerLock);
+        for (const auto& pProducer : m_producers)
+        {
+            DrainProducer(*pProducer, [&callback, &count](const Event& event)
+            {
+                callback(event);
+                ++count;
+            });
+        }
+
+        return count;
+    }
+
+    template <typename Callback>
+    void ConcurrentEventQueue::DrainProducer(Producer& producer, Callback&& callback)
+    {
+        // Overflow first, then the ring. A producer only spills while its ring is full and the ring only gets
+        // room again once the head below moves, so nothing left behind can be older than what is taken here.
+        m_drainOverflow.clear();
+        {
+            std::lock_guard lock(producer.m_overflowLock);
+            m_drainOverflow.swap(producer.m_overflow);
+        }
+
+        size_t head = producer.m_head.load(std::memory_order_relaxed);
+        const size_t tail = producer.m_tail.load(std::memory_order_acquire);
+        size_t overflowIndex = 0;
+
+        // Both runs are already in push order, merge them on the sequence number
+        while (head != tail || overflowIndex < m_drainOverflow.size())
+        {
+            const Entry* pRingEntry = head != tail ? &producer.m_ring[head & (kRingCapacity - 1)] : nullptr;
+            const Entry* pOverflowEntry = overflowIndex < m_drainOverflow.size() ? &m_drainOverflow[overflowIndex] : nullptr;
+
+            if (pOverflowEntry == nullptr || (pRingEntry != nullptr && pRingEntry->m_sequence < pOverflowEntry->m_sequence))
+            {
+                callback(pRingEntry->m_event);
+                ++head;
+            }
+            else
+            {
+                callback(pOverflowEntry->m_event);
+                ++overflowIndex;
+            }
+        }
+
+        producer.m_head.store(head, std::memory_order_release);
+    }
+}
@@ -1,21 +1,19 @@
 #include "Event.h"
 #include <vector>
-#include "Utility/Hash.h"
+#include "Utility/StringID.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 // Event Type
 //////////////////////////////////////////////////////////////////////////////////////////////
 
-Brokkr::Event::EventType::EventType(const char* eventTypeName, const unsigned& priority)
-    : m_priority(priority)
-    , m_eventTypeName(eventTypeName)
+uint32_t Brokkr::Event::EventType::HashEventString(const char* eventTypeName)
 {
-    m_typeName = Hash::Murmur3Hash(eventTypeName, std::strlen(eventTypeName), s_kHashSeed);
+    return StringID::FromString(eventTypeName).GetHash();
 }
 
-uint32_t Brokkr::Event::EventType::HashEventString(const char* eventTypeName)
+void Brokkr::Event::EventType::RegisterName() const
 {
-    return Hash::Murmur3Hash(eventTypeName, std::strlen(eventTypeName), s_kHashSeed);
+    StringID::Register(m_typeName, m_eventTypeName);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -26,3 +24,9 @@ Brokkr::Event::Event(const EventType& type)
     :m_event(type)
     , m_type(type.GetTypeHash())
 {}
+
+Brokkr::Event::Event(const EventType& type, int targetId)
+    : m_event(type)
+    , m_type(type.GetTypeHash())
+    , m_target(targetId)
+{}
@@ -1,8 +1,13 @@
 #pragma once
-#include <memory>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
 
 #include "PayloadComponent/PayloadComponent.h"
+#include "Utility/FrameArena.h"
+#include "Utility/StringID.h"
+#include "Utility/TypeID.h"
 
 namespace Brokkr
 {
@@ -17,21 +22,31 @@ namespace Brokkr
         inline static constexpr unsigned int kPriorityHigh = 900;
         inline static constexpr unsigned int kPriorityMax = 429496729;
 
+        // Events without a target go to every handler of their type
+        inline static constexpr int kNoTarget = -1;
+
+        // Hashed at compile time when built from a literal, keep the static ones constexpr
         class EventType
         {
-            inline static constexpr uint32_t s_kHashSeed = 1;
             unsigned int m_priority;
             const char* m_eventTypeName;
             uint32_t m_typeName;
 
         public:
-            EventType(const char* eventTypeName, const unsigned int& priority);
+            constexpr EventType(const char* eventTypeName, const unsigned int& priority)
+                : m_priority(priority)
+                , m_eventTypeName(eventTypeName)
+                , m_typeName(StringID(eventTypeName, Hash::StringLength(eventTypeName)).GetHash())
+            {}
 
-            [[nodiscard]] unsigned int GetPriorityLevel() const { return m_priority; }
-            [[nodiscard]] uint32_t GetTypeHash() const { return m_typeName; }
-            [[nodiscard]] const char* ToString() const { return m_eventTypeName; }
+            [[nodiscard]] constexpr unsigned int GetPriorityLevel() const { return m_priority; }
+            [[nodiscard]] constexpr uint32_t GetTypeHash() const { return m_typeName; }
+            [[nodiscard]] constexpr const char* ToString() const { return m_eventTypeName; }
 
             static uint32_t HashEventString(const char* eventTypeName);
+
+            // Once per type, adds a compile time hashed name to StringID's reverse table (see BROKKR_STRING_ID_NAMES)
+            void RegisterName() const;
         };
 
     private:
@@ -39,11 +54,24 @@ namespace Brokkr
         EventType m_event;
         uint32_t m_type;
 
-        // Components representing different aspects of the event data
-        std::vector<std::shared_ptr<PayloadComponent>> m_pComponents;
+        // Entity this event is addressed to, its entity local handlers run along with the broadcast ones
+        int m_target = kNoTarget;
+
+    public:
+        // Payloads up to this size live inside the event, bigger ones go in a FrameArena (AddLargeComponent)
+        inline static constexpr size_t kPayloadCapacity = 48;
+        inline static constexpr size_t kPayloadAlignment = alignof(std::max_align_t);
+
+    private:
+        // The event's payload, stored inline so pushing an event never allocates.
+        // Holds the payload itself, or a pointer to it when it was placed in an arena.
+        alignas(kPayloadAlignment) std::byte m_payload[kPayloadCapacity];
+        TypeIndex m_payloadType = TypeID::kInvalid;
+        bool m_isPayloadExternal = false;
 
     public:
         Event(const EventType& type);
+        Event(const EventType& type, int targetId);
 
         Event(const Event& other) = default;
         Event(Event&& other) noexcept = default;
@@ -55,52 +83,72 @@ namespace Brokkr
         [[nodiscard]] uint32_t GetPriorityLevel() const { return m_event.GetPriorityLevel(); }
         [[nodiscard]] uint32_t GetType() const { return m_type; }
         [[nodiscard]] EventType GetEvent() const { return m_event; }
+        [[nodiscard]] int GetTarget() const { return m_target; }
+        void SetTarget(int targetId) { m_target = targetId; }
 
-        // Add a component to the event
+        // Set the event's payload, one per event and adding again replaces it.
+        // Payloads must be trivially copyable since events are copied around by value.
         template <typename ComponentType, typename ... Args>
         ComponentType* AddComponent(Args&&... args);
 
-        // Get a component to the event
+        // Payload too big for the inline buffer, built in the arena which must outlive the event
+        template <typename ComponentType, typename ... Args>
+        ComponentType* AddLargeComponent(FrameArena& arena, Args&&... args);
+
+        // Get the payload if it is of this type, nullptr otherwise
         template <typename ComponentType>
         [[nodiscard]] ComponentType* GetComponent() const;
 
-        void ClearPayloads() { m_pComponents.clear(); }
+        void ClearPayloads() { m_payloadType = TypeID::kInvalid; m_isPayloadExternal = false; }
 
     };
 
     template <typename ComponentType, typename ... Args>
     ComponentType* Event::AddComponent(Args&&... args)
     {
-        // Create a instance of the component type
-        std::shared_ptr<ComponentType> newComponent = std::make_shared<ComponentType>(this, std::forward<Args>(args)...);
+        static_assert(std::is_base_of_v<PayloadComponent, ComponentType>, "Event payloads derive from PayloadComponent");
+        static_assert(std::is_trivially_copyable_v<ComponentType>, "Event payloads are copied with the event, keep them trivially copyable");
+        static_assert(sizeof(ComponentType) <= kPayloadCapacity, "Payload does not fit inline, use AddLargeComponent");
+        static_assert(alignof(ComponentType) <= kPayloadAlignment, "Payload is over aligned for the inline buffer");
+
+        // Build the payload in place
+        ComponentType* result = new (m_payload) ComponentType(std::forward<Args>(args)...);
+        m_payloadType = TypeID::Get<ComponentType>();
+        m_isPayloadExternal = false;
 
-        // Get a raw pointer to the component
-        ComponentType* result = newComponent.get();
+        return result;
+    }
+
+    template <typename ComponentType, typename ... Args>
+    ComponentType* Event::AddLargeComponent(FrameArena& arena, Args&&... args)
+    {
+        static_assert(std::is_base_of_v<PayloadComponent, ComponentType>, "Event payloads derive from PayloadComponent");
 
-        // Add the component to the vector
-        m_pComponents.emplace_back(std::move(newComponent));
+        // Only the pointer is stored inline
+        ComponentType* result = arena.Create<ComponentType>(std::forward<Args>(args)...);
+        new (m_payload) ComponentType*(result);
+        m_payloadType = TypeID::Get<ComponentType>();
+        m_isPayloadExternal = true;
 
-        // Return a pointer
         return result;
     }
 
     template <typename ComponentType>
     ComponentType* Event::GetComponent() const
     {
-        // Iterate through all components in the vector
-        for (auto& component : m_pComponents)
+        // A type check on an index, no dynamic_cast
+        if (m_payloadType != TypeID::Get<ComponentType>())
+        {
+            return nullptr;
+        }
+
+        void* pPayload = const_cast<std::byte*>(m_payload);
+
+        if (m_isPayloadExternal)
         {
-            // Attempt to dynamically cast the component to the specified type
-            ComponentType* target = dynamic_cast<ComponentType*>(component.get());
-
-            // If the cast is successful
-            if (target)
-            {
-                return target;
-            }
+            return *static_cast<ComponentType**>(pPayload);
         }
 
-        // If no component of type is found
-        return nullptr;
+        return std::launder(static_cast<ComponentType*>(pPayload));
     }
 }
@@ -1,6 +1,6 @@
 #include "CollisionPayload.h"
 
-const char* Brokkr::CollisionPayload::ToString()
+const char* Brokkr::CollisionPayload::ToString() const
 {
     return "CollisionPayloadComponent";
 }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 
 #include <Vector2.h>
 #include "Rectangle.h"
@@ -15,24 +15,28 @@ namespace Brokkr
         using EntityID = int;
 
         Collider* m_ObjectMoving;
-        std::vector<EntityID> m_objectsHit;
+
+        // Ids live in the EventManager's payload arena, valid until the end of ProcessEvents
+        const EntityID* m_pObjectsHit;
+        uint32_t m_hitCount;
         Vector2<float> m_displacementVector;
 
     public:
-        explicit CollisionPayload(Event* pOwner, Collider* movingObject, const std::vector<EntityID>& objectsHit, const Vector2<float>& displacementVector) // i want to copy the list of ids
-            : PayloadComponent(pOwner)
-            , m_ObjectMoving(movingObject)
-            , m_objectsHit(objectsHit)
+        CollisionPayload(Collider* movingObject, const EntityID* pObjectsHit, uint32_t hitCount, const Vector2<float>& displacementVector)
+            : m_ObjectMoving(movingObject)
+            , m_pObjectsHit(pObjectsHit)
+            , m_hitCount(hitCount)
             , m_displacementVector(displacementVector)
         {
             //
         }
 
-        [[nodiscard]] std::vector<EntityID> GetObjectHit() const { return m_objectsHit; }
+        [[nodiscard]] const EntityID* GetObjectsHit() const { return m_pObjectsHit; }
+        [[nodiscard]] uint32_t GetHitCount() const { return m_hitCount; }
         [[nodiscard]] Collider* GetObjectMoving() const { return m_ObjectMoving; }
         [[nodiscard]] Vector2<float> GetMovingObjectsDisplacement() const { return m_displacementVector; }
 
-        virtual const char* ToString() override;
+        const char* ToString() const;
     };
 
 }
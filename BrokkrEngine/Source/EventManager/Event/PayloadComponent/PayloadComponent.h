@@ -3,59 +3,44 @@
 
 namespace Brokkr
 {
-    class Event;
-
+    // Base for event payloads. Payloads are stored inline in the Event and copied with it, so they are
+    // plain data: no virtuals, no owning members. Variable sized data (lists of ids) goes in the
+    // EventManager's payload arena and the payload keeps a pointer and a count.
     class PayloadComponent
     {
-
-    public:
-        explicit PayloadComponent(Event* pOwner)
-            : m_pOwner(pOwner)
-        {
-            //
-        }
-
-        virtual ~PayloadComponent() = default;
-        virtual const char* ToString() = 0;
-
     protected:
-        Event* m_pOwner = nullptr;
+        PayloadComponent() = default;
     };
 
     class RadioMessagePayload final : public PayloadComponent
     {
         int m_sendersID;
     public:
-        RadioMessagePayload(Event* pOwner, int SendingID)
-            : PayloadComponent(pOwner)
-            , m_sendersID(SendingID)
+        explicit RadioMessagePayload(int SendingID)
+            : m_sendersID(SendingID)
         {
 
         }
 
         int GetSender() const { return m_sendersID; }
 
-        virtual const char* ToString() override;
+        const char* ToString() const;
     };
 
     class PayloadTest final : public PayloadComponent
     {
     public:
-        PayloadTest(Event* pOwner)
-            : PayloadComponent(pOwner)
-        {
-
-        }
+        PayloadTest() = default;
 
-        virtual const char* ToString() override;
+        const char* ToString() const;
     };
 
-    inline const char* RadioMessagePayload::ToString()
+    inline const char* RadioMessagePayload::ToString() const
     {
         return "RadioMessagePayload\n";
     }
 
-    inline const char* PayloadTest::ToString()
+    inline const char* PayloadTest::ToString() const
     {
         return "Event Payload Test\n";
     }
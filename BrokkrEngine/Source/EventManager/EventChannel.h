@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////
+//          Event Channel
+//
+// Typed path for high frequency events. A channel is a contiguous array of one plain struct: producers append
+// to it during the frame, and at the start of ProcessEvents the batch is handed to every subscriber in one call.
+// No Event objects, no type erased payloads, no per event handler lookups, and the arrays keep their capacity
+// so a warmed up channel never allocates.
+//
+//  Example Use:
+//
+//      struct PositionChanged { int m_entityId; Vector2<float> m_position; };
+//
+//      auto& channel = pEventManager->GetChannel<PositionChanged>();
+//      channel.Push({ id, position });
+//
+//      m_subscription = channel.Subscribe<Minimap, &Minimap::OnPositionsChanged>(this);
+//      void Minimap::OnPositionsChanged(const PositionChanged* pEvents, size_t count) { ... }
+//
+// Events pushed while a batch is delivered go out with the next one. Main thread only.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    // Type erased part so the EventManager can keep channels of every type in one list
+    class EventChannelBase
+    {
+    public:
+        virtual ~EventChannelBase() = default;
+
+        virtual void Deliver() = 0;
+        virtual void Clear() = 0;
+    };
+
+    template <typename EventStruct>
+    class EventChannel final : public EventChannelBase
+    {
+        static_assert(std::is_trivially_copyable_v<EventStruct>, "Channel events are plain structs, keep them trivially copyable");
+
+    public:
+        using BatchStub = void(*)(void* pContext, const EventStruct* pEvents, size_t count);
+
+        inline static constexpr uint32_t kInvalidSubscription = 0;
+
+    private:
+        struct Subscriber
+        {
+            BatchStub m_pStub = nullptr;
+            void* m_pContext = nullptr;
+            uint32_t m_id = kInvalidSubscription;
+        };
+
+        // Filled this frame, swapped out on Deliver
+        std::vector<EventStruct> m_pending;
+
+        // The last batch, readable until the next Deliver
+        std::vector<EventStruct> m_delivered;
+
+        std::vector<Subscriber> m_subscribers;
+        uint32_t m_nextId = 1;
+        bool m_hasRemoved = false;
+
+    public:
+        void Push(const EventStruct& event) { m_pending.push_back(event); }
+
+        template <typename ... Args>
+        EventStruct& Emplace(Args&&... args) { return m_pending.emplace_back(EventStruct{ std::forward<Args>(args)... }); }
+
+        template <typename Type, void(Type::*Method)(const EventStruct*, size_t)>
+        uint32_t Subscribe(Type* pInstance)
+        {
+            return Subscribe([](void* pContext, const EventStruct* pEvents, size_t count) { (static_cast<Type*>(pContext)->*Method)(pEvents, count); }, pInstance);
+        }
+
+        template <void(*Function)(const EventStruct*, size_t)>
+        uint32_t Subscribe()
+        {
+            return Subscribe([](void*, const EventStruct* pEvents, size_t count) { Function(pEvents, count); }, nullptr);
+        }
+
+        uint32_t Subscribe(BatchStub pCallback, void* pContext)
+        {
+            m_subscribers.push_back({ pCallback, pContext, m_nextId });
+            return m_nextId++;
+        }
+
+        // Safe from inside a subscriber
+        void Unsubscribe(uint32_t subscription);
+
+        virtual void Deliver() override;
+        virtual void Clear() override;
+
+        [[nodiscard]] const EventStruct* GetDelivered() const { return m_delivered.data(); }
+        [[nodiscard]] size_t GetDeliveredCount() const { return m_delivered.size(); }
+        [[nodiscard]] size_t GetPendingCount() const { return m_pending.size(); }
+    };
+
+    template <typename EventStruct>
+    void EventChannel<EventStruct>::Unsubscribe(uint32_t subscription)
+    {
+        for (auto& subscriber : m_subscribers)
+        {
+            if (subscriber.m_id == subscription)
+            {
+                // Dropped from the array after the current delivery, if there is one
+                subscriber.m_pStub = nullptr;
+                m_hasRemoved = true;
+                return;
+            }
+        }
+    }
+
+    template <typename EventStruct>
+    void EventChannel<EventStruct>::Deliver()
+    {
+        m_delivered.swap(m_pending);
+        m_pending.clear();
+
+        if (!m_delivered.empty())
+        {
+            // By index with the count taken up front, subscribers added during the delivery wait for the next batch
+            const size_t subscriberCount = m_subscribers.size();
+            for (size_t i = 0; i < subscriberCount; ++i)
+            {
+                const Subscriber subscriber = m_subscribers[i];
+                if (subscriber.m_pStub != nullptr)
+                {
+                    subscriber.m_pStub(subscriber.m_pContext, m_delivered.data(), m_delivered.size());
+                }
+            }
+        }
+
+        if (m_hasRemoved)
+        {
+            m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(), [](const Subscriber& subscriber)
+            {
+                return subscriber.m_pStub == nullptr;
+            }), m_subscribers.end());
+            m_hasRemoved = false;
+        }
+    }
+
+    template <typename EventStruct>
+    void EventChannel<EventStruct>::Clear()
+    {
+        m_pending.clear();
+        m_delivered.clear();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+
+namespace Brokkr
+{
+    class Event;
+
+    // Lightweight handler: a plain function pointer plus a context pointer, two words and no allocation.
+    // Member functions are bound at compile time so calling one is a single indirect call.
+    //
+    //      m_subscription = pEventManager->AddHandler("Jump", Event::kPriorityNormal,
+    //          EventDelegate::FromMethod<Player, &Player::OnJump>(this));
+    //
+    class EventDelegate
+    {
+        using Stub = void(*)(void* pContext, const Event& event);
+
+        void* m_pContext = nullptr;
+        Stub m_pStub = nullptr;
+
+        EventDelegate(void* pContext, Stub pStub) : m_pContext(pContext), m_pStub(pStub) {}
+
+    public:
+        EventDelegate() = default;
+
+        template <void(*Function)(const Event&)>
+        static EventDelegate FromFunction()
+        {
+            return { nullptr, [](void*, const Event& event) { Function(event); } };
+        }
+
+        template <typename Type, void(Type::*Method)(const Event&)>
+        static EventDelegate FromMethod(Type* pInstance)
+        {
+            return { pInstance, [](void* pContext, const Event& event) { (static_cast<Type*>(pContext)->*Method)(event); } };
+        }
+
+        // Raw callback with a user context
+        static EventDelegate FromCallback(Stub pCallback, void* pContext) { return { pContext, pCallback }; }
+
+        void operator()(const Event& event) const { m_pStub(m_pContext, event); }
+
+        [[nodiscard]] explicit operator bool() const { return m_pStub != nullptr; }
+    };
+
+    // What a handler promises about itself, lets the EventManager run it off the main thread.
+    // Handlers without flags always run on the main thread one event at a time.
+    struct HandlerFlags
+    {
+        inline static constexpr uint32_t kSerial = 0;
+
+        // Safe to run on a worker at the same time as any other handler
+        inline static constexpr uint32_t kThreadSafe = 1 << 0;
+
+        // Only touches the entity the event targets, events for other entities can run alongside it
+        inline static constexpr uint32_t kEntityLocal = 1 << 1;
+    };
+
+    // Token returned by EventManager::AddHandler, RemoveHandler with it is O(1).
+    // The generation makes stale tokens harmless once their slot is reused.
+    struct EventSubscription
+    {
+        inline static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+        uint32_t m_index = kInvalidIndex;
+        uint32_t m_generation = 0;
+
+        [[nodiscard]] bool IsValid() const { return m_index != kInvalidIndex; }
+    };
+}
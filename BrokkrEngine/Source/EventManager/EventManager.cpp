@@ -1,104 +1,677 @@
 #include "EventManager.h"
 
-bool Brokkr::EventManager::EventHandlerComparer::operator()(const EventHandler& left, const EventHandler& right) const
+#include <algorithm>
+#include <chrono>
+
+#include "Core/EngineDefinitions.h"
+#include "Profiler/Profiler.h"
+
+Brokkr::EventSubscription Brokkr::EventManager::AddHandler(const char* eventTypeString, int priority, EventDelegate delegate, uint32_t flags)
+{
+    return AddHandler(Event::EventType::HashEventString(eventTypeString), priority, delegate, flags);
+}
+
+Brokkr::EventSubscription Brokkr::EventManager::AddHandler(uint32_t eventHash, int priority, EventDelegate delegate, uint32_t flags)
+{
+    return AddEntry(eventHash, Event::kNoTarget, priority, delegate, flags, nullptr);
+}
+
+Brokkr::EventSubscription Brokkr::EventManager::AddHandler(const char* eventTypeString, int targetId, int priority, EventDelegate delegate, uint32_t flags)
+{
+    return AddHandler(Event::EventType::HashEventString(eventTypeString), targetId, priority, delegate, flags);
+}
+
+Brokkr::EventSubscription Brokkr::EventManager::AddHandler(uint32_t eventHash, int targetId, int priority, EventDelegate delegate, uint32_t flags)
+{
+    return AddEntry(eventHash, targetId < 0 ? Event::kNoTarget : targetId, priority, delegate, flags, nullptr);
+}
+
+Brokkr::EventSubscription Brokkr::EventManager::AddHandler(const char* eventTypeString, const EventHandler& handler, uint32_t flags)
+{
+    return AddHandler(Event::EventType::HashEventString(eventTypeString), handler, flags);
+}
+
+Brokkr::EventSubscription Brokkr::EventManager::AddHandler(uint32_t eventHash, const EventHandler& handler, uint32_t flags)
+{
+    // Keep the std::function alive in the slot and call it through a delegate pointing at it
+    auto pOwned = std::make_unique<std::function<void(const Event&)>>(handler.second);
+    const auto delegate = EventDelegate::FromCallback([](void* pContext, const Event& event)
+    {
+        (*static_cast<std::function<void(const Event&)>*>(pContext))(event);
+    }, pOwned.get());
+
+    return AddEntry(eventHash, Event::kNoTarget, handler.first, delegate, flags, std::move(pOwned));
+}
+
+bool Brokkr::EventManager::RemoveHandler(EventSubscription subscription)
 {
-    // priority values of the handlers
-    if (left.first != right.first)
+    if (!subscription.IsValid() || subscription.m_index >= m_slots.size())
+    {
+        return false;
+    }
+
+    HandlerSlot& slot = m_slots[subscription.m_index];
+    if (!slot.m_inUse || slot.m_generation != subscription.m_generation)
+    {
+        return false;
+    }
+
+    // Bumping the generation kills the entry, it is skipped by dispatch until the array is compacted
+    ++slot.m_generation;
+    slot.m_inUse = false;
+    m_freeSlots.push_back(subscription.m_index);
+
+    // A handler may be removing itself, so its function is only freed once dispatch is done
+    if (slot.m_pOwnedFunction)
     {
-        // Handlers with higher priority values should come before handlers with lower priority values
-        return left.first > right.first;
+        if (m_isDispatching)
+        {
+            m_pendingFrees.push_back(std::move(slot.m_pOwnedFunction));
+        }
+        slot.m_pOwnedFunction.reset();
     }
 
-    // If priority values are equal, use target_type() comparison
-    return left.second.target_type().before(right.second.target_type());
-    // how this works :
-    // left.second.target_type().before(right.second.target_type()) is used to compare the std::type_info
-    // objects of the stored event handlers based on their names.
-    // This comparison determines the order in which the event handlers are stored in the eventHandlers
-    // container, with handlers whose types have "lower" names (lexicographically earlier)
-    // being stored first.
-    // Source : https://en.cppreference.com/w/cpp/types/type_info
-    //              &
-    //          https://stackoverflow.com/questions/53467813/comparing-two-type-info-from-typeid-operator
-    //      For debugging down the line (lexicographically earlier)
-    //      : simply means the name of the type comes first in alphabetical order
+    HandlerList* pList = FindList(slot.m_eventHash, slot.m_target);
+    if (pList == nullptr)
+    {
+        return true;
+    }
+
+    ++pList->m_deadCount;
+
+    // Compact once half the array is dead
+    if (pList->m_deadCount * 2 >= pList->m_entries.size())
+    {
+        if (m_isDispatching)
+        {
+            m_pendingCompacts.emplace_back(slot.m_eventHash, slot.m_target);
+        }
+        else
+        {
+            CompactList(slot.m_eventHash, slot.m_target);
+        }
+    }
+
+    return true;
 }
 
-bool Brokkr::EventManager::EventComparer::operator()(const Event& left, const Event& right) const
+Brokkr::EventSubscription Brokkr::EventManager::AddEntry(uint32_t eventHash, int target, int priority, EventDelegate delegate, uint32_t flags, std::unique_ptr<std::function<void(const Event&)>> pOwnedFunction)
 {
-    // Compare the priority levels of the events directly
-    return left.GetPriorityLevel() < right.GetPriorityLevel();
+    uint32_t slotIndex;
+    if (!m_freeSlots.empty())
+    {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    HandlerSlot& slot = m_slots[slotIndex];
+    slot.m_eventHash = eventHash;
+    slot.m_target = target;
+    slot.m_inUse = true;
+    slot.m_pOwnedFunction = std::move(pOwnedFunction);
+
+    const HandlerEntry entry{ delegate, priority, slotIndex, slot.m_generation, flags };
+
+    // Never grow an array that is being walked
+    if (m_isDispatching)
+    {
+        m_pendingAdds.push_back({ eventHash, target, entry });
+    }
+    else
+    {
+        InsertEntry(eventHash, target, entry);
+    }
+
+    return { slotIndex, slot.m_generation };
 }
 
-void Brokkr::EventManager::AddHandler(const char* eventTypeString, const EventHandler& handler)
+void Brokkr::EventManager::InsertEntry(uint32_t eventHash, int target, const HandlerEntry& entry)
 {
-    AddHandler(Event::EventType::HashEventString(eventTypeString), handler);
+    HandlerList* pList;
+    if (target == Event::kNoTarget)
+    {
+        pList = &m_handlers[eventHash];
+    }
+    else
+    {
+        // Entity ids are small and sequential, so the table grows to the largest id seen
+        auto& table = m_targetedHandlers[eventHash];
+        if (static_cast<size_t>(target) >= table.size())
+        {
+            table.resize(static_cast<size_t>(target) + 1);
+        }
+        pList = &table[target];
+    }
+
+    auto& entries = pList->m_entries;
+
+    // After every handler with the same or higher priority, so equal priorities keep their add order
+    const auto position = std::upper_bound(entries.begin(), entries.end(), entry.m_priority, [](int priority, const HandlerEntry& other)
+    {
+        return priority > other.m_priority;
+    });
+
+    entries.insert(position, entry);
+
+    if ((entry.m_flags & (HandlerFlags::kThreadSafe | HandlerFlags::kEntityLocal)) == 0)
+    {
+        ++pList->m_serialCount;
+    }
+    else if ((entry.m_flags & HandlerFlags::kThreadSafe) == 0)
+    {
+        ++pList->m_entityLocalCount;
+    }
+}
+
+Brokkr::EventManager::HandlerList* Brokkr::EventManager::FindList(uint32_t eventHash, int target)
+{
+    return const_cast<HandlerList*>(static_cast<const EventManager*>(this)->FindList(eventHash, target));
 }
 
-void Brokkr::EventManager::RemoveHandler(const char* eventTypeString, const EventHandler& handler)
+const Brokkr::EventManager::HandlerList* Brokkr::EventManager::FindList(uint32_t eventHash, int target) const
 {
-    RemoveHandler(Event::EventType::HashEventString(eventTypeString), handler);
+    if (target == Event::kNoTarget)
+    {
+        const auto it = m_handlers.find(eventHash);
+        return it != m_handlers.end() ? &it->second : nullptr;
+    }
+
+    const auto it = m_targetedHandlers.find(eventHash);
+    if (it == m_targetedHandlers.end() || static_cast<size_t>(target) >= it->second.size())
+    {
+        return nullptr;
+    }
+
+    return &it->second[target];
+}
+
+void Brokkr::EventManager::CompactList(uint32_t eventHash, int target)
+{
+    HandlerList* pList = FindList(eventHash, target);
+    if (pList == nullptr)
+    {
+        return;
+    }
+
+    auto& entries = pList->m_entries;
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [this](const HandlerEntry& entry)
+    {
+        return !IsEntryAlive(entry);
+    }), entries.end());
+
+    pList->m_deadCount = 0;
+    pList->m_serialCount = 0;
+    pList->m_entityLocalCount = 0;
+    for (const HandlerEntry& entry : entries)
+    {
+        if ((entry.m_flags & (HandlerFlags::kThreadSafe | HandlerFlags::kEntityLocal)) == 0)
+        {
+            ++pList->m_serialCount;
+        }
+        else if ((entry.m_flags & HandlerFlags::kThreadSafe) == 0)
+        {
+            ++pList->m_entityLocalCount;
+        }
+    }
+
+    // Targeted lists stay in their dense table, only empty broadcast lists are dropped
+    if (entries.empty() && target == Event::kNoTarget)
+    {
+        m_handlers.erase(eventHash);
+    }
 }
 
-void Brokkr::EventManager::AddHandler(uint32_t eventHash, const EventHandler& handler)
+void Brokkr::EventManager::Dispatch(const Event& event)
 {
-    // Add the handler to the set of handlers for the specified event type
-    m_handlers[eventHash].insert(handler);
+    m_isDispatching = true;
+    CallHandlers(event, 0);
+    m_isDispatching = false;
+
+    FlushPendingChanges();
 }
 
-void Brokkr::EventManager::RemoveHandler(uint32_t eventHash, const EventHandler& handler)
+void Brokkr::EventManager::CallHandlers(const Event& event, [[maybe_unused]] size_t participant)
 {
-    // Find the set of handlers for the given event type
-    if (const auto it = m_handlers.find(eventHash); it != m_handlers.end())
+    const HandlerList* pBroadcast = FindList(event.GetType(), Event::kNoTarget);
+    const HandlerList* pTargeted = event.GetTarget() != Event::kNoTarget ? FindList(event.GetType(), event.GetTarget()) : nullptr;
+
+#if BROKKR_EVENT_STATS
+    uint32_t handlerCalls = 0;
+    double handlerMilliseconds = 0.0;
+    double maxHandlerMilliseconds = 0.0;
+#else
+    if (pBroadcast == nullptr && pTargeted == nullptr)
     {
-        auto& handlers = it->second;
+        return;
+    }
+#endif
 
-        // Find the iterator to the specified handler in the set of handlers
-        const auto handlerIt = handlers.find(handler);
+    static const std::vector<HandlerEntry> kNoEntries;
+    const auto& broadcast = pBroadcast ? pBroadcast->m_entries : kNoEntries;
+    const auto& targeted = pTargeted ? pTargeted->m_entries : kNoEntries;
 
-        // If the handler was found, remove it from the set of handlers
-        if (handlerIt != handlers.end())
+    // Both arrays are sorted by priority, walk them as one merged list (entity handlers first on a tie).
+    // Removed handlers are skipped by their generation.
+    size_t broadcastIndex = 0;
+    size_t targetedIndex = 0;
+    while (broadcastIndex < broadcast.size() || targetedIndex < targeted.size())
+    {
+        const bool takeTargeted = targetedIndex < targeted.size()
+            && (broadcastIndex >= broadcast.size() || targeted[targetedIndex].m_priority >= broadcast[broadcastIndex].m_priority);
+
+        const HandlerEntry& entry = takeTargeted ? targeted[targetedIndex++] : broadcast[broadcastIndex++];
+        if (IsEntryAlive(entry))
         {
-            handlers.erase(handlerIt);
+#if BROKKR_EVENT_STATS
+            const auto handlerStart = std::chrono::steady_clock::now();
+            entry.m_delegate(event);
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - handlerStart).count();
+
+            ++handlerCalls;
+            handlerMilliseconds += milliseconds;
+            maxHandlerMilliseconds = std::max(maxHandlerMilliseconds, milliseconds);
+#else
+            entry.m_delegate(event);
+#endif
         }
     }
+
+#if BROKKR_EVENT_STATS
+    m_stats.RecordDispatch(participant, event.GetType(), event.GetEvent().ToString(), handlerCalls, handlerMilliseconds, maxHandlerMilliseconds);
+#endif
+}
+
+int Brokkr::EventManager::GetParallelGroup(const Event& event) const
+{
+    const HandlerList* pBroadcast = FindList(event.GetType(), Event::kNoTarget);
+    const HandlerList* pTargeted = event.GetTarget() != Event::kNoTarget ? FindList(event.GetType(), event.GetTarget()) : nullptr;
+
+    uint32_t serialCount = 0;
+    uint32_t entityLocalCount = 0;
+    for (const HandlerList* pList : { pBroadcast, pTargeted })
+    {
+        if (pList != nullptr)
+        {
+            serialCount += pList->m_serialCount;
+            entityLocalCount += pList->m_entityLocalCount;
+        }
+    }
+
+    if (serialCount > 0)
+    {
+        return kSerialGroup;
+    }
+
+    if (entityLocalCount == 0)
+    {
+        return kFreeGroup;
+    }
+
+    // Entity local handlers need a target to be kept apart by
+    return event.GetTarget() != Event::kNoTarget ? event.GetTarget() : kSerialGroup;
+}
+
+void Brokkr::EventManager::AddToWave(const Event& event, int group)
+{
+    const auto eventIndex = static_cast<uint32_t>(m_wave.size());
+    m_wave.push_back(event);
+
+    uint32_t groupIndex;
+    if (group == kFreeGroup)
+    {
+        groupIndex = static_cast<uint32_t>(m_waveGroupCount++);
+    }
+    else
+    {
+        // Every event for the same entity goes in the same group, in the order they were popped
+        const auto [it, isNew] = m_waveGroupByTarget.try_emplace(group, static_cast<uint32_t>(m_waveGroupCount));
+        if (isNew)
+        {
+            ++m_waveGroupCount;
+        }
+        groupIndex = it->second;
+    }
+
+    if (groupIndex >= m_waveGroups.size())
+    {
+        m_waveGroups.emplace_back();
+    }
+    m_waveGroups[groupIndex].push_back(eventIndex);
+}
+
+void Brokkr::EventManager::RunWave()
+{
+    if (m_wave.empty())
+    {
+        return;
+    }
+
+    BROKKR_PROFILE_SCOPE("Event Wave");
+    m_isDispatching = true;
+
+    // A single group has nothing to run next to
+    if (m_waveGroupCount == 1)
+    {
+        RunWaveShare(this, 0);
+    }
+    else
+    {
+        m_pJobSystem->Broadcast(&RunWaveShare, this);
+    }
+
+    m_isDispatching = false;
+    FlushPendingChanges();
+
+#if BROKKR_EVENT_STATS
+    m_stats.MergeWorkerSamples();
+#endif
+
+    for (size_t i = 0; i < m_waveGroupCount; ++i)
+    {
+        m_waveGroups[i].clear();
+    }
+    m_waveGroupCount = 0;
+    m_waveGroupByTarget.clear();
+    m_wave.clear();
+
+    // Workers may have pushed events, take them in now so they are handled this frame
+    m_threadedEvents.Drain([this](const Event& event) { Enqueue(event); });
+}
+
+void Brokkr::EventManager::RunWaveShare(void* pContext, size_t participant)
+{
+    BROKKR_PROFILE_SCOPE("Event Wave Share");
+    auto* pThis = static_cast<EventManager*>(pContext);
+
+    // Fixed split on the participant index, a given wave always runs on the same threads in the same order
+    const size_t participantCount = pThis->m_waveGroupCount == 1 ? 1 : pThis->m_pJobSystem->GetParticipantCount();
+    for (size_t group = participant; group < pThis->m_waveGroupCount; group += participantCount)
+    {
+        for (const uint32_t eventIndex : pThis->m_waveGroups[group])
+        {
+            pThis->CallHandlers(pThis->m_wave[eventIndex], participant);
+        }
+    }
+}
+
+void Brokkr::EventManager::FlushPendingChanges()
+{
+    if (!m_pendingAdds.empty())
+    {
+        for (const auto& pending : m_pendingAdds)
+        {
+            // Removed again before it was ever inserted
+            if (IsEntryAlive(pending.m_entry))
+            {
+                InsertEntry(pending.m_eventHash, pending.m_target, pending.m_entry);
+            }
+        }
+        m_pendingAdds.clear();
+    }
+
+    for (const auto& [eventHash, target] : m_pendingCompacts)
+    {
+        CompactList(eventHash, target);
+    }
+    m_pendingCompacts.clear();
+
+    m_pendingFrees.clear();
 }
 
 void Brokkr::EventManager::PushEvent(const Event& event)
 {
-    m_eventQueue.push(event);
+    if (std::this_thread::get_id() == m_ownerThread)
+    {
+        Enqueue(event);
+        return;
+    }
+
+    m_threadedEvents.Push(event);
+}
+
+void Brokkr::EventManager::Enqueue(const Event& event)
+{
+#if BROKKR_EVENT_STATS
+    m_stats.RecordPush(event.GetType(), event.GetEvent().ToString());
+#endif
+
+    const auto ruleIt = m_coalesceRules.find(event.GetType());
+    if (ruleIt == m_coalesceRules.end())
+    {
+        m_eventQueue.Push(event);
+#if BROKKR_EVENT_STATS
+        m_stats.RecordQueueDepth(m_eventQueue.GetSize());
+#endif
+        return;
+    }
+
+    const CoalesceRule& rule = ruleIt->second;
+    const uint64_t key = (static_cast<uint64_t>(event.GetType()) << 32) | static_cast<uint32_t>(event.GetTarget());
+    const size_t bucket = EventQueue::GetBucketIndex(event.GetPriorityLevel());
+
+    const auto [it, isNew] = m_pendingByKey.try_emplace(key);
+    if (!isNew && it->second.m_bucket == bucket)
+    {
+        // The position may have been popped and reused since, only coalesce with the same kind of event
+        Event* pPending = m_eventQueue.GetPending(bucket, it->second.m_position);
+        if (pPending != nullptr && pPending->GetType() == event.GetType() && pPending->GetTarget() == event.GetTarget())
+        {
+            switch (rule.m_policy)
+            {
+            case CoalescePolicy::kLastWins:
+                // Taken out of the queue, never dispatched or counted. The new one is queued behind everything before it
+                m_eventQueue.Cancel(bucket, it->second.m_position);
+                ++m_coalescedCount;
+#if BROKKR_EVENT_STATS
+                m_stats.RecordCoalesced(event.GetType());
+#endif
+                break;
+            case CoalescePolicy::kMergePayloads:
+                if (rule.m_pMerger != nullptr && rule.m_pMerger(*pPending, event, m_payloadArena))
+                {
+                    ++m_coalescedCount;
+#if BROKKR_EVENT_STATS
+                    m_stats.RecordCoalesced(event.GetType());
+#endif
+                    return;
+                }
+                break;
+            case CoalescePolicy::kDedupeByTarget:
+                ++m_coalescedCount;
+#if BROKKR_EVENT_STATS
+                m_stats.RecordCoalesced(event.GetType());
+#endif
+                return;
+            default:
+                break;
+            }
+        }
+    }
+
+    it->second = { bucket, m_eventQueue.Push(event) };
+#if BROKKR_EVENT_STATS
+    m_stats.RecordQueueDepth(m_eventQueue.GetSize());
+#endif
+}
+
+void Brokkr::EventManager::SetCoalescePolicy(const char* eventTypeString, CoalescePolicy policy, PayloadMerger pMerger)
+{
+    SetCoalescePolicy(Event::EventType::HashEventString(eventTypeString), policy, pMerger);
+}
+
+void Brokkr::EventManager::SetCoalescePolicy(uint32_t eventHash, CoalescePolicy policy, PayloadMerger pMerger)
+{
+    if (policy == CoalescePolicy::kNone)
+    {
+        m_coalesceRules.erase(eventHash);
+        return;
+    }
+
+    m_coalesceRules[eventHash] = { policy, pMerger };
 }
 
 void Brokkr::EventManager::ProcessEvents()
 {
-    while (!m_eventQueue.empty())
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    // Worker events pushed up to now join behind the main thread's
+    m_threadedEvents.Drain([this](const Event& event) { Enqueue(event); });
+
+    if (m_pDispatchScope)
     {
-        // Get the next event in the queue
-        const Event& event = m_eventQueue.top();
+        m_pDispatchScope(m_pDispatchScopeContext, true);
+    }
 
-        // Find the set of handlers for the event type of the current event
-        if (auto it = m_handlers.find(event.GetType()); it != m_handlers.end())
+    // Batches first, whatever they push into the queue is handled below
+    for (const auto& pChannel : m_channels)
+    {
+        if (pChannel)
         {
-            // Call each event handler in the set of handlers for the current event type
-            const auto& handlers = it->second;
-            for (const auto& handler : handlers) // 69.99% frame time here TODO: fix Idea: Asyc processing
+            pChannel->Deliver();
+        }
+    }
+
+    // A backlog that keeps coming back is flushed in full now and then
+    const bool isBudgeted = m_hasBudget && (m_budget.m_maxCarryFrames == 0 || m_backlog.m_carryFrames < m_budget.m_maxCarryFrames);
+    const size_t alwaysDrainBucket = EventQueue::GetBucketIndex(m_budget.m_alwaysDrainPriority);
+    size_t processed = 0;
+
+    // Moved out of the queue first, handlers are free to push new events while it is dispatched
+    static constexpr Event::EventType kEmptyType("None", Event::kPriorityMin);
+    Event event(kEmptyType);
+    for (;;)
+    {
+        if (isBudgeted && m_eventQueue.GetTopBucketIndex() > alwaysDrainBucket
+            && IsOverBudget(std::chrono::duration<double, std::milli>(Clock::now() - start).count(), processed))
+        {
+            // A wave being gathered still runs, it may push events that must not be held back
+            if (!m_wave.empty())
             {
-                handler.second(event);
+                RunWave();
+                continue;
             }
+            break;
+        }
+
+        if (!m_eventQueue.Pop(event))
+        {
+            break;
+        }
+        ++processed;
+
+        const int group = GetDispatchWorkerCount() > 0 ? GetParallelGroup(event) : kSerialGroup;
+        const size_t bucket = EventQueue::GetBucketIndex(event.GetPriorityLevel());
+
+        // A serial event or a new priority level closes the wave, waves never cross priority levels
+        if (!m_wave.empty() && (group == kSerialGroup || bucket != m_waveBucket))
+        {
+            RunWave();
+        }
+
+        if (group == kSerialGroup)
+        {
+            Dispatch(event);
+            continue;
+        }
+
+        m_waveBucket = bucket;
+        AddToWave(event, group);
+
+        // Nothing left to gather, run it now so anything it pushes is handled in this loop
+        if (m_eventQueue.IsEmpty())
+        {
+            RunWave();
         }
+    }
+
+    if (m_pDispatchScope)
+    {
+        m_pDispatchScope(m_pDispatchScopeContext, false);
+    }
+
+    m_backlog.m_processed = processed;
+    m_processedCount += processed;
+    m_backlog.m_carriedOver = m_eventQueue.GetSize();
+    for (size_t i = 0; i < EventQueue::kBucketCount; ++i)
+    {
+        m_backlog.m_bucketDepth[i] = m_eventQueue.GetBucketSize(i);
+    }
+    m_backlog.m_peakCarriedOver = std::max(m_backlog.m_peakCarriedOver, m_backlog.m_carriedOver);
+    m_backlog.m_milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
 
-        // Remove the processed event from the event queue
-        m_eventQueue.pop();
+#if BROKKR_EVENT_STATS
+    m_stats.EndFrame();
+#endif
+
+    if (m_backlog.m_carriedOver > 0)
+    {
+        ++m_backlog.m_carryFrames;
+        return;
     }
+
+    m_backlog.m_carryFrames = 0;
+
+    // Every event that could point into the arena has been handled
+    m_pendingByKey.clear();
+    m_payloadArena.Reset();
 }
+
+bool Brokkr::EventManager::IsOverBudget(double milliseconds, size_t processed) const
+{
+    return (m_budget.m_maxEvents > 0 && processed >= m_budget.m_maxEvents)
+        || (m_budget.m_milliseconds > 0.0 && milliseconds >= m_budget.m_milliseconds);
+}
+
 void Brokkr::EventManager::DumpEvents()
 {
-    /*while (!m_eventQueue.empty())
+    m_eventQueue.Clear();
+    m_threadedEvents.Clear();
+    m_pendingByKey.clear();
+    for (const auto& pChannel : m_channels)
     {
-        m_eventQueue.pop();
-    }*/
+        if (pChannel)
+        {
+            pChannel->Clear();
+        }
+    }
+    m_payloadArena.Reset();
+    m_backlog.m_carriedOver = 0;
+    m_backlog.m_carryFrames = 0;
 }
+void Brokkr::EventManager::SetJobSystem(JobSystem* pJobSystem)
+{
+    m_pJobSystem = pJobSystem;
+    if (m_pJobSystem == nullptr)
+    {
+        m_stats.SetParticipantCount(1);
+        return;
+    }
+
+    // Each worker gets a fixed producer key so events pushed from a wave merge in a repeatable order
+    m_stats.SetParticipantCount(m_pJobSystem->GetParticipantCount());
+    m_pJobSystem->Broadcast([](void* pContext, size_t participant)
+    {
+        if (participant != JobSystem::kMainThread)
+        {
+            static_cast<EventManager*>(pContext)->RegisterEventProducer(static_cast<uint32_t>(participant));
+        }
+    }, this);
+}
+
+void Brokkr::EventManager::RegisterStages(FrameScheduler& scheduler)
+{
+    // Everything the step pushed, once the entities are done moving
+    scheduler.AddStage<&EventManager::ProcessEvents>(EngineDefinitions::STAGE_PROCESS_EVENTS, FrameScheduler::Phase::kSimulation, this);
+    scheduler.AddDependency(EngineDefinitions::STAGE_PROCESS_EVENTS, EngineDefinitions::STAGE_LATE_UPDATE_ENTITIES);
+}
+
 void Brokkr::EventManager::Destroy()
 {
-    //TODO:
+    m_pJobSystem = nullptr;
 }
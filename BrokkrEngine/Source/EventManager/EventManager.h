@@ -23,43 +23,108 @@
 //-------------------------------------------------------------------------------------------------------------
 //                              *Event Handler for an Event*
 //-------------------------------------------------------------------------------------------------------------
-// Type alias for event handler functions, including a priority value is
-// " using EventHandler = std::pair<int, std::function<void(const Event&)>> "
+// Handlers are EventDelegates (see EventDelegate.h): a function pointer plus a context, bound at compile time
 //
-// All you need to have is the hash or the const char* for the event, then some int level of priority pre pre-defined or not
-// and last a functor or function pointer / lambda for a call back 
+//     m_subscription = eventManager.AddHandler("New Event", Event::kPriorityNormal,
+//         EventDelegate::FromMethod<Player, &Player::OnNewEvent>(this));
 //
+// A std::function can still be used when a lambda has to capture, the EventManager then owns a copy of it
 //
 //     eventManager.AddHandler("New Event", { priority level num for handlers sorting ,
 //     functor or function pointer / lambda for a call back });
 //
+// Handlers of the same event run from the highest priority to the lowest, handlers sharing a priority run in the
+// order they were added. Adding a handler from inside a handler is fine, it starts with the next event.
+//
+//                              *Entity Events*
+//-------------------------------------------------------------------------------------------------------------
+// Events meant for one entity carry its id instead of baking it into the event name
+//
+//     eventManager.AddHandler("OnEnter", entityId, Event::kPriorityNormal, delegate);
+//     eventManager.PushEvent(Event(onEnterType, entityId));
+//
+// A targeted event runs the handlers registered for its entity plus the ones registered for the whole type
+//
+//                              *Events From Other Threads*
+//-------------------------------------------------------------------------------------------------------------
+// PushEvent can be called from worker threads. Their events wait in a per thread ring and join the queue when
+// ProcessEvents starts, after the events pushed on the main thread of the same priority.
+//
+//     eventManager.RegisterEventProducer(workerIndex);  // once per worker, keeps the merge order deterministic
+//     eventManager.PushEvent(Event(aiDoneType, entityId));
+//
+// Payloads of those events have to fit inline, the payload arena is main thread only.
+//
+//                              *Parallel Dispatch*
+//-------------------------------------------------------------------------------------------------------------
+// Handlers can opt out of the main thread with HandlerFlags when they are added
+//
+//     eventManager.AddHandler("Think", entityId, Event::kPriorityNormal, delegate, HandlerFlags::kEntityLocal);
+//
+//     kThreadSafe   - can run at the same time as anything else
+//     kEntityLocal  - only touches the event's target entity
+//
+// Once SetJobSystem is given a pool with workers, ProcessEvents gathers back to back events of the same priority
+// level whose handlers are all flagged into a wave and spreads it over the workers. Events for the same entity
+// stay in order on one thread, waves still run from the highest priority level down, and one unflagged handler
+// makes its event run on the main thread like before. Events pushed from a wave are processed after it.
+//
+// Flagged handlers must not add or remove handlers or use the payload arena, PushEvent is fine.
+//
+//                              *Coalescing*
+//-------------------------------------------------------------------------------------------------------------
+// Event types that can pile up in one frame can collapse while they wait, per event type and target
+//
+//     eventManager.SetCoalescePolicy("UpdatePosition", EventManager::CoalescePolicy::kLastWins);
+//     eventManager.SetCoalescePolicy("OnEnter", EventManager::CoalescePolicy::kMergePayloads, &MergeHits);
+//
+// Only events still waiting in the queue are merged with, once one is dispatched the next starts over.
+//
+//                              *Typed Channels*
+//-------------------------------------------------------------------------------------------------------------
+// For events sent by the hundreds each frame a plain struct channel skips the generic Event entirely
+//
+//     eventManager.GetChannel<PositionChanged>().Push({ id, position });
+//     eventManager.GetChannel<PositionChanged>().Subscribe<Minimap, &Minimap::OnPositionsChanged>(this);
+//
+// Every channel hands its whole batch to its subscribers at the start of ProcessEvents, see EventChannel.h
+//
+//                              *Budgeted Processing*
+//-------------------------------------------------------------------------------------------------------------
+// By default ProcessEvents empties the queue. A budget caps the time or event count of one call, events below
+// the always drain priority that do not fit wait for the next frame, GetBacklogReport says how much is waiting.
+//
+//     eventManager.SetProcessBudget({ 2.0, 0, Event::kPriorityHigh });   // about 2ms a frame
+//
+// The payload arena is only reset once the queue is empty, so a backlog is flushed in full every
+// m_maxCarryFrames frames to keep it from growing.
+//
 //                              *Event Handler Removal*
 //---------------------------------------------------------------------------------------------------------------
 // Caller/ Event Handler/ adding party is responsible for removing handlers from system currently
 // This also means once register Handlers are not consumed on Event processing **Very important to note** 
 //
-// At the end of use of the handler should be removed from the EventManager
-//         eventManager.RemoveHandler("New Event", Handler);
-//                              or
-//         eventManager.RemoveHandler(Event::EventType::HashEventString("PlayerDied"), Handler);
+// AddHandler returns an EventSubscription, keep it and hand it back when done
+//         eventManager.RemoveHandler(m_subscription);
 //
-// removal can also be done with hashing the string before the removal or the caller can store the hash and
-// the handler for fast adding and removal
+// Removal is O(1) and safe inside a handler (even removing itself), the slot is just marked dead and the
+// handler array is compacted later when nothing is being dispatched
 //----------------------------------------------------------------------------------------------------------------
 //
 //                              *Event Payloads
 //----------------------------------------------------------------------------------------------------------------
-// Event payloads are component like system with an interface things to remember when creating custom payloads first
-// needs an owner pointer to the event container holding it. In add component function this pointer is the event container and
-// implicitly added to the payload component upon adding to the container.
+// An event holds one payload inline (Event::kPayloadCapacity bytes), so pushing an event never allocates.
+// Payloads must be trivially copyable, lists go in GetPayloadArena() with the payload keeping a pointer
+// and a count. Payloads bigger than the inline buffer use AddLargeComponent with the same arena.
 //
 // Payloads are meant to be read only so to not have a chance to change event data before another Handler/ listener can do its thing
 // this means in a Collision payload the Entity Ids should be returned and not their pointers that way events can get the
 // entity pointer from the Object pool with the ids
 //
 //                          --- Important to remember when using this system---
-//      **** EventHandlers are sorted for every event std::set so the higher priority levels are processed first ****
+//      **** EventHandlers are kept sorted per event type so the higher priority levels are processed first ****
 //      **** Events are sorted separate the Handlers priority level has noting to do with the Event priority level  ****
+//      **** Events are queued by the kPriority* levels, events of the same level are processed in the order pushed ****
 //
 //-------------------
 // ++Simple Example++ 
@@ -91,16 +156,16 @@
 //          std::string player = "Player variable to capture";
 //      
 //          // Register event handlers for events
-//          eventManager.AddHandler(Event::EventType::HashEventString("PlayerMoved"), { 0, [player]([[maybe_unused]] const Event& event)
+//          const auto capture = eventManager.AddHandler(Event::EventType::HashEventString("PlayerMoved"), { 0, [player]([[maybe_unused]] const Event& event)
 //              {
 //                  std::cout << player << "\n";
 //              } });
 //      
-//          eventManager.AddHandler(Event::EventType::HashEventString("PlayerMoved"), { Event::kPriorityNormal, OnPlayerMoved });
-//          eventManager.AddHandler("PlayerDied", { Event::kPriorityNormal, OnPlayerDied });
+//          const auto moved = eventManager.AddHandler("PlayerMoved", Event::kPriorityNormal, EventDelegate::FromFunction<OnPlayerMoved>());
+//          const auto died = eventManager.AddHandler("PlayerDied", Event::kPriorityNormal, EventDelegate::FromFunction<OnPlayerDied>());
 //
 //          // Higher priority value for death events
-//          eventManager.AddHandler(Event::EventType::HashEventString("PlayerDied"), { Event::kPriorityMax, OnPlayerDiedPriority });  
+//          const auto diedFirst = eventManager.AddHandler("PlayerDied", Event::kPriorityMax, EventDelegate::FromFunction<OnPlayerDiedPriority>());
 //      
 //          const Event PlayerDiedEvent(Event::EventType("PlayerDied", Event::kPriorityNormal));
 //      
@@ -119,14 +184,10 @@
 //          eventManager.ProcessEvents();
 //      
 //          // Remove event handlers
-//          eventManager.RemoveHandler(Event::EventType::HashEventString("PlayerMoved"), { 0, [player]([[maybe_unused]] const Event& event)
-//              {
-//                  std::cout << player << "\n";
-//              } });
-//      
-//          eventManager.RemoveHandler(Event::EventType::HashEventString("PlayerMoved"), { Event::kPriorityNormal, OnPlayerMoved });
-//          eventManager.RemoveHandler(Event::EventType::HashEventString("PlayerDied"), { Event::kPriorityNormal, OnPlayerDied });
-//          eventManager.RemoveHandler("PlayerDied", { Event::kPriorityMax, OnPlayerDiedPriority });
+//          eventManager.RemoveHandler(capture);
+//          eventManager.RemoveHandler(moved);
+//          eventManager.RemoveHandler(died);
+//          eventManager.RemoveHandler(diedFirst);
 //      
 //          return 0;
 //      }
@@ -134,11 +195,18 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <functional>
-#include <queue>
-#include <set>
+#include <memory>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 #include "Core/Core.h"
 #include "Event/Event.h"
+#include "ConcurrentEventQueue.h"
+#include "EventChannel.h"
+#include "EventDelegate.h"
+#include "EventQueue.h"
+#include "EventStats.h"
+#include "JobSystem/JobSystem.h"
 
 namespace Brokkr
 {
@@ -149,51 +217,249 @@ namespace Brokkr
         // event handler functions, including a priority value
         using EventHandler = std::pair<int, std::function<void(const Event&)>>;
 
-        // Comparison functor for event handler functions
-        struct EventHandlerComparer
+        // Called with true before ProcessEvents hands out its first event and with false after its last
+        using DispatchScope = void(*)(void* pContext, bool isDispatching);
+
+        // How repeated events of one type collapse while they wait in the queue, keyed on the event's target
+        enum class CoalescePolicy
         {
-            // takes two EventHandler objects and returns a bool
-            bool operator()(const EventHandler& left, const EventHandler& right) const;
+            kNone,
+            kLastWins,          // the pending one is cancelled, the new event is queued as usual
+            kMergePayloads,     // a PayloadMerger folds the new event into the pending one, which keeps its place
+            kDedupeByTarget     // the new event is dropped while one is pending
         };
 
-        // Comparison functor for events based on their enum value
-        struct EventComparer
+        // Folds incoming into pending, return false to queue incoming on its own instead
+        using PayloadMerger = bool(*)(Event& pending, const Event& incoming, FrameArena& arena);
+
+        // Limits for one ProcessEvents, whatever is left waits for the next frame. 0 turns a limit off.
+        struct ProcessBudget
         {
-            // Definition of operator() that takes two Event objects and returns a bool
-            bool operator()(const Event& left, const Event& right) const;
+            double m_milliseconds = 0.0;
+            size_t m_maxEvents = 0;
+
+            // Events at or above this level are always processed, the budget only holds back the ones below
+            unsigned int m_alwaysDrainPriority = Event::kPriorityHigh;
+
+            // After this many frames in a row ending with a backlog the queue is drained in full once, which is
+            // also when the payload arena gets reset. 0 never forces it.
+            uint32_t m_maxCarryFrames = 8;
+        };
+
+        // What the last ProcessEvents did and what it left behind
+        struct BacklogReport
+        {
+            size_t m_processed = 0;
+            size_t m_carriedOver = 0;
+            size_t m_bucketDepth[EventQueue::kBucketCount] = {};
+            size_t m_peakCarriedOver = 0;
+            uint32_t m_carryFrames = 0;     // frames in a row that ended with a backlog
+            double m_milliseconds = 0.0;
         };
 
     private:
-        // Map of event types to a set of event handlers, sorted using the custom comparator
-        std::unordered_map<uint32_t, std::set<EventHandler, EventHandlerComparer>> m_handlers;
+        // One registered handler inside an event type's array
+        struct HandlerEntry
+        {
+            EventDelegate m_delegate;
+            int m_priority = 0;
+            uint32_t m_slot = 0;
+            uint32_t m_generation = 0;
+            uint32_t m_flags = HandlerFlags::kSerial;
+        };
+
+        // Handlers of one event type, sorted by priority (high first) and stable within a priority
+        struct HandlerList
+        {
+            std::vector<HandlerEntry> m_entries;
+            uint32_t m_deadCount = 0;
+
+            // Entries by flags, dead ones included until the next compact
+            uint32_t m_serialCount = 0;
+            uint32_t m_entityLocalCount = 0;
+        };
+
+        // Handle table behind EventSubscription, a slot is alive while its generation matches the entry
+        struct HandlerSlot
+        {
+            uint32_t m_eventHash = 0;
+            int m_target = Event::kNoTarget;
+            uint32_t m_generation = 0;
+            bool m_inUse = false;
+            std::unique_ptr<std::function<void(const Event&)>> m_pOwnedFunction;
+        };
+
+        std::unordered_map<uint32_t, HandlerList> m_handlers;
+
+        // Entity local handlers: per event type a dense array indexed by entity id
+        std::unordered_map<uint32_t, std::vector<HandlerList>> m_targetedHandlers;
+        std::vector<HandlerSlot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+
+        struct PendingAdd
+        {
+            uint32_t m_eventHash;
+            int m_target;
+            HandlerEntry m_entry;
+        };
+
+        // Changes made while a handler array is being walked are applied once the event is done
+        bool m_isDispatching = false;
+        std::vector<PendingAdd> m_pendingAdds;
+        std::vector<std::unique_ptr<std::function<void(const Event&)>>> m_pendingFrees;
+        std::vector<std::pair<uint32_t, int>> m_pendingCompacts;
+
+        // Events waiting to be processed, bucketed by priority level and FIFO within a level
+        EventQueue m_eventQueue;
+
+        // Events pushed from other threads, merged into m_eventQueue at the start of ProcessEvents
+        ConcurrentEventQueue m_threadedEvents;
+        std::thread::id m_ownerThread;
+
+        // Parallel dispatch, see ProcessEvents. A wave is a run of same priority events whose handlers can all
+        // leave the main thread, split into groups that must stay in order (events for the same entity).
+        inline static constexpr int kSerialGroup = -2;
+        inline static constexpr int kFreeGroup = -1;
+
+        JobSystem* m_pJobSystem = nullptr;
+        DispatchScope m_pDispatchScope = nullptr;
+        void* m_pDispatchScopeContext = nullptr;
+        std::vector<Event> m_wave;
+        size_t m_waveBucket = 0;
+        std::vector<std::vector<uint32_t>> m_waveGroups;
+        size_t m_waveGroupCount = 0;
+        std::unordered_map<int, uint32_t> m_waveGroupByTarget;
+
+        struct CoalesceRule
+        {
+            CoalescePolicy m_policy = CoalescePolicy::kNone;
+            PayloadMerger m_pMerger = nullptr;
+        };
+
+        struct PendingLocation
+        {
+            size_t m_bucket = 0;
+            size_t m_position = 0;
+        };
+
+        // Only event types given a policy are looked up, pending events by type and target
+        std::unordered_map<uint32_t, CoalesceRule> m_coalesceRules;
+        std::unordered_map<uint64_t, PendingLocation> m_pendingByKey;
+        size_t m_coalescedCount = 0;
+
+        bool m_hasBudget = false;
+        ProcessBudget m_budget;
+        BacklogReport m_backlog;
+        uint64_t m_processedCount = 0;
 
-        // Priority queue of events waiting to be processed, sorted by their enum value
-        std::priority_queue<Event, std::vector<Event>, EventComparer> m_eventQueue;
+        // Typed channels indexed by TypeID of their struct, delivered at the start of ProcessEvents
+        std::vector<std::unique_ptr<EventChannelBase>> m_channels;
+
+        // Counters, only filled in when BROKKR_EVENT_STATS is 1
+        EventStats m_stats;
+
+        // Memory for payload data too big to sit inside an Event, reset once the queue is drained
+        FrameArena m_payloadArena;
 
     public:
-        explicit EventManager(CoreSystems* pCoreManager): System(pCoreManager) { }
+        explicit EventManager(CoreSystems* pCoreManager): System(pCoreManager), m_ownerThread(std::this_thread::get_id()) { }
+
+        // Add a handler for an event by string or hash
+        // flags are HandlerFlags, left at kSerial the handler only ever runs on the main thread
+        EventSubscription AddHandler(const char* eventTypeString, int priority, EventDelegate delegate, uint32_t flags = HandlerFlags::kSerial);
+        EventSubscription AddHandler(uint32_t eventHash, int priority, EventDelegate delegate, uint32_t flags = HandlerFlags::kSerial);
 
-        // Add a handler for an event by string
-        void AddHandler(const char* eventTypeString, const EventHandler& handler);
+        // Add a std::function handler, the EventManager keeps its own copy for as long as it is registered
+        EventSubscription AddHandler(const char* eventTypeString, const EventHandler& handler, uint32_t flags = HandlerFlags::kSerial);
+        EventSubscription AddHandler(uint32_t eventHash, const EventHandler& handler, uint32_t flags = HandlerFlags::kSerial);
 
-        // Remove a handler for an event by string
-        void RemoveHandler(const char* eventTypeString, const EventHandler& handler);
+        // Add a handler that only sees events targeted at one entity (Event::GetTarget), no per entity event names needed
+        EventSubscription AddHandler(const char* eventTypeString, int targetId, int priority, EventDelegate delegate, uint32_t flags = HandlerFlags::kSerial);
+        EventSubscription AddHandler(uint32_t eventHash, int targetId, int priority, EventDelegate delegate, uint32_t flags = HandlerFlags::kSerial);
 
-        // Add an event handler for a given event type with a specified priority
-        void AddHandler(uint32_t eventHash, const EventHandler& handler);
+        // Remove a handler, stale or already removed subscriptions are ignored
+        bool RemoveHandler(EventSubscription subscription);
 
-        // Remove an event handler for a given event type
-        void RemoveHandler(uint32_t eventHash, const EventHandler& handler);
+        // Contiguous per type channel for high frequency events, created the first time it is asked for
+        template <typename EventStruct>
+        [[nodiscard]] EventChannel<EventStruct>& GetChannel();
 
-        // Add an event to the event queue
+        // Add an event to the event queue, safe from any thread.
+        // Events from other threads must keep their payload inline (no GetPayloadArena) and show up in the
+        // next ProcessEvents after the push, see ConcurrentEventQueue.
         void PushEvent(const Event& event);
 
-        // Process all events currently in the event queue
+        // Opt an event type into coalescing, kNone turns it back off. kMergePayloads needs a merger.
+        void SetCoalescePolicy(const char* eventTypeString, CoalescePolicy policy, PayloadMerger pMerger = nullptr);
+        void SetCoalescePolicy(uint32_t eventHash, CoalescePolicy policy, PayloadMerger pMerger = nullptr);
+
+        // Events that were folded into a pending one instead of being queued, since the start
+        [[nodiscard]] size_t GetCoalescedCount() const { return m_coalescedCount; }
+
+        // Gives the calling worker thread a fixed key, events from workers are merged in key order
+        bool RegisterEventProducer(uint32_t key) { return m_threadedEvents.RegisterProducer(key); }
+
+        // Anything placed here lives until the end of the next ProcessEvents that empties the queue
+        [[nodiscard]] FrameArena& GetPayloadArena() { return m_payloadArena; }
+
+        // Workers for parallel waves, nullptr (the default) keeps everything on the main thread
+        void SetJobSystem(JobSystem* pJobSystem);
+        [[nodiscard]] size_t GetDispatchWorkerCount() const { return m_pJobSystem ? m_pJobSystem->GetWorkerCount() : 0; }
+
+        // One system can wrap dispatch, the GameEntityManager uses it to defer structural changes. nullptr clears it
+        void SetDispatchScope(DispatchScope pScope, void* pContext) { m_pDispatchScope = pScope; m_pDispatchScopeContext = pContext; }
+
+        // Process all events currently in the event queue, must run on the thread that created the EventManager.
+        // With a budget set it stops once the budget is spent and only high priority events are left.
         void ProcessEvents();
+
+        void SetProcessBudget(const ProcessBudget& budget) { m_budget = budget; m_hasBudget = true; }
+        void ClearProcessBudget() { m_hasBudget = false; }
+        [[nodiscard]] const BacklogReport& GetBacklogReport() const { return m_backlog; }
+
+        // Events dispatched since the start, over every ProcessEvents call
+        [[nodiscard]] uint64_t GetProcessedCount() const { return m_processedCount; }
+
+        // Per type counts and handler timings, see EventStats.h for the BROKKR_EVENT_STATS switch
+        [[nodiscard]] EventStats& GetStats() { return m_stats; }
         void DumpEvents();
 
+        virtual void RegisterStages(FrameScheduler& scheduler) override;
         virtual void Destroy() override;
+
+    private:
+        EventSubscription AddEntry(uint32_t eventHash, int target, int priority, EventDelegate delegate, uint32_t flags, std::unique_ptr<std::function<void(const Event&)>> pOwnedFunction);
+        void InsertEntry(uint32_t eventHash, int target, const HandlerEntry& entry);
+        [[nodiscard]] HandlerList* FindList(uint32_t eventHash, int target);
+        [[nodiscard]] const HandlerList* FindList(uint32_t eventHash, int target) const;
+        void Enqueue(const Event& event);
+        void Dispatch(const Event& event);
+        void CallHandlers(const Event& event, size_t participant);
+        [[nodiscard]] int GetParallelGroup(const Event& event) const;
+        void AddToWave(const Event& event, int group);
+        void RunWave();
+        [[nodiscard]] bool IsOverBudget(double milliseconds, size_t processed) const;
+        static void RunWaveShare(void* pContext, size_t participant);
+        void FlushPendingChanges();
+        void CompactList(uint32_t eventHash, int target);
+        [[nodiscard]] bool IsEntryAlive(const HandlerEntry& entry) const { return m_slots[entry.m_slot].m_generation == entry.m_generation; }
     };
-}
 
+    template <typename EventStruct>
+    EventChannel<EventStruct>& EventManager::GetChannel()
+    {
+        const TypeIndex index = TypeID::Get<EventStruct>();
+        if (index >= m_channels.size())
+        {
+            m_channels.resize(static_cast<size_t>(index) + 1);
+        }
+
+        if (!m_channels[index])
+        {
+            m_channels[index] = std::make_unique<EventChannel<EventStruct>>();
+        }
+
+        return *static_cast<EventChannel<EventStruct>*>(m_channels[index].get());
+    }
+}
 
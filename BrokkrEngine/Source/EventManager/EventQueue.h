@@ -0,0 +1,186 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Event/Event.h"
+
+namespace Brokkr
+{
+    // Event queue bucketed on the predefined Event::kPriority* levels.
+    // A priority between two levels goes in the bucket of the level below it (700 is treated as Normal).
+    // Push, Pop and Cancel are O(1) (Pop amortized over cancelled events), events of the same level come out in
+    // the order they went in, and the bucket storage is kept between frames so a warmed up queue does not allocate.
+    class EventQueue
+    {
+    public:
+        inline static constexpr size_t kBucketCount = 5;
+
+    private:
+        struct Bucket
+        {
+            std::vector<Event> m_events;
+            size_t m_head = 0;      // next event to pop, storage is only cleared once the bucket drains
+            size_t m_liveCount = 0; // events after m_head that were not cancelled
+        };
+
+        // Left in the slot of a cancelled event, Pop steps over it
+        inline static constexpr Event::EventType kCancelledType{ "Cancelled", Event::kPriorityMin };
+
+        // Highest priority first
+        Bucket m_buckets[kBucketCount];
+        uint32_t m_nonEmptyMask = 0;
+        size_t m_size = 0;
+
+    public:
+        // Bucket index of a priority, 0 is the highest
+        [[nodiscard]] static size_t GetBucketIndex(unsigned int priority);
+
+        // Returns the event's position in its bucket, see GetPending
+        size_t Push(const Event& event);
+
+        // Moves the highest priority, oldest event out. Returns false when empty.
+        bool Pop(Event& outEvent);
+
+        // Takes a pending event out of the queue, it is never popped and no longer counted in the sizes.
+        // Returns false if the position was already popped or cancelled.
+        bool Cancel(size_t bucketIndex, size_t position);
+
+        void Clear();
+
+        // The event at a position returned by Push if it has not been popped yet, nullptr otherwise.
+        // Positions are reused once a bucket drains so the caller checks it is still the event it expects.
+        [[nodiscard]] Event* GetPending(size_t bucketIndex, size_t position);
+
+        // Bucket the next Pop takes from, kBucketCount when empty
+        [[nodiscard]] size_t GetTopBucketIndex() const;
+
+        [[nodiscard]] bool IsEmpty() const { return m_size == 0; }
+        [[nodiscard]] size_t GetSize() const { return m_size; }
+        [[nodiscard]] size_t GetBucketSize(size_t bucketIndex) const { return m_buckets[bucketIndex].m_liveCount; }
+
+    private:
+        [[nodiscard]] static bool IsCancelled(const Event& event) { return event.GetType() == kCancelledType.GetTypeHash(); }
+        void ResetBucket(size_t bucketIndex);
+    };
+
+    inline size_t EventQueue::GetBucketIndex(unsigned int priority)
+    {
+        if (priority >= Event::kPriorityMax)
+            return 0;
+        if (priority >= Event::kPriorityHigh)
+            return 1;
+        if (priority >= Event::kPriorityNormal)
+            return 2;
+        if (priority >= Event::kPriorityLow)
+            return 3;
+        return 4;
+    }
+
+    inline size_t EventQueue::Push(const Event& event)
+    {
+        const size_t index = GetBucketIndex(event.GetPriorityLevel());
+        m_buckets[index].m_events.push_back(event);
+        ++m_buckets[index].m_liveCount;
+        m_nonEmptyMask |= 1u << index;
+        ++m_size;
+
+        return m_buckets[index].m_events.size() - 1;
+    }
+
+    inline bool EventQueue::Pop(Event& outEvent)
+    {
+        if (m_nonEmptyMask == 0)
+        {
+            return false;
+        }
+
+        // Lowest set bit is the highest priority bucket with something in it
+        size_t index = 0;
+        while ((m_nonEmptyMask & (1u << index)) == 0)
+        {
+            ++index;
+        }
+
+        // A bucket with live events always has one ahead of any cancelled ones
+        Bucket& bucket = m_buckets[index];
+        while (IsCancelled(bucket.m_events[bucket.m_head]))
+        {
+            ++bucket.m_head;
+        }
+
+        outEvent = std::move(bucket.m_events[bucket.m_head++]);
+        --bucket.m_liveCount;
+        --m_size;
+
+        if (bucket.m_liveCount == 0)
+        {
+            ResetBucket(index);
+        }
+
+        return true;
+    }
+
+    inline bool EventQueue::Cancel(size_t bucketIndex, size_t position)
+    {
+        Event* pEvent = GetPending(bucketIndex, position);
+        if (pEvent == nullptr || IsCancelled(*pEvent))
+        {
+            return false;
+        }
+
+        *pEvent = Event(kCancelledType);
+        --m_buckets[bucketIndex].m_liveCount;
+        --m_size;
+
+        if (m_buckets[bucketIndex].m_liveCount == 0)
+        {
+            ResetBucket(bucketIndex);
+        }
+
+        return true;
+    }
+
+    inline void EventQueue::ResetBucket(size_t bucketIndex)
+    {
+        // Drained, rewind so the storage is reused. Cancelled events still behind the head go with it
+        Bucket& bucket = m_buckets[bucketIndex];
+        bucket.m_events.clear();
+        bucket.m_head = 0;
+        m_nonEmptyMask &= ~(1u << bucketIndex);
+    }
+
+    inline size_t EventQueue::GetTopBucketIndex() const
+    {
+        size_t index = 0;
+        while (index < kBucketCount && (m_nonEmptyMask & (1u << index)) == 0)
+        {
+            ++index;
+        }
+
+        return index;
+    }
+
+    inline Event* EventQueue::GetPending(size_t bucketIndex, size_t position)
+    {
+        Bucket& bucket = m_buckets[bucketIndex];
+        if (position < bucket.m_head || position >= bucket.m_events.size())
+        {
+            return nullptr;
+        }
+
+        return &bucket.m_events[position];
+    }
+
+    inline void EventQueue::Clear()
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.m_events.clear();
+            bucket.m_head = 0;
+            bucket.m_liveCount = 0;
+        }
+
+        m_nonEmptyMask = 0;
+        m_size = 0;
+    }
+}
@@ -0,0 +1,172 @@
+#include "EventStats.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Same order every frame so captures line up
+    std::vector<const Brokkr::EventStats::TypeStats*> SortedByName(const Brokkr::EventStats::FrameStats& frame)
+    {
+        std::vector<const Brokkr::EventStats::TypeStats*> types;
+        types.reserve(frame.m_types.size());
+        for (const auto& [hash, stats] : frame.m_types)
+        {
+            types.push_back(&stats);
+        }
+
+        std::sort(types.begin(), types.end(), [](const auto* pLeft, const auto* pRight)
+        {
+            return std::strcmp(pLeft->m_pName, pRight->m_pName) < 0;
+        });
+
+        return types;
+    }
+}
+
+void Brokkr::EventStats::RecordPush(uint32_t type, const char* pName)
+{
+    TypeStats& stats = GetType(type);
+    stats.m_pName = pName;
+    ++stats.m_pushed;
+}
+
+void Brokkr::EventStats::RecordCoalesced(uint32_t type)
+{
+    ++GetType(type).m_coalesced;
+}
+
+void Brokkr::EventStats::RecordQueueDepth(size_t depth)
+{
+    m_current.m_peakQueueDepth = std::max(m_current.m_peakQueueDepth, depth);
+}
+
+void Brokkr::EventStats::RecordDispatch(size_t participant, uint32_t type, const char* pName, uint32_t handlerCalls, double milliseconds, double maxMilliseconds)
+{
+    if (participant > 0)
+    {
+        m_workerSamples[participant].push_back({ type, pName, handlerCalls, milliseconds, maxMilliseconds });
+        return;
+    }
+
+    // Named here too, events can be dispatched in a later frame than their push
+    TypeStats& stats = GetType(type);
+    stats.m_pName = pName;
+    ++stats.m_processed;
+    stats.m_handlerCalls += handlerCalls;
+    stats.m_handlerMilliseconds += milliseconds;
+    stats.m_maxHandlerMilliseconds = std::max(stats.m_maxHandlerMilliseconds, maxMilliseconds);
+}
+
+void Brokkr::EventStats::SetParticipantCount(size_t count)
+{
+    m_workerSamples.resize(count);
+}
+
+void Brokkr::EventStats::MergeWorkerSamples()
+{
+    for (size_t participant = 1; participant < m_workerSamples.size(); ++participant)
+    {
+        for (const DispatchSample& sample : m_workerSamples[participant])
+        {
+            RecordDispatch(0, sample.m_type, sample.m_pName, sample.m_handlerCalls, sample.m_milliseconds, sample.m_maxMilliseconds);
+        }
+        m_workerSamples[participant].clear();
+    }
+}
+
+void Brokkr::EventStats::EndFrame()
+{
+    MergeWorkerSamples();
+
+    const uint64_t frame = m_current.m_frame;
+    m_lastFrame = std::move(m_current);
+
+    m_current = FrameStats();
+    m_current.m_frame = frame + 1;
+
+    if (m_captureFile.is_open())
+    {
+        if (m_captureFormat == Format::kCSV)
+        {
+            WriteLastFrameCSV(m_captureFile, false);
+        }
+        else
+        {
+            WriteLastFrameJSON(m_captureFile);
+        }
+    }
+}
+
+bool Brokkr::EventStats::StartCapture(const char* pPath, Format format)
+{
+    StopCapture();
+
+    m_captureFile.open(pPath, std::ios::out | std::ios::trunc);
+    if (!m_captureFile.is_open())
+    {
+        return false;
+    }
+
+    m_captureFormat = format;
+    if (format == Format::kCSV)
+    {
+        WriteCSVHeader(m_captureFile);
+    }
+
+    return true;
+}
+
+void Brokkr::EventStats::StopCapture()
+{
+    if (m_captureFile.is_open())
+    {
+        m_captureFile.close();
+    }
+}
+
+void Brokkr::EventStats::WriteLastFrameCSV(std::ostream& output, bool writeHeader) const
+{
+    if (writeHeader)
+    {
+        WriteCSVHeader(output);
+    }
+
+    for (const TypeStats* pStats : SortedByName(m_lastFrame))
+    {
+        output << m_lastFrame.m_frame << ',' << pStats->m_pName << ',' << pStats->m_pushed << ',' << pStats->m_coalesced << ','
+            << pStats->m_processed << ',' << pStats->m_handlerCalls << ',' << pStats->m_handlerMilliseconds << ','
+            << pStats->m_maxHandlerMilliseconds << ',' << m_lastFrame.m_peakQueueDepth << '\n';
+    }
+}
+
+void Brokkr::EventStats::WriteLastFrameJSON(std::ostream& output) const
+{
+    output << "{\"frame\":" << m_lastFrame.m_frame << ",\"peakQueueDepth\":" << m_lastFrame.m_peakQueueDepth << ",\"types\":[";
+
+    bool isFirst = true;
+    for (const TypeStats* pStats : SortedByName(m_lastFrame))
+    {
+        output << (isFirst ? "" : ",")
+            << "{\"name\":\"" << pStats->m_pName
+            << "\",\"pushed\":" << pStats->m_pushed
+            << ",\"coalesced\":" << pStats->m_coalesced
+            << ",\"processed\":" << pStats->m_processed
+            << ",\"handlerCalls\":" << pStats->m_handlerCalls
+            << ",\"handlerMs\":" << pStats->m_handlerMilliseconds
+            << ",\"maxHandlerMs\":" << pStats->m_maxHandlerMilliseconds << '}';
+        isFirst = false;
+    }
+
+    output << "]}\n";
+}
+
+Brokkr::EventStats::TypeStats& Brokkr::EventStats::GetType(uint32_t type)
+{
+    return m_current.m_types[type];
+}
+
+void Brokkr::EventStats::WriteCSVHeader(std::ostream& output)
+{
+    output << "frame,type,pushed,coalesced,processed,handler_calls,handler_ms,max_handler_ms,peak_queue_depth\n";
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+/////////////////////////////////////////////////
+//          Event Stats
+//
+// Per frame counters for the EventManager, a frame being one ProcessEvents call and the pushes before it.
+// Recording is compiled out unless BROKKR_EVENT_STATS is 1, the class itself is always there so code reading
+// the stats does not need its own #if.
+//
+//  Per event type: pushed, coalesced, processed, handler calls, total and max handler time.
+//  Per frame: peak queue depth.
+//
+//  Example Use:
+//
+//      pEventManager->GetStats().StartCapture("EventStats.csv", EventStats::Format::kCSV);
+//      ...
+//      pEventManager->GetStats().WriteLastFrameJSON(std::cout);
+//
+/////////////////////////////////////////////////
+
+#ifndef BROKKR_EVENT_STATS
+#define BROKKR_EVENT_STATS 0
+#endif
+
+namespace Brokkr
+{
+    class EventStats
+    {
+    public:
+        enum class Format
+        {
+            kCSV,
+            kJSON   // one JSON object per line, one line per frame
+        };
+
+        struct TypeStats
+        {
+            const char* m_pName = "";
+            uint64_t m_pushed = 0;
+            uint64_t m_coalesced = 0;
+            uint64_t m_processed = 0;
+            uint64_t m_handlerCalls = 0;
+            double m_handlerMilliseconds = 0.0;
+            double m_maxHandlerMilliseconds = 0.0;
+        };
+
+        struct FrameStats
+        {
+            uint64_t m_frame = 0;
+            size_t m_peakQueueDepth = 0;
+            std::unordered_map<uint32_t, TypeStats> m_types;
+        };
+
+    private:
+        // Handler timings from parallel waves, one list per worker so recording never locks
+        struct DispatchSample
+        {
+            uint32_t m_type;
+            const char* m_pName;
+            uint32_t m_handlerCalls;
+            double m_milliseconds;
+            double m_maxMilliseconds;
+        };
+
+        FrameStats m_current;
+        FrameStats m_lastFrame;
+        std::vector<std::vector<DispatchSample>> m_workerSamples;
+
+        std::ofstream m_captureFile;
+        Format m_captureFormat = Format::kCSV;
+
+    public:
+        // Main thread
+        void RecordPush(uint32_t type, const char* pName);
+        void RecordCoalesced(uint32_t type);
+        void RecordQueueDepth(size_t depth);
+
+        // participant 0 is the main thread, others are JobSystem workers
+        void RecordDispatch(size_t participant, uint32_t type, const char* pName, uint32_t handlerCalls, double milliseconds, double maxMilliseconds);
+        void SetParticipantCount(size_t count);
+        void MergeWorkerSamples();
+
+        // Closes the frame, writes it to the capture file if one is open
+        void EndFrame();
+
+        [[nodiscard]] const FrameStats& GetLastFrame() const { return m_lastFrame; }
+
+        // Writes every frame from now on to a file, returns false if it could not be opened
+        bool StartCapture(const char* pPath, Format format);
+        void StopCapture();
+
+        void WriteLastFrameCSV(std::ostream& output, bool writeHeader) const;
+        void WriteLastFrameJSON(std::ostream& output) const;
+
+    private:
+        TypeStats& GetType(uint32_t type);
+        static void WriteCSVHeader(std::ostream& output);
+    };
+}
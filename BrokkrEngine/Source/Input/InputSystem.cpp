@@ -0,0 +1,284 @@
+#include "InputSystem.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <SDL.h>
+
+Brokkr::InputSystem::~InputSystem()
+{
+    StopRecording();
+}
+
+void Brokkr::InputSystem::Destroy()
+{
+    StopRecording();
+    m_mode = Mode::kLive;
+}
+
+bool Brokkr::InputSystem::StartRecording(const std::string& path, const SessionInfo& info)
+{
+    StopRecording();
+
+    m_recordingFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_recordingFile.is_open())
+    {
+        std::cout << "InputSystem: could not record to " << path << '\n';
+        return false;
+    }
+
+    m_recordingWriter = BinaryWriter(&m_recordingFile, kRecordingFlushSize);
+    m_recordingWriter.Write(kRecordingMagic);
+    m_recordingWriter.Write(kRecordingVersion);
+    m_recordingWriter.Write(info.m_seed);
+    m_recordingWriter.Write(info.m_ticksPerSecond);
+
+    m_recordingPath = path;
+    m_mode = Mode::kRecording;
+    m_frame = 0;
+    return true;
+}
+
+void Brokkr::InputSystem::StopRecording()
+{
+    if (m_mode != Mode::kRecording)
+    {
+        return;
+    }
+
+    m_recordingWriter.Flush();
+    if (m_recordingWriter.HasFailed())
+    {
+        std::cout << "InputSystem: could not write " << m_recordingPath << '\n';
+    }
+    else
+    {
+        std::cout << "InputSystem: " << m_frame << " frames recorded to " << m_recordingPath << '\n';
+    }
+
+    m_recordingFile.close();
+    m_recordingWriter = BinaryWriter();
+    m_mode = Mode::kLive;
+}
+
+bool Brokkr::InputSystem::StartReplay(const std::string& path, SessionInfo& info)
+{
+    StopRecording();
+
+    m_replayReader = BinaryReader();
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!m_replayReader.LoadFromFile(path.c_str()) || !m_replayReader.Read(magic) || magic != kRecordingMagic
+        || !m_replayReader.Read(version) || version != kRecordingVersion
+        || !m_replayReader.Read(info.m_seed) || !m_replayReader.Read(info.m_ticksPerSecond))
+    {
+        std::cout << "InputSystem: " << path << " is not an input recording\n";
+        return false;
+    }
+
+    ResetState();
+    m_mode = Mode::kReplaying;
+    m_hasReplayEnded = m_replayReader.GetRemaining() == 0;
+    m_frame = 0;
+    return true;
+}
+
+void Brokkr::InputSystem::PollEvents()
+{
+    m_frameEvents.clear();
+
+    SDL_Event sdlEvent;
+    InputEvent event;
+    while (SDL_PollEvent(&sdlEvent))
+    {
+        if (!Translate(sdlEvent, event))
+        {
+            continue;
+        }
+
+        if (m_mode == Mode::kReplaying)
+        {
+            // Closing the window still works, nothing else live reaches a replay
+            m_isQuitRequested |= event.m_type == InputEventType::kQuit;
+        }
+        else if (m_frameEvents.size() < kMaxEventsPerFrame)
+        {
+            m_frameEvents.push_back(event);
+            Apply(event);
+        }
+    }
+
+    if (m_mode == Mode::kReplaying)
+    {
+        ReadReplayFrame();
+    }
+}
+
+void Brokkr::InputSystem::PushEvent(const InputEvent& event)
+{
+    if (m_mode == Mode::kReplaying || m_frameEvents.size() >= kMaxEventsPerFrame)
+    {
+        return;
+    }
+
+    m_frameEvents.push_back(event);
+    Apply(event);
+}
+
+void Brokkr::InputSystem::EndFrame(int stepsThisFrame)
+{
+    ++m_frame;
+    if (m_mode != Mode::kRecording)
+    {
+        return;
+    }
+
+    const FrameHeader header{ static_cast<uint16_t>(std::clamp(stepsThisFrame, 0, static_cast<int>(UINT16_MAX))),
+        static_cast<uint16_t>(m_frameEvents.size()) };
+    m_recordingWriter.Write(header);
+    m_recordingWriter.WriteBytes(m_frameEvents.data(), m_frameEvents.size() * sizeof(InputEvent));
+    m_recordingWriter.FlushIfFull();
+}
+
+bool Brokkr::InputSystem::IsKeyDown(int32_t key) const
+{
+    return std::binary_search(m_keysDown.begin(), m_keysDown.end(), key);
+}
+
+bool Brokkr::InputSystem::WasKeyPressed(int32_t key) const
+{
+    return std::any_of(m_frameEvents.begin(), m_frameEvents.end(), [key](const InputEvent& event)
+    {
+        return event.m_type == InputEventType::kKeyDown && event.m_key == key && event.m_detail == 0;
+    });
+}
+
+bool Brokkr::InputSystem::Translate(const SDL_Event& sdlEvent, InputEvent& event)
+{
+    event = InputEvent();
+    switch (sdlEvent.type)
+    {
+    case SDL_QUIT:
+        event.m_type = InputEventType::kQuit;
+        return true;
+
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        event.m_type = sdlEvent.type == SDL_KEYDOWN ? InputEventType::kKeyDown : InputEventType::kKeyUp;
+        event.m_detail = sdlEvent.key.repeat != 0 ? 1 : 0;
+        event.m_modifiers = sdlEvent.key.keysym.mod;
+        event.m_key = sdlEvent.key.keysym.sym;
+        return true;
+
+    case SDL_MOUSEMOTION:
+        event.m_type = InputEventType::kMouseMove;
+        event.m_x = sdlEvent.motion.x;
+        event.m_y = sdlEvent.motion.y;
+        return true;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        event.m_type = sdlEvent.type == SDL_MOUSEBUTTONDOWN ? InputEventType::kMouseButtonDown : InputEventType::kMouseButtonUp;
+        event.m_detail = sdlEvent.button.button;
+        event.m_x = sdlEvent.button.x;
+        event.m_y = sdlEvent.button.y;
+        return true;
+
+    case SDL_MOUSEWHEEL:
+        event.m_type = InputEventType::kMouseWheel;
+        event.m_x = sdlEvent.wheel.x;
+        event.m_y = sdlEvent.wheel.y;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void Brokkr::InputSystem::Apply(const InputEvent& event)
+{
+    switch (event.m_type)
+    {
+    case InputEventType::kQuit:
+        m_isQuitRequested = true;
+        break;
+
+    case InputEventType::kKeyDown:
+    {
+        const auto found = std::lower_bound(m_keysDown.begin(), m_keysDown.end(), event.m_key);
+        if (found == m_keysDown.end() || *found != event.m_key)
+        {
+            m_keysDown.insert(found, event.m_key);
+        }
+        break;
+    }
+
+    case InputEventType::kKeyUp:
+    {
+        const auto found = std::lower_bound(m_keysDown.begin(), m_keysDown.end(), event.m_key);
+        if (found != m_keysDown.end() && *found == event.m_key)
+        {
+            m_keysDown.erase(found);
+        }
+        break;
+    }
+
+    case InputEventType::kMouseMove:
+        m_mouseX = event.m_x;
+        m_mouseY = event.m_y;
+        break;
+
+    case InputEventType::kMouseButtonDown:
+    case InputEventType::kMouseButtonUp:
+        m_mouseX = event.m_x;
+        m_mouseY = event.m_y;
+        if (event.m_detail < 32)
+        {
+            const uint32_t bit = 1u << event.m_detail;
+            m_mouseButtons = event.m_type == InputEventType::kMouseButtonDown ? m_mouseButtons | bit : m_mouseButtons & ~bit;
+        }
+        break;
+
+    case InputEventType::kMouseWheel:
+        break;
+    }
+}
+
+void Brokkr::InputSystem::ReadReplayFrame()
+{
+    m_replaySteps = 0;
+    if (m_hasReplayEnded)
+    {
+        return;
+    }
+
+    FrameHeader header{};
+    if (!m_replayReader.Read(header) || header.m_eventCount * sizeof(InputEvent) > m_replayReader.GetRemaining())
+    {
+        std::cout << "InputSystem: input recording cut short at frame " << m_frame << '\n';
+        m_hasReplayEnded = true;
+        return;
+    }
+
+    m_frameEvents.resize(header.m_eventCount);
+    m_replayReader.ReadBytes(m_frameEvents.data(), m_frameEvents.size() * sizeof(InputEvent));
+    for (const InputEvent& event : m_frameEvents)
+    {
+        Apply(event);
+    }
+
+    m_replaySteps = header.m_steps;
+    m_hasReplayEnded = m_replayReader.GetRemaining() == 0;
+}
+
+void Brokkr::InputSystem::ResetState()
+{
+    m_frameEvents.clear();
+    m_keysDown.clear();
+    m_mouseButtons = 0;
+    m_mouseX = 0;
+    m_mouseY = 0;
+    m_isQuitRequested = false;
+    m_replaySteps = 0;
+    m_hasReplayEnded = false;
+}
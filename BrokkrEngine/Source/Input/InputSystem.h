@@ -0,0 +1,161 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Core/Core.h"
+#include "Utility/BinaryStream.h"
+
+union SDL_Event;
+
+/////////////////////////////////////////////////
+//          Input System
+//
+// Every SDL event of a frame, drained at the start of the frame into one small buffer of InputEvents. Key, mouse
+// button and mouse position state is built from those events only, so code reading input here sees the same
+// thing live and in a replay.
+//
+//  Example Use:
+//
+//      if (pInput->WasKeyPressed(SDLK_SPACE)) { Jump(); }
+//      if (pInput->IsMouseButtonDown(SDL_BUTTON_LEFT)) { Aim(pInput->GetMouseX(), pInput->GetMouseY()); }
+//
+// A recording keeps each frame's events together with the number of simulation steps the frame ran. Replaying
+// it gives the simulation the same input on the same step with the same seed and tick rate, whatever the real
+// time does, so a session runs the same way on every build (--record=path, --replay=path, see RunOptions).
+// While replaying live input is dropped, only closing the window still quits.
+//
+// Game code has to read input here and not from SDL_GetKeyboardState or its own SDL_PollEvent, or a replay
+// will not see it.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    enum class InputEventType : uint8_t
+    {
+        kQuit,
+        kKeyDown,
+        kKeyUp,
+        kMouseMove,
+        kMouseButtonDown,
+        kMouseButtonUp,
+        kMouseWheel
+    };
+
+    // 16 bytes, recorded as is
+    struct InputEvent
+    {
+        InputEventType m_type = InputEventType::kQuit;
+        uint8_t m_detail = 0;       // mouse button, or 1 for a key repeat
+        uint16_t m_modifiers = 0;   // SDL_Keymod
+        int32_t m_key = 0;          // SDL_Keycode
+        int32_t m_x = 0;            // mouse position, or the wheel amount
+        int32_t m_y = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<InputEvent> && sizeof(InputEvent) == 16, "InputEvent is written as raw bytes");
+
+    class InputSystem final : public System
+    {
+    public:
+        enum class Mode
+        {
+            kLive,
+            kRecording,
+            kReplaying
+        };
+
+        // What else a replay needs to run the same way
+        struct SessionInfo
+        {
+            uint32_t m_seed = 0;
+            double m_ticksPerSecond = 0.0;
+        };
+
+        inline static constexpr uint32_t kRecordingMagic = 0x504E4942;   // "BINP"
+        inline static constexpr uint32_t kRecordingVersion = 1;
+
+    private:
+        struct FrameHeader
+        {
+            uint16_t m_steps;
+            uint16_t m_eventCount;
+        };
+
+        // SDL's own queue holds no more than this, a frame never drains more
+        inline static constexpr size_t kMaxEventsPerFrame = UINT16_MAX;
+        inline static constexpr size_t kRecordingFlushSize = 64 * 1024;
+
+        Mode m_mode = Mode::kLive;
+
+        std::vector<InputEvent> m_frameEvents;
+        std::vector<int32_t> m_keysDown;    // sorted
+        uint32_t m_mouseButtons = 0;        // bit per SDL button
+        int32_t m_mouseX = 0;
+        int32_t m_mouseY = 0;
+        bool m_isQuitRequested = false;
+
+        std::ofstream m_recordingFile;
+        BinaryWriter m_recordingWriter;
+        std::string m_recordingPath;
+
+        BinaryReader m_replayReader;
+        int m_replaySteps = 0;
+        bool m_hasReplayEnded = false;
+        uint64_t m_frame = 0;
+
+    public:
+        explicit InputSystem(CoreSystems* pCoreManager)
+            : System(pCoreManager)
+        {
+            //
+        }
+
+        virtual ~InputSystem() override;
+        virtual void Destroy() override;
+
+        // Sessions start before the first frame, the info is written in the header
+        bool StartRecording(const std::string& path, const SessionInfo& info);
+        void StopRecording();
+        bool StartReplay(const std::string& path, SessionInfo& info);
+
+        [[nodiscard]] Mode GetMode() const { return m_mode; }
+        [[nodiscard]] bool IsReplaying() const { return m_mode == Mode::kReplaying; }
+
+        // Start of the frame: every pending SDL event, or the next recorded frame when replaying
+        void PollEvents();
+
+        // Adds an event to this frame as if SDL had sent it, ignored while replaying
+        void PushEvent(const InputEvent& event);
+
+        // End of the frame, once its simulation steps ran. Writes the frame when recording
+        void EndFrame(int stepsThisFrame);
+
+        // The steps the replayed frame ran when it was recorded
+        [[nodiscard]] int GetReplaySteps() const { return m_replaySteps; }
+
+        // True once the last recorded frame was polled, the loop ends after that frame
+        [[nodiscard]] bool HasReplayEnded() const { return m_hasReplayEnded; }
+
+        [[nodiscard]] const std::vector<InputEvent>& GetFrameEvents() const { return m_frameEvents; }
+        [[nodiscard]] bool IsQuitRequested() const { return m_isQuitRequested; }
+
+        [[nodiscard]] bool IsKeyDown(int32_t key) const;
+
+        // Went down this frame, key repeats left out
+        [[nodiscard]] bool WasKeyPressed(int32_t key) const;
+
+        [[nodiscard]] bool IsMouseButtonDown(uint8_t button) const { return button < 32 && (m_mouseButtons & (1u << button)) != 0; }
+        [[nodiscard]] int32_t GetMouseX() const { return m_mouseX; }
+        [[nodiscard]] int32_t GetMouseY() const { return m_mouseY; }
+
+    private:
+        // False for the SDL events that are not input
+        [[nodiscard]] static bool Translate(const SDL_Event& sdlEvent, InputEvent& event);
+        void Apply(const InputEvent& event);
+        void ReadReplayFrame();
+        void ResetState();
+    };
+}
@@ -0,0 +1,375 @@
+#include "JobSystem.h"
+
+#include "Core/EngineDefinitions.h"
+#include "Profiler/Profiler.h"
+
+thread_local Brokkr::JobSystem::ThreadInfo Brokkr::JobSystem::t_thread;
+
+Brokkr::JobSystem::JobSystem(CoreSystems* pCoreManager, size_t workerCount)
+    : System(pCoreManager)
+    , m_mainThread(std::this_thread::get_id())
+{
+    if (workerCount == 0)
+    {
+        const unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_queues.reserve(workerCount + 1);
+    for (size_t i = 0; i < workerCount + 1; ++i)
+    {
+        m_queues.emplace_back(std::make_unique<WorkQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+}
+
+Brokkr::JobSystem::~JobSystem()
+{
+    Stop();
+}
+
+void Brokkr::JobSystem::RegisterStages(FrameScheduler& scheduler)
+{
+    // Work queued for the main thread last frame (SDL calls) goes before anything else
+    scheduler.AddStage<&JobSystem::RunMainThreadJobs>(EngineDefinitions::STAGE_MAIN_THREAD_JOBS, FrameScheduler::Phase::kFrameStart, this);
+}
+
+void Brokkr::JobSystem::Destroy()
+{
+    Stop();
+}
+
+void Brokkr::JobSystem::Stop()
+{
+    {
+        std::lock_guard lock(m_wakeLock);
+        m_stopping.store(true);
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void Brokkr::JobSystem::Run(JobFunction pFunction, void* pContext, JobCounter* pCounter, Affinity affinity)
+{
+    if (pCounter != nullptr)
+    {
+        pCounter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const Job job{ pFunction, pContext, pCounter };
+    if (affinity == Affinity::kMainThread)
+    {
+        PushPinned(job, kMainThread);
+        return;
+    }
+
+    Push(job, GetCurrentParticipant());
+}
+
+void Brokkr::JobSystem::RunAfter(JobCounter& dependency, JobFunction pFunction, void* pContext, JobCounter* pCounter, Affinity affinity)
+{
+    {
+        // Complete() takes the same lock after the count reaches zero, so the job is either queued here or there
+        std::lock_guard lock(dependency.m_continuationLock);
+        if (!dependency.IsDone())
+        {
+            // Counted now so waiting on pCounter covers the job before it is queued
+            if (pCounter != nullptr)
+            {
+                pCounter->m_pending.fetch_add(1, std::memory_order_relaxed);
+            }
+            dependency.m_continuations.push_back({ pFunction, pContext, pCounter, static_cast<int>(affinity) });
+            return;
+        }
+    }
+
+    Run(pFunction, pContext, pCounter, affinity);
+}
+
+void Brokkr::JobSystem::Wait(const JobCounter& counter)
+{
+    BROKKR_PROFILE_SCOPE("Job Wait");
+    const size_t participant = GetCurrentParticipant();
+    while (!counter.IsDone())
+    {
+        if (!TryRunJob(participant))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void Brokkr::JobSystem::RunMainThreadJobs()
+{
+    WorkQueue& queue = *m_queues[kMainThread];
+    while (queue.m_pinnedCount.load(std::memory_order_acquire) > 0)
+    {
+        Job job;
+        {
+            std::lock_guard lock(queue.m_lock);
+            job = queue.m_pinned.front();
+            queue.m_pinned.pop_front();
+            queue.m_pinnedCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        Execute(job);
+    }
+}
+
+void Brokkr::JobSystem::Broadcast(BroadcastTask pTask, void* pContext)
+{
+    if (m_workers.empty())
+    {
+        pTask(pContext, kMainThread);
+        return;
+    }
+
+    BroadcastContext context{ pTask, pContext };
+    JobCounter counter;
+    counter.m_pending.store(static_cast<uint32_t>(m_workers.size()), std::memory_order_relaxed);
+
+    for (size_t participant = 1; participant < m_queues.size(); ++participant)
+    {
+        WorkQueue& queue = *m_queues[participant];
+        std::lock_guard lock(queue.m_lock);
+        queue.m_pinned.push_back({ &RunBroadcastShare, &context, &counter });
+        queue.m_pinnedCount.fetch_add(1, std::memory_order_release);
+    }
+    WakeWorkers(true);
+
+    pTask(pContext, kMainThread);
+    Wait(counter);
+}
+
+size_t Brokkr::JobSystem::GetCurrentParticipant() const
+{
+    if (t_thread.m_pOwner == this)
+    {
+        return t_thread.m_participant;
+    }
+
+    return std::this_thread::get_id() == m_mainThread ? kMainThread : kNotAParticipant;
+}
+
+void Brokkr::JobSystem::WorkerLoop(size_t participant)
+{
+    t_thread = { this, participant };
+
+#if BROKKR_PROFILING
+    const std::string threadName = "Worker " + std::to_string(participant);
+    BROKKR_PROFILE_THREAD_NAME(threadName.c_str());
+#endif
+    WorkQueue& ownQueue = *m_queues[participant];
+
+    while (!m_stopping.load(std::memory_order_acquire))
+    {
+        if (TryRunJob(participant))
+        {
+            continue;
+        }
+
+        std::unique_lock lock(m_wakeLock);
+        m_sleepingWorkers.fetch_add(1);
+        m_wake.wait(lock, [this, &ownQueue]()
+        {
+            return m_stopping.load() || m_queuedJobs.load() > 0 || ownQueue.m_pinnedCount.load() > 0;
+        });
+        m_sleepingWorkers.fetch_sub(1);
+    }
+}
+
+void Brokkr::JobSystem::Push(const Job& job, size_t participant)
+{
+    if (participant == kNotAParticipant)
+    {
+        std::lock_guard lock(m_sharedLock);
+        m_shared.push_back(job);
+    }
+    else
+    {
+        WorkQueue& queue = *m_queues[participant];
+        std::lock_guard lock(queue.m_lock);
+        queue.m_jobs.push_back(job);
+    }
+
+    m_queuedJobs.fetch_add(1);
+    WakeWorkers(false);
+}
+
+void Brokkr::JobSystem::PushPinned(const Job& job, size_t participant)
+{
+    WorkQueue& queue = *m_queues[participant];
+    {
+        std::lock_guard lock(queue.m_lock);
+        queue.m_pinned.push_back(job);
+        queue.m_pinnedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    if (participant != kMainThread)
+    {
+        WakeWorkers(true);
+    }
+}
+
+bool Brokkr::JobSystem::TryRunJob(size_t participant)
+{
+    Job job;
+    if (!TryTake(participant, job))
+    {
+        return false;
+    }
+
+    Execute(job);
+    return true;
+}
+
+bool Brokkr::JobSystem::TryTake(size_t participant, Job& job)
+{
+    // Pinned jobs first, nobody else can run them
+    if (participant != kNotAParticipant)
+    {
+        WorkQueue& queue = *m_queues[participant];
+        if (queue.m_pinnedCount.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard lock(queue.m_lock);
+            if (!queue.m_pinned.empty())
+            {
+                job = queue.m_pinned.front();
+                queue.m_pinned.pop_front();
+                queue.m_pinnedCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    if (m_queuedJobs.load(std::memory_order_acquire) <= 0)
+    {
+        return false;
+    }
+
+    // Own deque from the back, newest first while its data is still in cache
+    if (participant != kNotAParticipant)
+    {
+        WorkQueue& queue = *m_queues[participant];
+        std::lock_guard lock(queue.m_lock);
+        if (!queue.m_jobs.empty())
+        {
+            job = queue.m_jobs.back();
+            queue.m_jobs.pop_back();
+            m_queuedJobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard lock(m_sharedLock);
+        if (!m_shared.empty())
+        {
+            job = m_shared.front();
+            m_shared.pop_front();
+            m_queuedJobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of someone else, starting past ourselves so thieves spread out
+    const size_t queueCount = m_queues.size();
+    const size_t start = participant == kNotAParticipant ? 0 : participant + 1;
+    for (size_t i = 0; i < queueCount; ++i)
+    {
+        const size_t victim = (start + i) % queueCount;
+        if (victim == participant)
+        {
+            continue;
+        }
+
+        WorkQueue& queue = *m_queues[victim];
+        std::lock_guard lock(queue.m_lock);
+        if (!queue.m_jobs.empty())
+        {
+            job = queue.m_jobs.front();
+            queue.m_jobs.pop_front();
+            m_queuedJobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Brokkr::JobSystem::Execute(const Job& job)
+{
+    BROKKR_PROFILE_SCOPE("Job");
+    job.m_pFunction(job.m_pContext);
+    Complete(job.m_pCounter);
+}
+
+void Brokkr::JobSystem::Complete(JobCounter* pCounter)
+{
+    if (pCounter == nullptr)
+    {
+        return;
+    }
+
+    std::vector<JobCounter::Continuation> continuations;
+    {
+        // Dropping to zero under the lock, RunAfter either sees the count above zero or finds it done
+        std::lock_guard lock(pCounter->m_continuationLock);
+        if (pCounter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        continuations.swap(pCounter->m_continuations);
+    }
+
+    // The counter may be gone once a waiter sees it at zero, only the moved out list is used from here
+    for (const auto& continuation : continuations)
+    {
+        const Job job{ continuation.m_pFunction, continuation.m_pContext, continuation.m_pCounter };
+        if (static_cast<Affinity>(continuation.m_affinity) == Affinity::kMainThread)
+        {
+            PushPinned(job, kMainThread);
+        }
+        else
+        {
+            Push(job, GetCurrentParticipant());
+        }
+    }
+}
+
+void Brokkr::JobSystem::WakeWorkers(bool all)
+{
+    if (m_sleepingWorkers.load() == 0)
+    {
+        return;
+    }
+
+    {
+        // Orders the wake after a worker that is between checking for work and going to sleep
+        std::lock_guard lock(m_wakeLock);
+    }
+
+    if (all)
+    {
+        m_wake.notify_all();
+    }
+    else
+    {
+        m_wake.notify_one();
+    }
+}
+
+void Brokkr::JobSystem::RunBroadcastShare(void* pContext)
+{
+    const auto* pBroadcast = static_cast<const BroadcastContext*>(pContext);
+    pBroadcast->m_pTask(pBroadcast->m_pContext, t_thread.m_participant);
+}
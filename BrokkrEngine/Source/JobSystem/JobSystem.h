@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/Core.h"
+
+/////////////////////////////////////////////////
+//          Job System
+//
+// One pool of worker threads for the whole engine. Every participant (the main thread is participant 0, the
+// workers 1..GetWorkerCount()) has its own deque: jobs it queues go on the back and it takes them from the
+// back, idle participants steal from the front of the others'. Threads outside the pool queue into a shared
+// list instead.
+//
+//  Example Use:
+//
+//      JobCounter counter;
+//      pJobSystem->Run(&DecodeTexture, pRequest, &counter);
+//      pJobSystem->RunAfter(counter, &UploadTexture, pRequest, nullptr, JobSystem::Affinity::kMainThread);
+//
+//      pJobSystem->ParallelFor(bodies.size(), 64, [&](size_t begin, size_t end) { ... });
+//
+//      pJobSystem->Wait(counter);  // runs other jobs while it waits
+//
+// Jobs with kMainThread affinity (anything calling SDL) only run on the main thread, from Wait() or from
+// RunMainThreadJobs() which the main loop calls once a frame.
+//
+// Broadcast() runs a task once on every participant's own thread, which is what the EventManager uses to keep
+// its parallel waves deterministic. It waits for every worker, a worker busy with a long job holds it up.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    using JobFunction = void(*)(void* pContext);
+
+    class JobSystem;
+
+    // Counts the jobs still running for it. Jobs queued with RunAfter start once it reaches zero.
+    class JobCounter
+    {
+        friend class JobSystem;
+
+        struct Continuation
+        {
+            JobFunction m_pFunction;
+            void* m_pContext;
+            JobCounter* m_pCounter;
+            int m_affinity;
+        };
+
+        std::atomic<uint32_t> m_pending{ 0 };
+        std::mutex m_continuationLock;
+        std::vector<Continuation> m_continuations;
+
+    public:
+        JobCounter() = default;
+
+        // The last job drops the count to zero while holding the lock, a waiter seeing zero may not free it yet
+        ~JobCounter() { std::lock_guard lock(m_continuationLock); }
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        [[nodiscard]] bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    class JobSystem final : public System
+    {
+    public:
+        enum class Affinity
+        {
+            kAny,
+            kMainThread
+        };
+
+        // Runs once per participant, see Broadcast
+        using BroadcastTask = void(*)(void* pContext, size_t participant);
+
+        inline static constexpr size_t kMainThread = 0;
+        inline static constexpr size_t kNotAParticipant = SIZE_MAX;
+
+    private:
+        struct Job
+        {
+            JobFunction m_pFunction = nullptr;
+            void* m_pContext = nullptr;
+            JobCounter* m_pCounter = nullptr;
+        };
+
+        // Locked per participant, the owner and the odd thief are the only ones who ever touch it
+        struct WorkQueue
+        {
+            std::mutex m_lock;
+            std::deque<Job> m_jobs;
+
+            // Jobs only this participant may run (main thread affinity, broadcasts)
+            std::deque<Job> m_pinned;
+            std::atomic<size_t> m_pinnedCount{ 0 };
+        };
+
+        struct BroadcastContext
+        {
+            BroadcastTask m_pTask;
+            void* m_pContext;
+        };
+
+        // Which worker the current thread is, and of which pool
+        struct ThreadInfo
+        {
+            const JobSystem* m_pOwner = nullptr;
+            size_t m_participant = kNotAParticipant;
+        };
+
+        static thread_local ThreadInfo t_thread;
+
+        std::thread::id m_mainThread;
+        std::vector<std::thread> m_workers;
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+        // From threads outside the pool
+        std::mutex m_sharedLock;
+        std::deque<Job> m_shared;
+
+        // Stealable jobs queued and not yet taken, workers sleep while it is 0
+        std::atomic<int64_t> m_queuedJobs{ 0 };
+        std::atomic<int> m_sleepingWorkers{ 0 };
+        std::mutex m_wakeLock;
+        std::condition_variable m_wake;
+        std::atomic<bool> m_stopping{ false };
+
+    public:
+        // workerCount 0 uses one worker per hardware thread, leaving one for the main thread.
+        // The thread creating the JobSystem becomes the main thread.
+        explicit JobSystem(CoreSystems* pCoreManager, size_t workerCount = 0);
+        virtual ~JobSystem() override;
+
+        void Run(JobFunction pFunction, void* pContext, JobCounter* pCounter = nullptr, Affinity affinity = Affinity::kAny);
+
+        // Queues the job once dependency reaches zero, right away if it already has
+        void RunAfter(JobCounter& dependency, JobFunction pFunction, void* pContext, JobCounter* pCounter = nullptr, Affinity affinity = Affinity::kAny);
+
+        // Runs other jobs until the counter is done
+        void Wait(const JobCounter& counter);
+
+        // Main thread only, runs the jobs pinned to it
+        void RunMainThreadJobs();
+
+        // function(begin, end) over [0, count) in batches of at least minBatch, the calling thread joins in
+        template <typename Function>
+        void ParallelFor(size_t count, size_t minBatch, Function&& function);
+
+        // task(pContext, participant) once on each participant's own thread, returns when all are done. Main thread only.
+        void Broadcast(BroadcastTask pTask, void* pContext);
+
+        [[nodiscard]] size_t GetWorkerCount() const { return m_workers.size(); }
+        [[nodiscard]] size_t GetParticipantCount() const { return m_workers.size() + 1; }
+
+        // Participant index of the calling thread, kNotAParticipant for threads outside the pool
+        [[nodiscard]] size_t GetCurrentParticipant() const;
+
+        virtual void RegisterStages(FrameScheduler& scheduler) override;
+        virtual void Destroy() override;
+
+    private:
+        void Stop();
+        void WorkerLoop(size_t participant);
+        void Push(const Job& job, size_t participant);
+        void PushPinned(const Job& job, size_t participant);
+        bool TryRunJob(size_t participant);
+        bool TryTake(size_t participant, Job& job);
+        void Execute(const Job& job);
+        void Complete(JobCounter* pCounter);
+        void WakeWorkers(bool all);
+
+        static void RunBroadcastShare(void* pContext);
+
+        template <typename Function>
+        struct ParallelForContext
+        {
+            Function* m_pFunction;
+            size_t m_count;
+            size_t m_batchSize;
+            std::atomic<size_t> m_nextBegin{ 0 };
+
+            void RunBatches()
+            {
+                for (;;)
+                {
+                    const size_t begin = m_nextBegin.fetch_add(m_batchSize, std::memory_order_relaxed);
+                    if (begin >= m_count)
+                    {
+                        return;
+                    }
+                    (*m_pFunction)(begin, std::min(begin + m_batchSize, m_count));
+                }
+            }
+        };
+    };
+
+    template <typename Function>
+    void JobSystem::ParallelFor(size_t count, size_t minBatch, Function&& function)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // A few batches per participant so a slow batch can be balanced by the others
+        const size_t participants = GetParticipantCount();
+        const size_t batchSize = std::max<size_t>(std::max<size_t>(minBatch, 1), count / (participants * 4));
+        const size_t batchCount = (count + batchSize - 1) / batchSize;
+
+        using Context = ParallelForContext<std::remove_reference_t<Function>>;
+        Context context{ &function, count, batchSize };
+
+        // Helpers pull batches from the shared cursor, the caller does the same so nothing waits on a busy worker
+        const size_t helpers = std::min(batchCount, participants) - 1;
+        JobCounter counter;
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            Run([](void* pContext) { static_cast<Context*>(pContext)->RunBatches(); }, &context, &counter);
+        }
+
+        context.RunBatches();
+        Wait(counter);
+    }
+}
@@ -0,0 +1,144 @@
+#include "FrameStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+#include "Core/FrameScheduler.h"
+#include "Utility/AllocationTracker.h"
+
+void Brokkr::FrameStatistics::Reserve(size_t frameCount)
+{
+    m_frameMilliseconds.reserve(frameCount);
+    m_allocations.reserve(frameCount);
+    m_events.reserve(frameCount);
+}
+
+void Brokkr::FrameStatistics::SetBaseline(const HitchDetector::FrameSample& sample)
+{
+    m_lastTotals = sample;
+    m_hasLastTotals = true;
+}
+
+void Brokkr::FrameStatistics::AddFrame(const HitchDetector::FrameSample& sample, const FrameScheduler& scheduler)
+{
+    m_frameMilliseconds.push_back(sample.m_milliseconds);
+    m_events.push_back(m_hasLastTotals ? static_cast<double>(sample.m_eventsProcessed - m_lastTotals.m_eventsProcessed) : 0.0);
+    m_allocations.push_back(m_hasLastTotals ? static_cast<double>(sample.m_allocations - m_lastTotals.m_allocations) : 0.0);
+    m_allocatedBytes += m_hasLastTotals ? sample.m_allocatedBytes - m_lastTotals.m_allocatedBytes : 0;
+    m_lastTotals = sample;
+    m_hasLastTotals = true;
+
+    // Stage order only changes on a rebuild, which a benchmark does not do
+    const auto& timings = scheduler.GetStageTimings();
+    if (m_stages.size() != timings.size())
+    {
+        m_stages.clear();
+        for (const auto& timing : timings)
+        {
+            m_stages.push_back({ timing.m_pName, {} });
+            m_stages.back().m_milliseconds.reserve(m_frameMilliseconds.capacity());
+        }
+    }
+
+    for (size_t i = 0; i < timings.size(); ++i)
+    {
+        m_stages[i].m_milliseconds.push_back(timings[i].m_lastFrameMilliseconds);
+    }
+}
+
+Brokkr::FrameStatistics::Summary Brokkr::FrameStatistics::Summarize(std::vector<double> samples)
+{
+    Summary summary;
+    if (samples.empty())
+    {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double percent)
+    {
+        const auto rank = static_cast<size_t>(std::ceil(percent / 100.0 * static_cast<double>(samples.size())));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    summary.m_mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    summary.m_min = samples.front();
+    summary.m_p50 = percentile(50.0);
+    summary.m_p95 = percentile(95.0);
+    summary.m_p99 = percentile(99.0);
+    summary.m_max = samples.back();
+    return summary;
+}
+
+void Brokkr::FrameStatistics::WriteReport(std::ostream& output) const
+{
+    const auto writeRow = [&output](const char* pName, const Summary& summary)
+    {
+        output << std::left << std::setw(24) << pName << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << summary.m_mean << std::setw(10) << summary.m_p50 << std::setw(10) << summary.m_p95
+            << std::setw(10) << summary.m_p99 << std::setw(10) << summary.m_max << '\n';
+    };
+
+    const auto writeHeader = [&output](const char* pTitle)
+    {
+        output << std::left << std::setw(24) << pTitle << std::right << std::setw(10) << "mean" << std::setw(10) << "p50"
+            << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << '\n';
+    };
+
+    const std::ios::fmtflags flags = output.flags();
+    const std::streamsize precision = output.precision();
+
+    output << "===== Benchmark: " << GetFrameCount() << " frames =====\n";
+    writeHeader("Milliseconds");
+    writeRow("Frame", Summarize(m_frameMilliseconds));
+    for (const StageSamples& stage : m_stages)
+    {
+        writeRow(stage.m_pName, Summarize(stage.m_milliseconds));
+    }
+
+    output << '\n';
+    writeHeader("Per frame");
+    writeRow("Events", Summarize(m_events));
+    if (AllocationTracker::IsTracking())
+    {
+        writeRow("Allocations", Summarize(m_allocations));
+        output << "Allocated " << m_allocatedBytes << " bytes in total\n";
+    }
+    else
+    {
+        output << "Allocations not tracked, build with BROKKR_TRACK_ALLOCATIONS 1\n";
+    }
+
+    output.flags(flags);
+    output.precision(precision);
+}
+
+void Brokkr::FrameStatistics::WriteJSON(std::ostream& output) const
+{
+    const auto writeSummary = [&output](const Summary& summary)
+    {
+        output << "{\"mean\":" << summary.m_mean << ",\"min\":" << summary.m_min << ",\"p50\":" << summary.m_p50
+            << ",\"p95\":" << summary.m_p95 << ",\"p99\":" << summary.m_p99 << ",\"max\":" << summary.m_max << '}';
+    };
+
+    output << "{\n\"frames\":" << GetFrameCount() << ",\n\"frameMilliseconds\":";
+    writeSummary(Summarize(m_frameMilliseconds));
+
+    output << ",\n\"events\":";
+    writeSummary(Summarize(m_events));
+
+    output << ",\n\"allocationsTracked\":" << (AllocationTracker::IsTracking() ? "true" : "false") << ",\n\"allocations\":";
+    writeSummary(Summarize(m_allocations));
+    output << ",\n\"allocatedBytes\":" << m_allocatedBytes << ",\n\"stages\":{";
+
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+        output << (i == 0 ? "\n" : ",\n");
+        Profiler::WriteJSONString(output, m_stages[i].m_pName);
+        output << ':';
+        writeSummary(Summarize(m_stages[i].m_milliseconds));
+    }
+    output << "\n}\n}\n";
+}
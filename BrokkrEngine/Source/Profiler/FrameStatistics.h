@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "HitchDetector.h"
+
+/////////////////////////////////////////////////
+//          Frame Statistics
+//
+// Every frame of a benchmark run kept whole, so the report can give percentiles instead of an average that a
+// few bad frames disappear into. Frame time, events, allocations and every scheduler stage are summarized.
+//
+//  Example Use:
+//
+//      statistics.AddFrame(sample, scheduler);     // each measured frame, same sample as the HitchDetector
+//      ...
+//      statistics.WriteReport(std::cout);          // table for people
+//      statistics.WriteJSON(file);                 // for CI to diff against the last run
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class FrameScheduler;
+
+    class FrameStatistics
+    {
+    public:
+        struct Summary
+        {
+            double m_mean = 0.0;
+            double m_min = 0.0;
+            double m_p50 = 0.0;
+            double m_p95 = 0.0;
+            double m_p99 = 0.0;
+            double m_max = 0.0;
+        };
+
+    private:
+        struct StageSamples
+        {
+            const char* m_pName;
+            std::vector<double> m_milliseconds;
+        };
+
+        std::vector<double> m_frameMilliseconds;
+        std::vector<double> m_allocations;
+        std::vector<double> m_events;
+        std::vector<StageSamples> m_stages;
+        uint64_t m_allocatedBytes = 0;
+
+        HitchDetector::FrameSample m_lastTotals{};
+        bool m_hasLastTotals = false;
+
+    public:
+        void Reserve(size_t frameCount);
+
+        // Counts in the samples are running totals, the baseline is what the first frame's counts are taken from.
+        // Without one the first frame reports no events or allocations
+        void SetBaseline(const HitchDetector::FrameSample& sample);
+        void AddFrame(const HitchDetector::FrameSample& sample, const FrameScheduler& scheduler);
+
+        [[nodiscard]] size_t GetFrameCount() const { return m_frameMilliseconds.size(); }
+        [[nodiscard]] Summary GetFrameSummary() const { return Summarize(m_frameMilliseconds); }
+
+        void WriteReport(std::ostream& output) const;
+        void WriteJSON(std::ostream& output) const;
+
+        // Nearest rank percentiles
+        [[nodiscard]] static Summary Summarize(std::vector<double> samples);
+    };
+}
@@ -0,0 +1,230 @@
+#include "HitchDetector.h"
+
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "Core/FrameScheduler.h"
+#include "Utility/AllocationTracker.h"
+
+void Brokkr::HitchDetector::Configure(const Settings& settings)
+{
+    m_settings = settings;
+    m_settings.m_windowFrames = std::max<size_t>(m_settings.m_windowFrames, kMinimumHistory + 1);
+    m_settings.m_framesAfter = std::min(m_settings.m_framesAfter, m_settings.m_windowFrames - 1);
+
+    m_records.clear();
+    m_records.reserve(m_settings.m_windowFrames);
+    m_nextRecord = 0;
+    m_dumpAtFrame = 0;
+}
+
+Brokkr::HitchDetector::~HitchDetector()
+{
+    SetEnabled(false);
+}
+
+void Brokkr::HitchDetector::SetEnabled(bool isEnabled)
+{
+    if (m_isEnabled == isEnabled)
+    {
+        return;
+    }
+
+    m_isEnabled = isEnabled;
+    m_hasLastTotals = false;
+    m_records.clear();
+    m_nextRecord = 0;
+    m_dumpAtFrame = 0;
+
+    if (isEnabled)
+    {
+        Profiler::BeginContinuousRecording();
+    }
+    else
+    {
+        Profiler::EndContinuousRecording();
+    }
+}
+
+void Brokkr::HitchDetector::EndFrame(const FrameSample& sample, const FrameScheduler& scheduler)
+{
+    if (!m_isEnabled)
+    {
+        return;
+    }
+
+    ++m_frame;
+
+    // The median of the frames before this one, a hitch does not raise its own bar
+    double median = 0.0;
+    bool isHitch = false;
+    if (m_records.size() >= kMinimumHistory)
+    {
+        median = GetMedianMilliseconds();
+        isHitch = sample.m_milliseconds >= m_settings.m_minimumMilliseconds
+            && sample.m_milliseconds > median * m_settings.m_thresholdFactor;
+    }
+
+    // Reuses the oldest record, its vectors keep their memory so a frame costs no allocations once the ring is full
+    FrameRecord* pRecord;
+    if (m_records.size() < m_settings.m_windowFrames)
+    {
+        pRecord = &m_records.emplace_back();
+    }
+    else
+    {
+        pRecord = &m_records[m_nextRecord];
+        m_nextRecord = (m_nextRecord + 1) % m_records.size();
+    }
+    FrameRecord& record = *pRecord;
+
+    record.m_frame = m_frame;
+    record.m_startNanoseconds = sample.m_startNanoseconds;
+    record.m_milliseconds = sample.m_milliseconds;
+    record.m_medianMilliseconds = median;
+    record.m_isHitch = isHitch;
+    record.m_events = m_hasLastTotals ? sample.m_eventsProcessed - m_lastTotals.m_eventsProcessed : 0;
+    record.m_allocations = m_hasLastTotals ? sample.m_allocations - m_lastTotals.m_allocations : 0;
+    record.m_allocatedBytes = m_hasLastTotals ? sample.m_allocatedBytes - m_lastTotals.m_allocatedBytes : 0;
+
+    record.m_stages.clear();
+    for (const auto& timing : scheduler.GetStageTimings())
+    {
+        record.m_stages.push_back({ timing.m_pName, timing.m_lastFrameMilliseconds });
+    }
+
+    const auto& zones = Profiler::GetLastFrameZones();
+    record.m_zones.assign(zones.begin(), zones.end());
+
+    m_lastTotals = sample;
+    m_hasLastTotals = true;
+
+    if (isHitch)
+    {
+        ++m_hitchCount;
+
+        // Hitches while a dump is pending end up in the same one
+        if (m_dumpAtFrame == 0)
+        {
+            m_dumpAtFrame = m_frame + m_settings.m_framesAfter;
+        }
+    }
+
+    if (m_dumpAtFrame != 0 && m_frame >= m_dumpAtFrame)
+    {
+        m_dumpAtFrame = 0;
+        Dump();
+    }
+}
+
+double Brokkr::HitchDetector::GetMedianMilliseconds()
+{
+    m_sortScratch.clear();
+    for (const FrameRecord& record : m_records)
+    {
+        m_sortScratch.push_back(record.m_milliseconds);
+    }
+
+    const auto middle = m_sortScratch.begin() + static_cast<std::ptrdiff_t>(m_sortScratch.size() / 2);
+    std::nth_element(m_sortScratch.begin(), middle, m_sortScratch.end());
+    return *middle;
+}
+
+void Brokkr::HitchDetector::Dump()
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_settings.m_outputPath, error);
+
+    const std::string path = m_settings.m_outputPath + "Hitch_" + std::to_string(std::time(nullptr)) + "_" + std::to_string(m_frame) + ".json";
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "HitchDetector: could not write " << path << '\n';
+        return;
+    }
+
+    WriteWindow(file);
+    if (!file.good())
+    {
+        std::cout << "HitchDetector: could not write " << path << '\n';
+        return;
+    }
+
+    m_lastDumpPath = path;
+    std::cout << "HitchDetector: frame hitch, " << m_records.size() << " frames written to " << path << '\n';
+}
+
+void Brokkr::HitchDetector::WriteWindow(std::ostream& output) const
+{
+    // Oldest first
+    std::vector<const FrameRecord*> frames;
+    frames.reserve(m_records.size());
+    for (size_t i = 0; i < m_records.size(); ++i)
+    {
+        frames.push_back(&m_records[(m_nextRecord + i) % m_records.size()]);
+    }
+
+    if (frames.empty())
+    {
+        output << "{\"traceEvents\":[]}\n";
+        return;
+    }
+
+    const uint64_t origin = frames.front()->m_startNanoseconds;
+    std::vector<Profiler::CapturedZone> zones;
+    for (const FrameRecord* pFrame : frames)
+    {
+        zones.insert(zones.end(), pFrame->m_zones.begin(), pFrame->m_zones.end());
+    }
+
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool isFirst = true;
+    Profiler::WriteTraceEvents(output, zones, origin, isFirst);
+
+    for (const FrameRecord* pFrame : frames)
+    {
+        const uint64_t start = pFrame->m_startNanoseconds > origin ? pFrame->m_startNanoseconds - origin : 0;
+
+        output << (isFirst ? "" : ",\n") << "{\"ph\":\"C\",\"name\":\"Frame\",\"pid\":1,\"tid\":0,\"ts\":";
+        Profiler::WriteMicroseconds(output, start);
+        output << ",\"args\":{\"milliseconds\":" << pFrame->m_milliseconds << ",\"median\":" << pFrame->m_medianMilliseconds << "}},\n";
+
+        output << "{\"ph\":\"C\",\"name\":\"Events\",\"pid\":1,\"tid\":0,\"ts\":";
+        Profiler::WriteMicroseconds(output, start);
+        output << ",\"args\":{\"processed\":" << pFrame->m_events << "}},\n";
+
+        output << "{\"ph\":\"C\",\"name\":\"Allocations\",\"pid\":1,\"tid\":0,\"ts\":";
+        Profiler::WriteMicroseconds(output, start);
+        output << ",\"args\":{\"count\":" << pFrame->m_allocations << ",\"bytes\":" << pFrame->m_allocatedBytes << "}}";
+
+        if (pFrame->m_isHitch)
+        {
+            output << ",\n{\"ph\":\"i\",\"s\":\"g\",\"name\":\"Hitch\",\"pid\":1,\"tid\":0,\"ts\":";
+            Profiler::WriteMicroseconds(output, start);
+            output << ",\"args\":{\"frame\":" << pFrame->m_frame << ",\"milliseconds\":" << pFrame->m_milliseconds << "}}";
+        }
+        isFirst = false;
+    }
+
+    output << "\n],\n\"allocationsTracked\":" << (AllocationTracker::IsTracking() ? "true" : "false") << ",\n\"frames\":[\n";
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        const FrameRecord& frame = *frames[i];
+        output << (i == 0 ? "" : ",\n") << "{\"frame\":" << frame.m_frame << ",\"milliseconds\":" << frame.m_milliseconds
+            << ",\"median\":" << frame.m_medianMilliseconds << ",\"hitch\":" << (frame.m_isHitch ? "true" : "false")
+            << ",\"events\":" << frame.m_events << ",\"allocations\":" << frame.m_allocations
+            << ",\"allocatedBytes\":" << frame.m_allocatedBytes << ",\"stages\":{";
+
+        for (size_t stage = 0; stage < frame.m_stages.size(); ++stage)
+        {
+            output << (stage == 0 ? "" : ",");
+            Profiler::WriteJSONString(output, frame.m_stages[stage].m_pName);
+            output << ':' << frame.m_stages[stage].m_milliseconds;
+        }
+        output << "}}";
+    }
+    output << "\n]}\n";
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Profiler.h"
+
+/////////////////////////////////////////////////
+//          Hitch Detector
+//
+// Catches the one slow frame instead of the average. A rolling window of the last frames is kept with their
+// stage timings, event and allocation counts and profiler zones. A frame slower than the threshold times the
+// window's median (and slower than a floor, so a fast idle game does not report 2ms frames) marks a hitch, a few
+// frames later the whole window, before and after, is written out for offline analysis.
+//
+//  Example Use:
+//
+//      detector.Configure({ 120, 2.0, 4.0, 10, "Profiles/Hitches/" });
+//      detector.SetEnabled(true);
+//
+//      // end of every frame, counts are totals since the start
+//      detector.EndFrame({ frameStart, workMilliseconds, pEventManager->GetProcessedCount(),
+//          AllocationTracker::GetAllocationCount(), AllocationTracker::GetAllocatedBytes() }, scheduler);
+//
+// The dump is a Chrome trace (chrome://tracing, Perfetto): the zones of every frame in the window, counters for
+// frame time, events and allocations, an instant event per hitch, and a "frames" table with the per stage timings
+// alongside the trace events. Enabling it keeps the Profiler recording all the time, until every enabled
+// detector is disabled or destroyed.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class FrameScheduler;
+
+    class HitchDetector
+    {
+    public:
+        struct Settings
+        {
+            size_t m_windowFrames = 120;            // frames kept and written, before and after the hitch
+            double m_thresholdFactor = 2.0;         // times the median frame
+            double m_minimumMilliseconds = 4.0;     // never a hitch below this
+            size_t m_framesAfter = 10;              // of the window, how many follow the hitch
+            std::string m_outputPath;
+        };
+
+        // Counts are running totals, the detector keeps the per frame difference
+        struct FrameSample
+        {
+            uint64_t m_startNanoseconds;            // Profiler::GetNanoseconds() when the frame started
+            double m_milliseconds;                  // work time, pacing left out
+            uint64_t m_eventsProcessed;
+            uint64_t m_allocations;
+            uint64_t m_allocatedBytes;
+        };
+
+    private:
+        struct StageSample
+        {
+            const char* m_pName;
+            double m_milliseconds;
+        };
+
+        struct FrameRecord
+        {
+            uint64_t m_frame = 0;
+            uint64_t m_startNanoseconds = 0;
+            double m_milliseconds = 0.0;
+            double m_medianMilliseconds = 0.0;
+            uint64_t m_events = 0;
+            uint64_t m_allocations = 0;
+            uint64_t m_allocatedBytes = 0;
+            bool m_isHitch = false;
+            std::vector<StageSample> m_stages;
+            std::vector<Profiler::CapturedZone> m_zones;
+        };
+
+        // Detection needs a median worth trusting
+        inline static constexpr size_t kMinimumHistory = 30;
+
+        Settings m_settings;
+        bool m_isEnabled = false;
+
+        // Ring of the last m_windowFrames frames, m_nextRecord is the oldest once it is full
+        std::vector<FrameRecord> m_records;
+        size_t m_nextRecord = 0;
+        uint64_t m_frame = 0;
+
+        FrameSample m_lastTotals{};
+        bool m_hasLastTotals = false;
+
+        // Frame the pending dump is written at, 0 for none
+        uint64_t m_dumpAtFrame = 0;
+        uint64_t m_hitchCount = 0;
+        std::string m_lastDumpPath;
+        std::vector<double> m_sortScratch;
+
+    public:
+        HitchDetector() = default;
+        HitchDetector(const HitchDetector&) = delete;
+        HitchDetector& operator=(const HitchDetector&) = delete;
+        ~HitchDetector();
+
+        void Configure(const Settings& settings);
+        void SetEnabled(bool isEnabled);
+        [[nodiscard]] bool IsEnabled() const { return m_isEnabled; }
+
+        // Once per frame, after Profiler::EndFrame() so the frame's zones are there
+        void EndFrame(const FrameSample& sample, const FrameScheduler& scheduler);
+
+        [[nodiscard]] uint64_t GetHitchCount() const { return m_hitchCount; }
+        [[nodiscard]] const std::string& GetLastDumpPath() const { return m_lastDumpPath; }
+
+        // The current window as a trace, what a dump writes
+        void WriteWindow(std::ostream& output) const;
+
+    private:
+        [[nodiscard]] double GetMedianMilliseconds();
+        void Dump();
+    };
+}
@@ -0,0 +1,458 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+
+#include "Core/EngineDefinitions.h"
+#include "Utility/BinaryStream.h"
+
+thread_local Brokkr::Profiler::ThreadBufferOwner Brokkr::Profiler::t_bufferOwner;
+
+Brokkr::Profiler::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    if (m_pBuffer == nullptr)
+    {
+        return;
+    }
+
+    // Zones the next EndFrame() still has to collect keep the buffer until then
+    std::lock_guard lock(s_threadsLock);
+    m_pBuffer->m_hasEnded = true;
+    ReleaseEndedThreads();
+}
+
+void Brokkr::Profiler::Record(const char* pName, uint64_t start, uint64_t end)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    if (buffer.m_pZones == nullptr)
+    {
+        AllocateRing(buffer);
+    }
+
+    // Only this thread writes, publishing the count is all the reader needs
+    const uint64_t written = buffer.m_written.load(std::memory_order_relaxed);
+    (*buffer.m_pZones)[written % kRingCapacity] = { pName, start, end };
+    buffer.m_written.store(written + 1, std::memory_order_release);
+}
+
+void Brokkr::Profiler::SetThreadName(const char* pName)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard lock(s_threadsLock);
+    buffer.m_name = pName;
+}
+
+void Brokkr::Profiler::RequestCapture(uint32_t frameCount, Format format, const std::string& outputPath)
+{
+    if (frameCount == 0 || IsCapturing())
+    {
+        return;
+    }
+
+    s_requestedFrames = frameCount;
+    s_format = format;
+    s_outputPath = outputPath;
+}
+
+bool Brokkr::Profiler::ConfigureFromCommandLine(int argc, char* argv[])
+{
+    uint32_t frames = 0;
+    Format format = Format::kChromeTrace;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        if (argument == "--profile")
+        {
+            frames = static_cast<uint32_t>(EngineDefinitions::PROFILE_CAPTURE_FRAMES);
+        }
+        else if (argument.substr(0, 10) == "--profile=")
+        {
+            frames = static_cast<uint32_t>(std::strtoul(argv[i] + 10, nullptr, 10));
+        }
+        else if (argument == "--profile-format=binary")
+        {
+            format = Format::kBinary;
+        }
+    }
+
+    RequestCapture(frames, format);
+    return frames > 0;
+}
+
+void Brokkr::Profiler::EndFrame()
+{
+    if (IsRecording())
+    {
+        s_lastFrameZones.clear();
+        Collect(s_lastFrameZones);
+    }
+
+    if (s_remainingFrames > 0)
+    {
+        s_captured.insert(s_captured.end(), s_lastFrameZones.begin(), s_lastFrameZones.end());
+        ++s_capturedFrames;
+        if (--s_remainingFrames == 0)
+        {
+            FinishCapture();
+        }
+    }
+    else if (s_requestedFrames > 0)
+    {
+        StartCapture();
+    }
+}
+
+void Brokkr::Profiler::BeginContinuousRecording()
+{
+    if (s_continuousHolders++ > 0)
+    {
+        return;
+    }
+
+    if (!IsRecording())
+    {
+        // Nothing from before this point belongs to the next frame
+        std::lock_guard lock(s_threadsLock);
+        ReleaseEndedThreads();
+        for (const auto& pBuffer : s_threads)
+        {
+            pBuffer->m_collected = pBuffer->m_written.load(std::memory_order_acquire);
+        }
+    }
+
+    Calibrate();
+    UpdateRecordingFlag();
+}
+
+void Brokkr::Profiler::EndContinuousRecording()
+{
+    if (s_continuousHolders == 0 || --s_continuousHolders > 0)
+    {
+        return;
+    }
+
+    s_lastFrameZones.clear();
+    Calibrate();
+    UpdateRecordingFlag();
+}
+
+uint64_t Brokkr::Profiler::ToNanoseconds(uint64_t ticks)
+{
+#if BROKKR_PROFILE_TSC
+    const double offset = static_cast<double>(static_cast<int64_t>(ticks - s_referenceTicks)) * s_nanosecondsPerTick;
+    const double nanoseconds = static_cast<double>(s_referenceNanoseconds) + offset;
+    return nanoseconds > 0.0 ? static_cast<uint64_t>(nanoseconds) : 0;
+#else
+    return ticks;
+#endif
+}
+
+size_t Brokkr::Profiler::GetThreadCount()
+{
+    std::lock_guard lock(s_threadsLock);
+    return s_threads.size();
+}
+
+Brokkr::Profiler::ThreadBuffer& Brokkr::Profiler::GetThreadBuffer()
+{
+    if (t_bufferOwner.m_pBuffer == nullptr)
+    {
+        std::lock_guard lock(s_threadsLock);
+        auto pBuffer = std::make_unique<ThreadBuffer>();
+        pBuffer->m_threadIndex = s_nextThreadIndex++;    // never reused, a capture can hold an ended thread's zones
+        pBuffer->m_name = "Thread " + std::to_string(pBuffer->m_threadIndex);
+        t_bufferOwner.m_pBuffer = pBuffer.get();
+        s_threads.emplace_back(std::move(pBuffer));
+    }
+
+    return *t_bufferOwner.m_pBuffer;
+}
+
+void Brokkr::Profiler::AllocateRing(ThreadBuffer& buffer)
+{
+    {
+        std::lock_guard lock(s_threadsLock);
+        if (!s_freeRings.empty())
+        {
+            buffer.m_pZones = std::move(s_freeRings.back());
+            s_freeRings.pop_back();
+            return;
+        }
+    }
+
+    // Collect() reads the pointer under the lock
+    auto pZones = std::make_unique<Ring>();
+    std::lock_guard lock(s_threadsLock);
+    buffer.m_pZones = std::move(pZones);
+}
+
+void Brokkr::Profiler::ReleaseEndedThreads()
+{
+    // Called with s_threadsLock held. Outside a recording whatever an ended thread left is stale anyway.
+    const bool isRecording = IsRecording();
+    for (auto thread = s_threads.begin(); thread != s_threads.end();)
+    {
+        ThreadBuffer& buffer = **thread;
+        if (!buffer.m_hasEnded || (isRecording && buffer.m_written.load(std::memory_order_acquire) != buffer.m_collected))
+        {
+            ++thread;
+            continue;
+        }
+
+        if (buffer.m_pZones != nullptr && s_freeRings.size() < kMaxFreeRings)
+        {
+            s_freeRings.push_back(std::move(buffer.m_pZones));
+        }
+        thread = s_threads.erase(thread);
+    }
+}
+
+void Brokkr::Profiler::StartCapture()
+{
+    // Zones left over from an earlier capture are not part of this one
+    if (!IsRecording())
+    {
+        std::lock_guard lock(s_threadsLock);
+        ReleaseEndedThreads();
+        for (const auto& pBuffer : s_threads)
+        {
+            pBuffer->m_collected = pBuffer->m_written.load(std::memory_order_acquire);
+        }
+    }
+
+    s_captured.clear();
+    s_droppedZones = 0;
+    s_capturedFrames = 0;
+    s_remainingFrames = s_requestedFrames;
+    s_requestedFrames = 0;
+    s_captureStartNanoseconds = GetNanoseconds();
+    Calibrate();
+    UpdateRecordingFlag();
+}
+
+void Brokkr::Profiler::Collect(std::vector<CapturedZone>& zones)
+{
+    std::lock_guard lock(s_threadsLock);
+    for (const auto& pBuffer : s_threads)
+    {
+        ThreadBuffer& buffer = *pBuffer;
+        const uint64_t written = buffer.m_written.load(std::memory_order_acquire);
+
+        // More than a ring behind, the oldest ones are already overwritten
+        uint64_t from = buffer.m_collected;
+        if (written - from > kRingCapacity)
+        {
+            s_droppedZones += written - kRingCapacity - from;
+            from = written - kRingCapacity;
+        }
+
+        const size_t firstNew = zones.size();
+        for (uint64_t i = from; i < written; ++i)
+        {
+            const Zone& zone = (*buffer.m_pZones)[i % kRingCapacity];
+            zones.push_back({ zone.m_pName, zone.m_startTicks, zone.m_endTicks, buffer.m_threadIndex });
+        }
+
+        // The thread kept going while we copied, anything it lapped may be torn
+        const uint64_t writtenAfter = buffer.m_written.load(std::memory_order_acquire);
+        if (writtenAfter - from > kRingCapacity)
+        {
+            const uint64_t torn = std::min<uint64_t>(writtenAfter - kRingCapacity - from, written - from);
+            zones.erase(zones.begin() + static_cast<std::ptrdiff_t>(firstNew), zones.begin() + static_cast<std::ptrdiff_t>(firstNew + torn));
+            s_droppedZones += torn;
+        }
+
+        buffer.m_collected = written;
+    }
+
+    ReleaseEndedThreads();
+}
+
+void Brokkr::Profiler::FinishCapture()
+{
+    UpdateRecordingFlag();
+
+    std::string path = s_outputPath;
+    if (path.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(EngineDefinitions::PROFILE_OUTPUT_PATH, error);
+        path = std::string(EngineDefinitions::PROFILE_OUTPUT_PATH) + "Profile_" + std::to_string(std::time(nullptr))
+            + (s_format == Format::kBinary ? ".bprof" : ".json");
+    }
+
+    const bool isWritten = s_format == Format::kBinary ? WriteBinary(path) : WriteChromeTrace(path);
+    if (isWritten)
+    {
+        s_lastCapturePath = path;
+        std::cout << "Profiler: " << s_capturedFrames << " frames, " << s_captured.size() << " zones written to " << path;
+        if (s_droppedZones > 0)
+        {
+            std::cout << " (" << s_droppedZones << " dropped)";
+        }
+        std::cout << '\n';
+    }
+    else
+    {
+        std::cout << "Profiler: could not write " << path << '\n';
+    }
+
+    s_captured.clear();
+    s_captured.shrink_to_fit();
+}
+
+void Brokkr::Profiler::Calibrate()
+{
+#if BROKKR_PROFILE_TSC
+    if (s_referenceTicks == 0)
+    {
+        s_referenceTicks = Now();
+        s_referenceNanoseconds = GetNanoseconds();
+        return;
+    }
+
+    // The counter runs at a fixed rate on anything recent, the longer the span the better the rate
+    const uint64_t elapsedTicks = Now() - s_referenceTicks;
+    const uint64_t elapsedNanoseconds = GetNanoseconds() - s_referenceNanoseconds;
+    if (elapsedTicks > 0)
+    {
+        s_nanosecondsPerTick = static_cast<double>(elapsedNanoseconds) / static_cast<double>(elapsedTicks);
+    }
+#endif
+}
+
+void Brokkr::Profiler::UpdateRecordingFlag()
+{
+    s_isRecording.store(IsContinuousRecording() || s_remainingFrames > 0, std::memory_order_relaxed);
+}
+
+bool Brokkr::Profiler::WriteChromeTrace(const std::string& path)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool isFirst = true;
+    WriteTraceEvents(file, s_captured, s_captureStartNanoseconds, isFirst);
+    file << "\n]}\n";
+    return file.good();
+}
+
+void Brokkr::Profiler::WriteTraceEvents(std::ostream& output, const std::vector<CapturedZone>& zones, uint64_t originNanoseconds, bool& isFirst)
+{
+    Calibrate();
+
+    {
+        std::lock_guard lock(s_threadsLock);
+        for (const auto& pBuffer : s_threads)
+        {
+            output << (isFirst ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << pBuffer->m_threadIndex << ",\"args\":{\"name\":";
+            WriteJSONString(output, pBuffer->m_name.c_str());
+            output << "}}";
+            isFirst = false;
+        }
+    }
+
+    for (const CapturedZone& zone : zones)
+    {
+        // Zones opened before the origin start at 0
+        const uint64_t start = std::max(ToNanoseconds(zone.m_startTicks), originNanoseconds);
+        const uint64_t end = std::max(ToNanoseconds(zone.m_endTicks), start);
+        output << (isFirst ? "" : ",\n") << "{\"ph\":\"X\",\"name\":";
+        WriteJSONString(output, zone.m_pName);
+        output << ",\"pid\":1,\"tid\":" << zone.m_threadIndex << ",\"ts\":";
+        WriteMicroseconds(output, start - originNanoseconds);
+        output << ",\"dur\":";
+        WriteMicroseconds(output, end - start);
+        output << '}';
+        isFirst = false;
+    }
+}
+
+void Brokkr::Profiler::WriteJSONString(std::ostream& output, const char* pText)
+{
+    output << '"';
+    for (const char* pChar = pText; *pChar != '\0'; ++pChar)
+    {
+        if (*pChar == '"' || *pChar == '\\')
+        {
+            output << '\\';
+        }
+        output << *pChar;
+    }
+    output << '"';
+}
+
+void Brokkr::Profiler::WriteMicroseconds(std::ostream& output, uint64_t nanoseconds)
+{
+    // The nanoseconds kept as decimals
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned long long>(nanoseconds % 1000));
+    output << text;
+}
+
+bool Brokkr::Profiler::WriteBinary(const std::string& path)
+{
+    //  Layout, little endian:
+    //      magic, version, frame count, capture start (ns since the program started)
+    //      thread count, then per thread: index, name
+    //      name count, then the names, zones refer to them by position
+    //      zone count, then per zone: name index, thread index, start (ns from capture start), duration (ns)
+    Calibrate();
+
+    std::unordered_map<std::string_view, uint32_t> nameIndices;
+    std::vector<const char*> names;
+    for (const CapturedZone& zone : s_captured)
+    {
+        if (nameIndices.emplace(zone.m_pName, static_cast<uint32_t>(names.size())).second)
+        {
+            names.push_back(zone.m_pName);
+        }
+    }
+
+    BinaryWriter writer;
+    writer.Write(kBinaryMagic);
+    writer.Write(kBinaryVersion);
+    writer.Write(s_capturedFrames);
+    writer.Write(s_captureStartNanoseconds);
+
+    {
+        std::lock_guard lock(s_threadsLock);
+        writer.Write(static_cast<uint32_t>(s_threads.size()));
+        for (const auto& pBuffer : s_threads)
+        {
+            writer.Write(pBuffer->m_threadIndex);
+            writer.WriteString(pBuffer->m_name);
+        }
+    }
+
+    writer.Write(static_cast<uint32_t>(names.size()));
+    for (const char* pName : names)
+    {
+        writer.WriteString(pName);
+    }
+
+    writer.Write(static_cast<uint32_t>(s_captured.size()));
+    for (const CapturedZone& zone : s_captured)
+    {
+        const uint64_t start = std::max(ToNanoseconds(zone.m_startTicks), s_captureStartNanoseconds);
+        const uint64_t end = std::max(ToNanoseconds(zone.m_endTicks), start);
+        writer.Write(nameIndices[zone.m_pName]);
+        writer.Write(zone.m_threadIndex);
+        writer.Write(start - s_captureStartNanoseconds);
+        writer.Write(end - start);
+    }
+
+    return writer.SaveToFile(path.c_str());
+}
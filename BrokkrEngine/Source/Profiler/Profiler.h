@@ -0,0 +1,260 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BROKKR_PROFILE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BROKKR_PROFILE_TSC 1
+#else
+#define BROKKR_PROFILE_TSC 0
+#endif
+
+/////////////////////////////////////////////////
+//          Profiler
+//
+// Hierarchical CPU zones for whole frames. A zone is a named scope, timed when it opens and closes and written
+// into a ring buffer owned by the thread it ran on, so recording takes no lock. Zones nest by time, the viewer
+// works out the hierarchy.
+//
+//  Example Use:
+//
+//      void PhysicsManager::ProcessUpdate()
+//      {
+//          BROKKR_PROFILE_FUNCTION();
+//          ...
+//          {
+//              BROKKR_PROFILE_SCOPE("Broad Phase");
+//              ...
+//          }
+//      }
+//
+//      Profiler::RequestCapture(120);      // the next 120 frames, also F11 or --profile on the command line
+//
+// Nothing is recorded outside a capture, a zone then costs one relaxed load. While recording, x86 builds read the
+// time stamp counter (a few ns, steady_clock can be ten times that) and turn ticks into nanoseconds against
+// steady_clock when the zones are written.
+//
+// Continuous recording (every enabled HitchDetector holds it on) records every frame and keeps the zones of the
+// last one in GetLastFrameZones() until the next EndFrame(). The capture is collected from the
+// buffers at every EndFrame() and written when it ends, as Chrome trace_event JSON (chrome://tracing, Perfetto)
+// or a compact binary file. Zone names are kept as pointers and have to outlive the capture, use literals.
+// A thread gets its ring with its first zone and gives it back when it ends, for the next thread to reuse.
+//
+// Define BROKKR_PROFILING 0 to compile every macro out.
+/////////////////////////////////////////////////
+
+#ifndef BROKKR_PROFILING
+#define BROKKR_PROFILING 1
+#endif
+
+namespace Brokkr
+{
+    class Profiler
+    {
+    public:
+        enum class Format
+        {
+            kChromeTrace,
+            kBinary
+        };
+
+        inline static constexpr uint32_t kBinaryMagic = 0x46525042;   // "BPRF"
+        inline static constexpr uint32_t kBinaryVersion = 1;
+
+        // Zones per thread between two EndFrame() calls before the oldest get dropped
+        inline static constexpr size_t kRingCapacity = 1 << 15;
+
+        struct Zone
+        {
+            const char* m_pName;
+            uint64_t m_startTicks;
+            uint64_t m_endTicks;
+        };
+
+        struct CapturedZone
+        {
+            const char* m_pName;
+            uint64_t m_startTicks;
+            uint64_t m_endTicks;
+            uint32_t m_threadIndex;
+        };
+
+        // Times the enclosing scope, only records if a capture was running when it opened
+        class ScopedZone
+        {
+            const char* m_pName;
+            uint64_t m_start;
+
+        public:
+            explicit ScopedZone(const char* pName)
+                : m_pName(pName)
+                , m_start(IsRecording() ? Now() : 0)
+            {
+                //
+            }
+
+            ~ScopedZone()
+            {
+                if (m_start != 0)
+                {
+                    Record(m_pName, m_start, Now());
+                }
+            }
+
+            ScopedZone(const ScopedZone&) = delete;
+            ScopedZone& operator=(const ScopedZone&) = delete;
+        };
+
+    private:
+        using Ring = std::array<Zone, kRingCapacity>;
+
+        // Rings kept for the next threads once theirs ended, the rest are freed
+        inline static constexpr size_t kMaxFreeRings = 8;
+
+        // Written only by its thread, read by the main thread at EndFrame()
+        struct ThreadBuffer
+        {
+            std::unique_ptr<Ring> m_pZones;     // on the first zone, threads that only name themselves get none
+            std::atomic<uint64_t> m_written{ 0 };
+            uint64_t m_collected = 0;
+            uint32_t m_threadIndex = 0;
+            std::string m_name;
+            bool m_hasEnded = false;            // the thread is gone, released once its zones are collected
+        };
+
+        // Hands the thread's buffer back when the thread ends
+        struct ThreadBufferOwner
+        {
+            ThreadBuffer* m_pBuffer = nullptr;
+            ~ThreadBufferOwner();
+        };
+
+        inline static std::atomic<bool> s_isRecording{ false };
+        inline static const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+        static thread_local ThreadBufferOwner t_bufferOwner;
+
+        // Live threads, and ended ones until their last zones are collected
+        inline static std::mutex s_threadsLock;
+        inline static std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+        inline static std::vector<std::unique_ptr<Ring>> s_freeRings;
+        inline static uint32_t s_nextThreadIndex = 0;
+
+        // Holders of continuous recording, it stays on until the last one lets go
+        inline static uint32_t s_continuousHolders = 0;
+        inline static std::vector<CapturedZone> s_lastFrameZones;
+
+        // Ticks to nanoseconds, the rate is measured from this point to the latest write
+        inline static uint64_t s_referenceTicks = 0;
+        inline static uint64_t s_referenceNanoseconds = 0;
+        inline static double s_nanosecondsPerTick = 1.0;
+
+        // Capture state, main thread only
+        inline static uint32_t s_requestedFrames = 0;
+        inline static uint32_t s_remainingFrames = 0;
+        inline static Format s_format = Format::kChromeTrace;
+        inline static std::string s_outputPath;
+        inline static std::vector<CapturedZone> s_captured;
+        inline static uint64_t s_captureStartNanoseconds = 0;
+        inline static uint32_t s_capturedFrames = 0;
+        inline static uint64_t s_droppedZones = 0;
+        inline static std::string s_lastCapturePath;
+
+    public:
+        // Zone timestamp, never 0. Time stamp counter ticks where there is one, nanoseconds otherwise.
+        [[nodiscard]] static uint64_t Now()
+        {
+#if BROKKR_PROFILE_TSC
+            return __rdtsc();
+#else
+            return GetNanoseconds();
+#endif
+        }
+
+        // Since the program started, never 0
+        [[nodiscard]] static uint64_t GetNanoseconds()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count()) + 1;
+        }
+
+        [[nodiscard]] static bool IsRecording() { return s_isRecording.load(std::memory_order_relaxed); }
+
+        static void Record(const char* pName, uint64_t start, uint64_t end);
+
+        // Shown as the thread's name in the trace
+        static void SetThreadName(const char* pName);
+
+        // Starts with the next frame, empty path picks one under EngineDefinitions::PROFILE_OUTPUT_PATH
+        static void RequestCapture(uint32_t frameCount, Format format = Format::kChromeTrace, const std::string& outputPath = {});
+
+        // --profile[=frames] and --profile-format=binary, true if a capture was requested
+        static bool ConfigureFromCommandLine(int argc, char* argv[]);
+
+        // Main thread, once per frame: starts a requested capture, collects the buffers and finishes the capture
+        static void EndFrame();
+
+        // Records all the time, not just during a capture. Counted, every Begin needs its End
+        static void BeginContinuousRecording();
+        static void EndContinuousRecording();
+        [[nodiscard]] static bool IsContinuousRecording() { return s_continuousHolders > 0; }
+        [[nodiscard]] static uint32_t GetContinuousRecordingHolders() { return s_continuousHolders; }
+
+        // Everything recorded up to the last EndFrame() since the one before, empty unless recording
+        [[nodiscard]] static const std::vector<CapturedZone>& GetLastFrameZones() { return s_lastFrameZones; }
+
+        // A zone timestamp in nanoseconds since the program started, like GetNanoseconds()
+        [[nodiscard]] static uint64_t ToNanoseconds(uint64_t ticks);
+
+        // trace_event objects for the thread names and zones, ts relative to originNanoseconds. For files that add
+        // their own events around them, see HitchDetector.
+        static void WriteTraceEvents(std::ostream& output, const std::vector<CapturedZone>& zones, uint64_t originNanoseconds, bool& isFirst);
+        static void WriteJSONString(std::ostream& output, const char* pText);
+        static void WriteMicroseconds(std::ostream& output, uint64_t nanoseconds);
+
+        [[nodiscard]] static bool IsCapturing() { return s_remainingFrames > 0 || s_requestedFrames > 0; }
+
+        // Threads with a buffer, an ended one until its last zones are collected
+        [[nodiscard]] static size_t GetThreadCount();
+        [[nodiscard]] static const std::string& GetLastCapturePath() { return s_lastCapturePath; }
+
+        // Zones lost to a full ring in the last capture, raise kRingCapacity if this is not 0
+        [[nodiscard]] static uint64_t GetDroppedZones() { return s_droppedZones; }
+
+        // Writes the zones collected so far, what EndFrame() does once the capture is over
+        static bool WriteChromeTrace(const std::string& path);
+        static bool WriteBinary(const std::string& path);
+
+    private:
+        static ThreadBuffer& GetThreadBuffer();
+        static void AllocateRing(ThreadBuffer& buffer);
+        static void ReleaseEndedThreads();
+        static void StartCapture();
+        static void Collect(std::vector<CapturedZone>& zones);
+        static void FinishCapture();
+        static void Calibrate();
+        static void UpdateRecordingFlag();
+    };
+}
+
+#if BROKKR_PROFILING
+#define BROKKR_PROFILE_CONCAT_INNER(a, b) a##b
+#define BROKKR_PROFILE_CONCAT(a, b) BROKKR_PROFILE_CONCAT_INNER(a, b)
+#define BROKKR_PROFILE_SCOPE(name) const ::Brokkr::Profiler::ScopedZone BROKKR_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define BROKKR_PROFILE_FUNCTION() BROKKR_PROFILE_SCOPE(__func__)
+#define BROKKR_PROFILE_THREAD_NAME(name) ::Brokkr::Profiler::SetThreadName(name)
+#define BROKKR_PROFILE_END_FRAME() ::Brokkr::Profiler::EndFrame()
+#else
+#define BROKKR_PROFILE_SCOPE(name) ((void)0)
+#define BROKKR_PROFILE_FUNCTION() ((void)0)
+#define BROKKR_PROFILE_THREAD_NAME(name) ((void)0)
+#define BROKKR_PROFILE_END_FRAME() ((void)0)
+#endif
@@ -3,7 +3,9 @@
 #include <cassert>
 #include <string>
 
+#include "Core/EngineDefinitions.h"
 #include "Entity/GameEntityManager/GameEntityManager.h"
+#include "Profiler/Profiler.h"
 
 void Brokkr::SceneManager::Init()
 {
@@ -84,6 +86,7 @@ void Brokkr::SceneManager::SetActiveState(const std::string& stateIdentifier)
 
 void Brokkr::SceneManager::ProcessStateChange()
 {
+    BROKKR_PROFILE_FUNCTION();
     if (m_isReplacing)
     {
         auto stateIter = m_states.find(m_pendingStateKey);
@@ -123,6 +126,11 @@ Brokkr::Scene* Brokkr::SceneManager::GetActiveState()
     return m_pActiveState;
 }
 
+void Brokkr::SceneManager::RegisterStages(FrameScheduler& scheduler)
+{
+    scheduler.AddStage<&SceneManager::UpdateActiveState>(EngineDefinitions::STAGE_SCENE_UPDATE, FrameScheduler::Phase::kSimulation, this);
+}
+
 void Brokkr::SceneManager::Destroy()
 {
     for (const auto& [key, state] : m_states)
@@ -40,6 +40,7 @@ namespace Brokkr
         void SetActiveState(const std::string& stateIdentifier);
         void ResetState(const std::string& stateIdentifier);
 
+        virtual void RegisterStages(FrameScheduler& scheduler) override;
         virtual void Destroy() override;
         
     protected: // Only calls these two in core main game loop
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Entity/GameEntity/Component/ComponentPool.h"
+#include "UnitTests/UnitTestSystem.h"
+
+namespace Brokkr
+{
+    class ComponentPoolTest
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Around the size of a real component, the string allocates like the ones holding names or paths do
+        class PooledComponent final : public Component
+        {
+            std::string m_name;
+            double m_values[4] = {};
+
+        public:
+            explicit PooledComponent(int index)
+                : m_name("Pooled component with a name past the small string buffer " + std::to_string(index))
+            {
+                m_values[0] = index;
+            }
+
+            virtual bool Init() override { return true; }
+            virtual void Update() override {}
+            virtual void Destroy() override {}
+
+            [[nodiscard]] double GetValue() const { return m_values[0]; }
+        };
+
+        // Freed in any order, a reset pool hands the slots out front to back again
+        static bool TestResetIsContiguous()
+        {
+            constexpr size_t kCount = 200;     // a few chunks
+            PoolAllocator<double, 64> pool;
+
+            std::vector<void*> slots;
+            for (size_t i = 0; i < kCount; ++i)
+            {
+                slots.push_back(pool.Allocate());
+            }
+
+            // Every other one first, then the rest backwards, so the free list is scrambled
+            for (size_t i = 0; i < kCount; i += 2)
+            {
+                pool.Deallocate(slots[i]);
+            }
+            if (pool.Reset())
+            {
+                return false;   // still has live slots
+            }
+            for (size_t i = kCount - 1; i < kCount; i -= 2)
+            {
+                pool.Deallocate(slots[i]);
+            }
+
+            if (!pool.Reset())
+            {
+                return false;
+            }
+
+            const PoolStats stats = pool.GetStats();
+            auto* pPrevious = static_cast<double*>(pool.Allocate());
+            size_t contiguous = 1;
+            for (size_t i = 1; i < 64; ++i)
+            {
+                auto* pNext = static_cast<double*>(pool.Allocate());
+                contiguous += reinterpret_cast<char*>(pNext) - reinterpret_cast<char*>(pPrevious) == sizeof(double) ? 1 : 0;
+                pPrevious = pNext;
+            }
+
+            return contiguous == 64 && stats.m_liveCount == 0 && stats.m_peakCount == kCount
+                && stats.m_capacity == 256 && stats.m_chunkAllocations == 4 && pool.GetStats().m_chunkAllocations == 4;
+        }
+
+        // Spawning and tearing down a scene worth of components: make_unique against the pool
+        static bool BenchmarkAgainstMakeUnique()
+        {
+            constexpr int kComponentCount = 100000;
+
+            std::vector<std::unique_ptr<Component>> heapComponents;
+            heapComponents.reserve(kComponentCount);
+            std::vector<ComponentPtr> pooledComponents;
+            pooledComponents.reserve(kComponentCount);
+
+            const auto heapSpawnStart = Clock::now();
+            for (int i = 0; i < kComponentCount; ++i)
+            {
+                heapComponents.emplace_back(std::make_unique<PooledComponent>(i));
+            }
+            const double heapSpawnMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - heapSpawnStart).count();
+
+            const auto heapClearStart = Clock::now();
+            heapComponents.clear();
+            const double heapClearMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - heapClearStart).count();
+
+            const auto poolSpawnStart = Clock::now();
+            for (int i = 0; i < kComponentCount; ++i)
+            {
+                pooledComponents.emplace_back(ComponentPool<PooledComponent>::Create(i), ComponentDeleter{ &ComponentPool<PooledComponent>::Destroy });
+            }
+            const double poolSpawnMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - poolSpawnStart).count();
+
+            bool isIntact = true;
+            for (int i = 0; i < kComponentCount; ++i)
+            {
+                isIntact &= static_cast<const PooledComponent*>(pooledComponents[i].get())->GetValue() == i;
+            }
+
+            const auto poolClearStart = Clock::now();
+            pooledComponents.clear();
+            const double poolClearMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - poolClearStart).count();
+
+            ComponentPool<PooledComponent>& pool = ComponentPool<PooledComponent>::Get();
+            const bool isEmpty = pool.GetStats().m_liveCount == 0 && pool.Reset();
+            pool.Release();
+
+            std::cout << "  ComponentPool spawn " << poolSpawnMilliseconds << "ms vs make_unique " << heapSpawnMilliseconds
+                << "ms, teardown " << poolClearMilliseconds << "ms vs " << heapClearMilliseconds << "ms for "
+                << kComponentCount << " components\n";
+
+            return isIntact && isEmpty;
+        }
+
+    public:
+
+        static void RegisterComponentPoolTests(UnitTestSystem* pTestSystem)
+        {
+            pTestSystem->AddTest("ComponentPool ResetIsContiguous", TestResetIsContiguous);
+            pTestSystem->AddTest("ComponentPool BenchmarkAgainstMakeUnique", BenchmarkAgainstMakeUnique);
+        }
+    };
+}
@@ -0,0 +1,574 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "2DPhysicsManager/PhysicsManager.h"
+#include "Entity/GameEntity/Component/ColliderComponent/ColliderComponent.h"
+#include "Entity/GameEntity/Component/TransformComponent/TransformComponent.h"
+#include "Entity/GameEntity/Component/TransformComponent/TransformHierarchy.h"
+#include "Entity/GameEntity/Component/RenderComponent/SpriteComponent.h"
+#include "Entity/GameEntityManager/GameEntityManager.h"
+#include "EventManager/EventManager.h"
+#include "UnitTests/UnitTestSystem.h"
+#include "Utility/BinaryStream.h"
+
+namespace Brokkr
+{
+    // Needs the game's CoreSystems, components Init against its AssetManager and window system
+    class EntityManagerTest
+    {
+        inline static constexpr const char* kTextureName = "EntityManagerTest";
+
+        // Adds a sprite to its entity on the first update and removes it on the second, from inside UpdateEntities
+        class SpriteToggleComponent final : public Component
+        {
+            GameEntity* m_pOwner;
+            GameEntityManager* m_pEntityManager;
+            CoreSystems* m_pCoreSystems;
+            int m_updates = 0;
+
+        public:
+            SpriteToggleComponent(GameEntity* pOwner, GameEntityManager* pEntityManager, CoreSystems* pCoreSystems)
+                : m_pOwner(pOwner)
+                , m_pEntityManager(pEntityManager)
+                , m_pCoreSystems(pCoreSystems)
+            {
+                //
+            }
+
+            virtual bool Init() override { return true; }
+            virtual void Destroy() override {}
+
+            virtual void Update() override
+            {
+                if (m_updates == 0)
+                {
+                    m_pEntityManager->AddComponent<SpriteComponent>(m_pOwner, m_pCoreSystems, kTextureName, false);
+                }
+                else if (m_updates == 1)
+                {
+                    m_pEntityManager->RemoveComponent<SpriteComponent>(m_pOwner);
+                }
+                ++m_updates;
+            }
+        };
+
+        // Spawns an entity on its first update, from inside UpdateEntities
+        class SpawnerComponent final : public Component
+        {
+            GameEntityManager* m_pEntityManager;
+            GameEntity* m_pSpawned = nullptr;
+
+        public:
+            SpawnerComponent(GameEntity*, GameEntityManager* pEntityManager)
+                : m_pEntityManager(pEntityManager)
+            {
+                //
+            }
+
+            virtual bool Init() override { return true; }
+            virtual void Destroy() override {}
+
+            virtual void Update() override
+            {
+                if (m_pSpawned == nullptr)
+                {
+                    m_pSpawned = m_pEntityManager->GetNextEntityAvailable();
+                    m_pEntityManager->SetEntityName(m_pSpawned, "DeferredSpawn");
+                }
+            }
+
+            [[nodiscard]] GameEntity* GetSpawned() const { return m_pSpawned; }
+        };
+
+        // Sprites added and removed while the entities update wait for the flush, and join and leave the render list
+        static bool TestDeferredSpriteDuringUpdate(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager entityManager(pCoreSystems);
+            GameEntity* pEntity = entityManager.GetNextEntityAvailable();
+            pEntity->AddComponent<SpriteToggleComponent>(&entityManager, pCoreSystems);
+
+            entityManager.UpdateEntities();
+            const bool isAddDeferred = pEntity->GetComponent<SpriteComponent>() == nullptr && entityManager.GetRenderComponentCount() == 0;
+            entityManager.FlushCommands();
+            const bool isAdded = pEntity->GetComponent<SpriteComponent>() != nullptr && entityManager.GetRenderComponentCount() == 1;
+
+            entityManager.UpdateEntities();
+            const bool isRemoveDeferred = pEntity->GetComponent<SpriteComponent>() != nullptr && entityManager.GetRenderComponentCount() == 1;
+            entityManager.FlushCommands();
+            const bool isRemoved = pEntity->GetComponent<SpriteComponent>() == nullptr && entityManager.GetRenderComponentCount() == 0;
+
+            return isAddDeferred && isAdded && isRemoveDeferred && isRemoved;
+        }
+
+        // An entity spawned while the entities update is usable at once but only joins the list at the flush
+        static bool TestDeferredSpawnDuringUpdate(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager entityManager(pCoreSystems);
+            GameEntity* pSpawner = entityManager.GetNextEntityAvailable();
+            const auto pComponent = pSpawner->AddComponent<SpawnerComponent>(&entityManager);
+
+            entityManager.UpdateEntities();
+            GameEntity* pSpawned = pComponent->GetSpawned();
+            const bool isDeferred = pSpawned != nullptr && entityManager.GetEntityCount() == 1
+                && entityManager.GetActiveEntityCount() == 1 && entityManager.GetEntityById(pSpawned->GetId()) == nullptr;
+
+            entityManager.FlushCommands();
+            return isDeferred && entityManager.GetEntityCount() == 2 && entityManager.GetActiveEntityCount() == 2
+                && entityManager.GetEntityById(pSpawned->GetId()) == pSpawned && entityManager.GetEntityByName("DeferredSpawn") == pSpawned;
+        }
+
+        // Clearing the world drops what was recorded for it, a pending spawn does not come back at the flush
+        static bool TestClearDropsCommands(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager entityManager(pCoreSystems);
+            GameEntity* pEntity = entityManager.GetNextEntityAvailable();
+            const int entityId = pEntity->GetId();
+
+            bool isEditRun = false;
+            GameEntityManager::OnEventDispatch(&entityManager, true);
+            entityManager.GetNextEntityAvailable();
+            entityManager.GetCommandBuffer().Edit(entityId, [&isEditRun](GameEntity*) { isEditRun = true; });
+            GameEntityManager::OnEventDispatch(&entityManager, false);
+
+            entityManager.ClearEntities();
+            const bool isDropped = entityManager.GetCommandBuffer().IsEmpty();
+            entityManager.FlushCommands();
+
+            return isDropped && !isEditRun && entityManager.GetEntityCount() == 0;
+        }
+
+        // A handler removing a sprite and destroying an entity during ProcessEvents, both wait for the flush
+        static bool TestDeferredDuringDispatch(CoreSystems* pCoreSystems)
+        {
+            static constexpr Event::EventType kRemoveType("TestRemoveSprite", Event::kPriorityNormal);
+
+            GameEntityManager entityManager(pCoreSystems);
+            EventManager eventManager(nullptr);
+            eventManager.SetDispatchScope(&GameEntityManager::OnEventDispatch, &entityManager);
+
+            GameEntity* pEntity = entityManager.GetNextEntityAvailable();
+            GameEntity* pDoomed = entityManager.GetNextEntityAvailable();
+            const int doomedId = pDoomed->GetId();
+            if (entityManager.AddComponent<SpriteComponent>(pEntity, pCoreSystems, kTextureName, false) == nullptr)
+            {
+                return false;
+            }
+
+            bool isDeferred = false;
+            const auto subscription = eventManager.AddHandler("TestRemoveSprite", { 0, [&](const Event&)
+            {
+                entityManager.RemoveComponent<SpriteComponent>(pEntity);
+                entityManager.DeleteEntity(doomedId);
+                isDeferred = entityManager.IsDeferring() && entityManager.GetRenderComponentCount() == 1
+                    && entityManager.GetEntityById(doomedId) != nullptr;
+            } });
+
+            eventManager.PushEvent(Event(kRemoveType));
+            eventManager.ProcessEvents();
+            eventManager.RemoveHandler(subscription);
+
+            const bool isStillThere = !entityManager.IsDeferring() && entityManager.GetRenderComponentCount() == 1;
+            entityManager.FlushCommands();
+
+            return isDeferred && isStillThere && entityManager.GetRenderComponentCount() == 0
+                && entityManager.GetEntityById(doomedId) == nullptr && pEntity->GetComponent<SpriteComponent>() == nullptr;
+        }
+
+        // True if the bucket holds exactly these entities, in any order
+        static bool HoldsExactly(const std::vector<GameEntity*>& bucket, std::vector<GameEntity*> expected)
+        {
+            for (GameEntity* pEntity : bucket)
+            {
+                const auto found = std::find(expected.begin(), expected.end(), pEntity);
+                if (found == expected.end())
+                {
+                    return false;
+                }
+                expected.erase(found);
+            }
+            return expected.empty();
+        }
+
+        // Lookups by name and tag follow every delete, rename and untag, whatever bucket slot the entity was in
+        static bool TestNameTagIndex(CoreSystems* pCoreSystems)
+        {
+            constexpr size_t kInstanceCount = 6;
+
+            GameEntityManager entityManager(pCoreSystems);
+            std::vector<GameEntity*> instances;
+            std::vector<GameEntity*> tagged;
+            for (size_t i = 0; i < kInstanceCount; ++i)
+            {
+                GameEntity* pEntity = entityManager.GetNextEntityAvailable();
+                entityManager.SetEntityName(pEntity, "IndexPrefab");
+                entityManager.AddEntityTag(pEntity, "IndexTeam");
+                if (i % 2 == 0)
+                {
+                    entityManager.AddEntityTag(pEntity, "IndexEven");
+                    tagged.push_back(pEntity);
+                }
+                instances.push_back(pEntity);
+            }
+
+            const bool isLookedUp = HoldsExactly(entityManager.GetEntitiesByName("IndexPrefab"), instances)
+                && HoldsExactly(entityManager.GetEntitiesByTag("IndexEven"), tagged)
+                && entityManager.GetEntitiesByName("IndexMissing").empty();
+
+            // From the middle, so the last one is moved into its slot
+            GameEntity* pRenamed = instances[1];
+            entityManager.SetEntityName(pRenamed, "IndexRenamed");
+            instances.erase(instances.begin() + 1);
+            const bool isRenamed = entityManager.GetEntityByName("IndexRenamed") == pRenamed
+                && HoldsExactly(entityManager.GetEntitiesByName("IndexPrefab"), instances);
+
+            entityManager.RemoveEntityTag(tagged[0], "IndexEven");
+            tagged.erase(tagged.begin());
+            const bool isUntagged = HoldsExactly(entityManager.GetEntitiesByTag("IndexEven"), tagged)
+                && entityManager.GetEntitiesByTag("IndexTeam").size() == kInstanceCount;
+
+            // Every other one, then the rest, checking the buckets after each delete
+            bool isRemoved = true;
+            std::vector<GameEntity*> team = entityManager.GetEntitiesByTag("IndexTeam");
+            for (const size_t start : { size_t(0), size_t(1) })
+            {
+                for (size_t i = start; i < kInstanceCount; i += 2)
+                {
+                    GameEntity* pDoomed = team[i];
+                    entityManager.DeleteEntity(pDoomed->GetId());
+
+                    const auto drop = [pDoomed](std::vector<GameEntity*>& entities)
+                    {
+                        entities.erase(std::remove(entities.begin(), entities.end(), pDoomed), entities.end());
+                    };
+                    std::vector<GameEntity*> remainingTeam = entityManager.GetEntitiesByTag("IndexTeam");
+                    drop(instances);
+                    drop(tagged);
+                    isRemoved &= HoldsExactly(entityManager.GetEntitiesByName("IndexPrefab"), instances)
+                        && HoldsExactly(entityManager.GetEntitiesByTag("IndexEven"), tagged)
+                        && std::find(remainingTeam.begin(), remainingTeam.end(), pDoomed) == remainingTeam.end();
+                }
+            }
+
+            return isLookedUp && isRenamed && isUntagged && isRemoved && entityManager.GetEntityCount() == 0
+                && entityManager.GetEntitiesByTag("IndexTeam").empty() && entityManager.GetEntitiesByName("IndexRenamed").empty();
+        }
+
+        // A fresh entity with an 8x8 transform at the given position
+        static GameEntity* AddTransformEntity(GameEntityManager& entityManager, CoreSystems* pCoreSystems, float x, float y)
+        {
+            GameEntity* pEntity = entityManager.GetNextEntityAvailable();
+            const auto pTransform = pEntity->AddComponent<TransformComponent>(pCoreSystems, Rectangle<float>({ x, y }, { 8.f, 8.f }));
+            pTransform->SetStartingPos({ x, y });
+            pTransform->Init();
+            return pEntity;
+        }
+
+        static TransformComponent* AddTransform(GameEntityManager& entityManager, CoreSystems* pCoreSystems, float x, float y)
+        {
+            return AddTransformEntity(entityManager, pCoreSystems, x, y)->GetComponent<TransformComponent>();
+        }
+
+        static bool IsAt(const TransformComponent* pTransform, float x, float y)
+        {
+            return pTransform->GetTransform().GetPosition() == Vector2<float>(x, y);
+        }
+
+        // Children keep their offset as the parent moves, down every level, and can be moved or offset themselves
+        static bool TestTransformParenting(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager entityManager(pCoreSystems);
+            TransformHierarchy& hierarchy = entityManager.GetTransformHierarchy();
+            TransformComponent* pRoot = AddTransform(entityManager, pCoreSystems, 10.f, 10.f);
+            TransformComponent* pChild = AddTransform(entityManager, pCoreSystems, 15.f, 20.f);
+            TransformComponent* pGrandchild = AddTransform(entityManager, pCoreSystems, 16.f, 22.f);
+
+            const bool isLinked = hierarchy.SetParent(pChild, pRoot) && hierarchy.SetParent(pGrandchild, pChild)
+                && hierarchy.GetParent(pGrandchild) == pChild && hierarchy.GetNodeCount() == 3
+                && hierarchy.GetLocalPosition(pChild) == Vector2<float>(5.f, 10.f);
+            const bool isCycleRefused = !hierarchy.SetParent(pRoot, pGrandchild) && hierarchy.GetParent(pRoot) == nullptr;
+            hierarchy.Resolve();
+
+            pRoot->MoveTo({ 100.f, 100.f });
+            hierarchy.Resolve();
+            const bool isFollowing = IsAt(pChild, 105.f, 110.f) && IsAt(pGrandchild, 106.f, 112.f) && hierarchy.GetDirtyCount() == 0;
+
+            // A child moved on its own keeps its new place, its children go with it
+            pChild->MoveTo({ 50.f, 50.f });
+            hierarchy.Resolve();
+            const bool isChildMoved = IsAt(pChild, 50.f, 50.f) && IsAt(pGrandchild, 51.f, 52.f)
+                && hierarchy.GetLocalPosition(pChild) == Vector2<float>(-50.f, -50.f);
+
+            pGrandchild->SetLocalPosition({ 3.f, 4.f });
+            hierarchy.Resolve();
+            const bool isOffset = IsAt(pGrandchild, 53.f, 54.f);
+
+            return isLinked && isCycleRefused && isFollowing && isChildMoved && isOffset && IsAt(pRoot, 100.f, 100.f);
+        }
+
+        // A reparented child follows only its new parent, unlinked transforms leave the hierarchy
+        static bool TestTransformReparent(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager entityManager(pCoreSystems);
+            TransformHierarchy& hierarchy = entityManager.GetTransformHierarchy();
+            TransformComponent* pFirst = AddTransform(entityManager, pCoreSystems, 0.f, 0.f);
+            TransformComponent* pSecond = AddTransform(entityManager, pCoreSystems, 100.f, 0.f);
+            TransformComponent* pChild = AddTransform(entityManager, pCoreSystems, 10.f, 10.f);
+
+            hierarchy.SetParent(pChild, pFirst);
+            hierarchy.Resolve();
+            const bool isReparented = hierarchy.SetParent(pChild, pSecond) && hierarchy.GetParent(pChild) == pSecond
+                && hierarchy.GetNodeCount() == 2 && hierarchy.GetLocalPosition(pChild) == Vector2<float>(-90.f, 10.f);
+            hierarchy.Resolve();
+
+            pFirst->MoveTo({ -40.f, 0.f });
+            hierarchy.Resolve();
+            const bool isOldParentIgnored = IsAt(pChild, 10.f, 10.f);
+
+            pSecond->MoveTo({ 200.f, 50.f });
+            hierarchy.Resolve();
+            const bool isNewParentFollowed = IsAt(pChild, 110.f, 60.f);
+
+            const bool isDetached = hierarchy.SetParent(pChild, nullptr) && hierarchy.GetParent(pChild) == nullptr
+                && hierarchy.GetNodeCount() == 0;
+            pSecond->MoveTo({ 0.f, 0.f });
+            hierarchy.Resolve();
+
+            return isReparented && isOldParentIgnored && isNewParentFollowed && isDetached && IsAt(pChild, 110.f, 60.f);
+        }
+
+        // Deleting a transform orphans its children where they stand, whichever slot it or they were in
+        static bool TestTransformRemoval(CoreSystems* pCoreSystems)
+        {
+            constexpr size_t kChildCount = 6;
+
+            GameEntityManager entityManager(pCoreSystems);
+            TransformHierarchy& hierarchy = entityManager.GetTransformHierarchy();
+            GameEntity* pRootEntity = AddTransformEntity(entityManager, pCoreSystems, 0.f, 0.f);
+            TransformComponent* pRoot = pRootEntity->GetComponent<TransformComponent>();
+            std::vector<GameEntity*> children;
+            for (size_t i = 0; i < kChildCount; ++i)
+            {
+                children.push_back(AddTransformEntity(entityManager, pCoreSystems, static_cast<float>(i), 1.f));
+                hierarchy.SetParent(children.back()->GetComponent<TransformComponent>(), pRoot);
+            }
+
+            // A grandchild under the first child, it becomes a root when its parent goes
+            TransformComponent* pGrandchild = AddTransform(entityManager, pCoreSystems, 0.f, 2.f);
+            hierarchy.SetParent(pGrandchild, children[0]->GetComponent<TransformComponent>());
+            hierarchy.Resolve();
+
+            // Every child queued first so the deletes happen while they are waiting on a Resolve
+            for (GameEntity* pChild : children)
+            {
+                TransformComponent* pTransform = pChild->GetComponent<TransformComponent>();
+                pTransform->MoveTo(pTransform->GetTransform().GetPosition());
+            }
+
+            // Every other child, then the last one is detached while still queued
+            std::vector<TransformComponent*> remaining;
+            for (size_t i = 0; i < kChildCount; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    entityManager.DeleteEntity(children[i]->GetId());
+                }
+                else
+                {
+                    remaining.push_back(children[i]->GetComponent<TransformComponent>());
+                }
+            }
+            hierarchy.SetParent(remaining.back(), nullptr);
+            remaining.pop_back();
+
+            const bool isRemoved = hierarchy.GetNodeCount() == 1 + remaining.size() && hierarchy.GetDirtyCount() == remaining.size()
+                && hierarchy.GetParent(pGrandchild) == nullptr;
+
+            pRoot->MoveTo({ 10.f, 20.f });
+            hierarchy.Resolve();
+            bool isFollowing = IsAt(pGrandchild, 0.f, 2.f);
+            for (size_t i = 0; i < remaining.size(); ++i)
+            {
+                isFollowing &= IsAt(remaining[i], static_cast<float>(i * 2 + 1) + 10.f, 21.f) && hierarchy.GetParent(remaining[i]) == pRoot;
+            }
+
+            // The parent going last leaves nothing behind
+            entityManager.DeleteEntity(pRootEntity->GetId());
+            bool isOrphaned = hierarchy.GetNodeCount() == 0;
+            for (const TransformComponent* pChild : remaining)
+            {
+                isOrphaned &= hierarchy.GetParent(pChild) == nullptr && pChild->GetTransform().GetPosition().m_y == 21.f;
+            }
+
+            return isRemoved && isFollowing && isOrphaned;
+        }
+
+        // A transformed entity with a static collider the size of its transform, in the broadphase
+        static GameEntity* AddColliderEntity(GameEntityManager& entityManager, CoreSystems* pCoreSystems, float x, float y)
+        {
+            GameEntity* pEntity = AddTransformEntity(entityManager, pCoreSystems, x, y);
+            pEntity->AddComponent<ColliderComponent>(pCoreSystems, Rectangle<float>({ x, y }, { 8.f, 8.f }), 0, true)->Init();
+            return pEntity;
+        }
+
+        // Entities with a collider leaving the region are suspended and come back with it, the rest stay active
+        static bool CheckActivityRegion(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager entityManager(pCoreSystems);
+            GameEntity* pNear = AddColliderEntity(entityManager, pCoreSystems, 10.f, 10.f);
+            GameEntity* pFar = AddColliderEntity(entityManager, pCoreSystems, 1000.f, 10.f);
+            GameEntity* pUnbounded = AddTransformEntity(entityManager, pCoreSystems, 1000.f, 10.f);
+
+            entityManager.SetActivityRegion({ 10.f, 10.f }, 100.f);
+            entityManager.UpdateEntities();
+            const bool isFarSuspended = !pNear->IsSuspended() && pFar->IsSuspended() && !pUnbounded->IsSuspended()
+                && entityManager.GetActiveEntityCount() == 2;
+
+            entityManager.SetActivityRegion({ 1000.f, 10.f }, 100.f);
+            entityManager.UpdateEntities();
+            const bool isSwapped = pNear->IsSuspended() && !pFar->IsSuspended() && entityManager.GetActiveEntityCount() == 2;
+
+            // Without its collider an entity can not be found again, it is left active
+            entityManager.RemoveComponent<ColliderComponent>(pFar);
+            entityManager.SetActivityRegion({ 10.f, 10.f }, 100.f);
+            entityManager.UpdateEntities();
+            const bool isColliderDropped = !pNear->IsSuspended() && !pFar->IsSuspended() && entityManager.GetActiveEntityCount() == 3;
+
+            entityManager.SetActivityRegion({ 1000.f, 10.f }, 100.f);
+            entityManager.UpdateEntities();
+            const bool isNearSuspendedAgain = pNear->IsSuspended() && entityManager.GetActiveEntityCount() == 2;
+
+            entityManager.ClearActivityRegion();
+            return isFarSuspended && isSwapped && isColliderDropped && isNearSuspendedAgain
+                && !pNear->IsSuspended() && entityManager.GetActiveEntityCount() == 3;
+        }
+
+        // The broadphase only holds colliders inside the world, sized for the test and put back after
+        static bool TestActivityRegion(CoreSystems* pCoreSystems)
+        {
+            const auto pPhysicsManager = pCoreSystems->GetCoreSystem<PhysicsManager>();
+            const Rectangle<float> worldSize = pPhysicsManager->GetWorldSize();
+            pPhysicsManager->SetWorldSize({ 2048.f, 256.f });
+
+            const bool isPassed = CheckActivityRegion(pCoreSystems);
+            pPhysicsManager->SetWorldSize({ worldSize.GetWidth(), worldSize.GetHeight() });
+            return isPassed;
+        }
+
+        // A named and tagged entity with a transform and a named child linked to it, and a disabled one sharing a tag
+        static void BuildSnapshotWorld(GameEntityManager& entityManager, CoreSystems* pCoreSystems)
+        {
+            GameEntity* pPlayer = AddTransformEntity(entityManager, pCoreSystems, 12.f, 34.f);
+            entityManager.SetEntityName(pPlayer, "SnapshotPlayer");
+            entityManager.AddEntityTag(pPlayer, "SnapshotHero");
+            entityManager.AddEntityTag(pPlayer, "SnapshotBlue");
+
+            GameEntity* pWeapon = AddTransformEntity(entityManager, pCoreSystems, 14.f, 30.f);
+            entityManager.SetEntityName(pWeapon, "SnapshotWeapon");
+            entityManager.GetTransformHierarchy().SetParent(pWeapon->GetComponent<TransformComponent>(), pPlayer->GetComponent<TransformComponent>());
+
+            GameEntity* pSleeper = entityManager.GetNextEntityAvailable();
+            entityManager.AddEntityTag(pSleeper, "SnapshotBlue");
+            pSleeper->Disable();
+        }
+
+        // Saved to a file and loaded into another manager: ids, names, tags, enabled state, transforms and
+        // their parent links come back
+        static bool TestSnapshotRoundTrip(CoreSystems* pCoreSystems)
+        {
+            const char* pPath = "EntityManagerTest.brks";
+
+            GameEntityManager saved(pCoreSystems);
+            BuildSnapshotWorld(saved, pCoreSystems);
+            if (!saved.SaveSnapshot(pPath))
+            {
+                return false;
+            }
+
+            GameEntityManager loaded(pCoreSystems);
+            loaded.GetNextEntityAvailable();   // replaced by the load
+            const bool isLoaded = loaded.LoadSnapshot(pPath);
+            std::remove(pPath);
+
+            const GameEntity* pSavedPlayer = saved.GetEntitiesByName("SnapshotPlayer").front();
+            const auto& players = loaded.GetEntitiesByName("SnapshotPlayer");
+            GameEntity* pWeapon = loaded.GetEntityByName("SnapshotWeapon");
+            if (!isLoaded || loaded.GetEntityCount() != 3 || players.size() != 1 || pWeapon == nullptr)
+            {
+                return false;
+            }
+
+            GameEntity* pPlayer = players.front();
+            const auto pTransform = pPlayer->GetComponent<TransformComponent>();
+            if (pTransform == nullptr || !IsAt(pTransform, 12.f, 34.f))
+            {
+                return false;
+            }
+
+            // The child is linked in the loaded manager's hierarchy and still follows the player
+            TransformHierarchy& hierarchy = loaded.GetTransformHierarchy();
+            const auto pWeaponTransform = pWeapon->GetComponent<TransformComponent>();
+            const bool isLinked = hierarchy.GetParent(pWeaponTransform) == pTransform
+                && hierarchy.GetLocalPosition(pWeaponTransform) == Vector2<float>(2.f, -4.f) && IsAt(pWeaponTransform, 14.f, 30.f);
+            pTransform->MoveTo({ 0.f, 0.f });
+            hierarchy.Resolve();
+            const bool isFollowing = IsAt(pWeaponTransform, 2.f, -4.f);
+            int disabledCount = 0;
+            for (const GameEntity* pEntity : loaded.GetEntitiesByTag("SnapshotBlue"))
+            {
+                disabledCount += pEntity->IsEnabled() ? 0 : 1;
+            }
+
+            return pPlayer->GetId() == pSavedPlayer->GetId() && pPlayer->GetTags().size() == 2
+                && loaded.GetEntitiesByTag("SnapshotHero").size() == 1 && loaded.GetEntitiesByTag("SnapshotBlue").size() == 2
+                && disabledCount == 1 && pTransform->GetStartingPos().m_x == 12.f && isLinked && isFollowing;
+        }
+
+        // A snapshot cut short anywhere fails to load and leaves the current world as it was
+        static bool TestSnapshotLoadFailureKeepsWorld(CoreSystems* pCoreSystems)
+        {
+            GameEntityManager source(pCoreSystems);
+            BuildSnapshotWorld(source, pCoreSystems);
+            BinaryWriter writer;
+            source.WriteSnapshot(writer);
+            const std::vector<uint8_t>& bytes = writer.GetBuffer();
+
+            GameEntityManager entityManager(pCoreSystems);
+            GameEntity* pKept = entityManager.GetNextEntityAvailable();
+            entityManager.SetEntityName(pKept, "SnapshotKept");
+
+            for (size_t size = 0; size < bytes.size(); ++size)
+            {
+                BinaryReader reader(std::vector<uint8_t>(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(size)));
+                if (entityManager.ReadSnapshot(reader) || entityManager.GetEntityCount() != 1
+                    || entityManager.GetEntityById(pKept->GetId()) != pKept || entityManager.GetEntitiesByName("SnapshotKept").size() != 1)
+                {
+                    return false;
+                }
+            }
+
+            BinaryReader whole(bytes);
+            return entityManager.ReadSnapshot(whole) && entityManager.GetEntityCount() == 3
+                && entityManager.GetEntitiesByName("SnapshotKept").empty();
+        }
+
+    public:
+
+        static void RegisterEntityManagerTests(UnitTestSystem* pTestSystem, CoreSystems* pCoreSystems)
+        {
+            pTestSystem->AddTest("EntityManager DeferredSpriteDuringUpdate", [pCoreSystems]() { return TestDeferredSpriteDuringUpdate(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager DeferredSpawnDuringUpdate", [pCoreSystems]() { return TestDeferredSpawnDuringUpdate(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager ClearDropsCommands", [pCoreSystems]() { return TestClearDropsCommands(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager DeferredDuringDispatch", [pCoreSystems]() { return TestDeferredDuringDispatch(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager NameTagIndex", [pCoreSystems]() { return TestNameTagIndex(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager TransformParenting", [pCoreSystems]() { return TestTransformParenting(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager TransformReparent", [pCoreSystems]() { return TestTransformReparent(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager TransformRemoval", [pCoreSystems]() { return TestTransformRemoval(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager ActivityRegion", [pCoreSystems]() { return TestActivityRegion(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager SnapshotRoundTrip", [pCoreSystems]() { return TestSnapshotRoundTrip(pCoreSystems); });
+            pTestSystem->AddTest("EntityManager SnapshotLoadFailureKeepsWorld", [pCoreSystems]() { return TestSnapshotLoadFailureKeepsWorld(pCoreSystems); });
+        }
+    };
+}
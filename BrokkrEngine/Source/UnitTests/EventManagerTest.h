@@ -0,0 +1,960 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "EventManager/EventManager.h"
+#include "EventManager/Event/PayloadComponent/CollisionPayload/CollisionPayload.h"
+#include "JobSystem/JobSystem.h"
+#include "UnitTests/UnitTestSystem.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Hash.h"
+#include "Utility/StringID.h"
+
+namespace Brokkr
+{
+    class EventManagerTest
+    {
+        // Which push of its producer an event was
+        class SequencePayload final : public PayloadComponent
+        {
+            uint32_t m_sequence;
+        public:
+            explicit SequencePayload(uint32_t sequence) : m_sequence(sequence) {}
+
+            [[nodiscard]] uint32_t GetSequence() const { return m_sequence; }
+        };
+
+        // Pushes count events targeted at the producer index, key of 0 leaves the thread unregistered
+        static void PushSequence(EventManager* pEventManager, int producer, uint32_t key, uint32_t count)
+        {
+            static constexpr Event::EventType kSequenceType("TestSequence", Event::kPriorityNormal);
+
+            if (key != 0)
+            {
+                pEventManager->RegisterEventProducer(key);
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                Event event(kSequenceType, producer);
+                event.AddComponent<SequencePayload>(i);
+                pEventManager->PushEvent(event);
+            }
+        }
+
+        // Many threads pushing while the main thread keeps processing, nothing lost and every producer in order
+        static bool TestConcurrentPushStress()
+        {
+            constexpr int kProducerCount = 16;
+            constexpr uint32_t kEventsPerProducer = 20000;
+
+            EventManager eventManager(nullptr);
+
+            std::vector<uint32_t> nextSequence(kProducerCount, 0);
+            bool inOrder = true;
+            size_t received = 0;
+
+            const auto subscription = eventManager.AddHandler("TestSequence", { 0, [&](const Event& event)
+            {
+                const auto* pPayload = event.GetComponent<SequencePayload>();
+                const int producer = event.GetTarget();
+                if (pPayload == nullptr || producer < 0 || producer >= kProducerCount || pPayload->GetSequence() != nextSequence[producer])
+                {
+                    inOrder = false;
+                    return;
+                }
+
+                ++nextSequence[producer];
+                ++received;
+            } });
+
+            std::atomic<int> finished = 0;
+            std::vector<std::thread> producers;
+            for (int i = 0; i < kProducerCount; ++i)
+            {
+                // Half register a key, half are picked up on their first push
+                const uint32_t key = (i % 2 == 0) ? static_cast<uint32_t>(i + 1) : 0;
+                producers.emplace_back([&eventManager, &finished, i, key]()
+                {
+                    PushSequence(&eventManager, i, key, kEventsPerProducer);
+                    ++finished;
+                });
+            }
+
+            while (finished.load() < kProducerCount)
+            {
+                eventManager.ProcessEvents();
+            }
+
+            for (auto& producer : producers)
+            {
+                producer.join();
+            }
+
+            eventManager.ProcessEvents();
+            eventManager.RemoveHandler(subscription);
+
+            return inOrder && received == static_cast<size_t>(kProducerCount) * kEventsPerProducer;
+        }
+
+        // Same pushes, same merged order, however the threads were scheduled
+        static bool TestConcurrentPushDeterministic()
+        {
+            constexpr int kProducerCount = 8;
+
+            // More than a ring holds so the overflow path is part of the merge
+            constexpr uint32_t kEventsPerProducer = static_cast<uint32_t>(ConcurrentEventQueue::kRingCapacity) * 3;
+
+            auto runOnce = [&]()
+            {
+                EventManager eventManager(nullptr);
+                std::vector<std::pair<int, uint32_t>> order;
+
+                const auto subscription = eventManager.AddHandler("TestSequence", { 0, [&order](const Event& event)
+                {
+                    order.emplace_back(event.GetTarget(), event.GetComponent<SequencePayload>()->GetSequence());
+                } });
+
+                // Keys are the reverse of the thread index so the merge order is not the spawn order
+                std::vector<std::thread> producers;
+                for (int i = 0; i < kProducerCount; ++i)
+                {
+                    producers.emplace_back(PushSequence, &eventManager, i, static_cast<uint32_t>(kProducerCount - i), kEventsPerProducer);
+                }
+
+                for (auto& producer : producers)
+                {
+                    producer.join();
+                }
+
+                eventManager.ProcessEvents();
+                eventManager.RemoveHandler(subscription);
+                return order;
+            };
+
+            const auto first = runOnce();
+            const auto second = runOnce();
+
+            if (first != second || first.size() != static_cast<size_t>(kProducerCount) * kEventsPerProducer)
+            {
+                return false;
+            }
+
+            // Lowest key first, each producer's events back to back
+            for (size_t i = 0; i < first.size(); ++i)
+            {
+                const int expectedProducer = kProducerCount - 1 - static_cast<int>(i / kEventsPerProducer);
+                if (first[i].first != expectedProducer || first[i].second != i % kEventsPerProducer)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Entity local handler keeping a running value per entity, pushes a follow up on its first event
+        struct WaveEntity
+        {
+            EventManager* m_pEventManager = nullptr;
+            int m_id = 0;
+            uint32_t m_nextSequence = 0;
+            uint64_t m_value = 0;
+            bool m_inOrder = true;
+
+            void OnThink(const Event& event)
+            {
+                static constexpr Event::EventType kFollowUpType("TestWaveFollowUp", Event::kPriorityNormal);
+
+                const uint32_t sequence = event.GetComponent<SequencePayload>()->GetSequence();
+                m_inOrder &= sequence == m_nextSequence++;
+                m_value = m_value * 31 + sequence + 1;
+
+                if (sequence == 0)
+                {
+                    m_pEventManager->PushEvent(Event(kFollowUpType, m_id));
+                }
+            }
+
+            void OnFollowUp(const Event&) { m_value = m_value * 31 + 7; }
+        };
+
+        // A few frames of interleaved per entity events, run with or without workers. Returns each entity's value
+        static std::vector<uint64_t> RunWaveFrames(size_t workerCount, bool& inOrder)
+        {
+            static constexpr Event::EventType kThinkType("TestWaveThink", Event::kPriorityNormal);
+            constexpr int kEntityCount = 300;
+            constexpr uint32_t kEventsPerFrame = 4;
+
+            JobSystem jobSystem(nullptr, workerCount);
+            EventManager eventManager(nullptr);
+            if (workerCount > 0)
+            {
+                eventManager.SetJobSystem(&jobSystem);
+            }
+
+            std::vector<WaveEntity> entities(kEntityCount);
+            std::vector<EventSubscription> subscriptions;
+            for (int i = 0; i < kEntityCount; ++i)
+            {
+                entities[i].m_pEventManager = &eventManager;
+                entities[i].m_id = i;
+                subscriptions.push_back(eventManager.AddHandler("TestWaveThink", i, 0,
+                    EventDelegate::FromMethod<WaveEntity, &WaveEntity::OnThink>(&entities[i]), HandlerFlags::kEntityLocal));
+                subscriptions.push_back(eventManager.AddHandler("TestWaveFollowUp", i, 0,
+                    EventDelegate::FromMethod<WaveEntity, &WaveEntity::OnFollowUp>(&entities[i]), HandlerFlags::kEntityLocal));
+            }
+
+            for (uint32_t frame = 0; frame < 10; ++frame)
+            {
+                for (uint32_t k = 0; k < kEventsPerFrame; ++k)
+                {
+                    for (int i = 0; i < kEntityCount; ++i)
+                    {
+                        Event event(kThinkType, i);
+                        event.AddComponent<SequencePayload>(frame * kEventsPerFrame + k);
+                        eventManager.PushEvent(event);
+                    }
+                }
+                eventManager.ProcessEvents();
+            }
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+            eventManager.Destroy();
+
+            std::vector<uint64_t> values;
+            for (const WaveEntity& entity : entities)
+            {
+                inOrder &= entity.m_inOrder && entity.m_nextSequence == 10 * kEventsPerFrame;
+                values.push_back(entity.m_value);
+            }
+            return values;
+        }
+
+        // Spread over workers, every entity still sees its own events in push order
+        static bool TestWaveEntityOrder()
+        {
+            bool inOrder = true;
+            RunWaveFrames(3, inOrder);
+            return inOrder;
+        }
+
+        // Same pushes give the same per entity results on the main thread alone and with workers
+        static bool TestWaveMatchesSerial()
+        {
+            bool inOrder = true;
+            const auto serial = RunWaveFrames(0, inOrder);
+            const auto parallel = RunWaveFrames(3, inOrder);
+            return inOrder && serial == parallel;
+        }
+
+        // Thread safe handlers on three priority levels, pushed lowest first: every level finishes before the next starts
+        static bool TestWavePriorityOrder()
+        {
+            constexpr uint32_t kEventsPerLevel = 200;
+            const unsigned int levels[] = { Event::kPriorityLow, Event::kPriorityNormal, Event::kPriorityHigh };
+
+            JobSystem jobSystem(nullptr, 3);
+            EventManager eventManager(nullptr);
+            eventManager.SetJobSystem(&jobSystem);
+
+            // Ticket order handed out as the handlers run, first and last ticket per level
+            std::atomic<uint32_t> ticket = 0;
+            std::mutex rangeMutex;
+            uint32_t first[3] = { UINT32_MAX, UINT32_MAX, UINT32_MAX };
+            uint32_t last[3] = {};
+
+            const auto subscription = eventManager.AddHandler("TestWaveLevel", { 0, [&](const Event& event)
+            {
+                const uint32_t taken = ticket++;
+                const size_t level = event.GetComponent<SequencePayload>()->GetSequence();
+                std::lock_guard lock(rangeMutex);
+                first[level] = std::min(first[level], taken);
+                last[level] = std::max(last[level], taken);
+            } }, HandlerFlags::kThreadSafe);
+
+            for (uint32_t level = 0; level < 3; ++level)
+            {
+                const Event::EventType type("TestWaveLevel", levels[level]);
+                for (uint32_t i = 0; i < kEventsPerLevel; ++i)
+                {
+                    Event event(type);
+                    event.AddComponent<SequencePayload>(level);
+                    eventManager.PushEvent(event);
+                }
+            }
+
+            eventManager.ProcessEvents();
+            eventManager.RemoveHandler(subscription);
+            eventManager.Destroy();
+
+            // High (2) ran first, then normal (1), then low (0)
+            return ticket == 3 * kEventsPerLevel && last[2] < first[1] && last[1] < first[0];
+        }
+
+        // One unflagged handler next to a thread safe one keeps its event on the main thread
+        static bool TestWaveSerialFallback()
+        {
+            static constexpr Event::EventType kMixedType("TestWaveMixed", Event::kPriorityNormal);
+            static constexpr Event::EventType kSafeType("TestWaveSafe", Event::kPriorityNormal);
+            constexpr uint32_t kEventCount = 500;
+
+            JobSystem jobSystem(nullptr, 3);
+            EventManager eventManager(nullptr);
+            eventManager.SetJobSystem(&jobSystem);
+
+            const std::thread::id mainThread = std::this_thread::get_id();
+            std::atomic<uint32_t> offMainThread = 0;
+            std::atomic<uint32_t> calls = 0;
+            uint32_t serialCalls = 0;
+
+            const auto onMainThreadCheck = [&](const Event&)
+            {
+                offMainThread += std::this_thread::get_id() != mainThread ? 1 : 0;
+                ++calls;
+            };
+
+            const EventSubscription subscriptions[] =
+            {
+                eventManager.AddHandler("TestWaveMixed", { 1, onMainThreadCheck }, HandlerFlags::kThreadSafe),
+                eventManager.AddHandler("TestWaveMixed", { 0, [&](const Event&) { ++serialCalls; } }),
+                eventManager.AddHandler("TestWaveSafe", { 0, [&](const Event&) { ++calls; } }, HandlerFlags::kThreadSafe)
+            };
+
+            // Interleaved so waves of the safe type keep getting cut by the mixed one
+            for (uint32_t i = 0; i < kEventCount; ++i)
+            {
+                eventManager.PushEvent(Event(i % 3 == 0 ? kMixedType : kSafeType));
+            }
+
+            eventManager.ProcessEvents();
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+            eventManager.Destroy();
+
+            const uint32_t mixedCount = (kEventCount + 2) / 3;
+            return offMainThread == 0 && serialCalls == mixedCount && calls == kEventCount;
+        }
+
+        // Type letter, target and payload of every event a coalescing test handled, in dispatch order
+        using DeliveryLog = std::vector<std::tuple<char, int, uint32_t>>;
+
+        // Where the letter sits in "TestCoalesceA"
+        inline static constexpr size_t kCoalesceLetter = sizeof("TestCoalesce") - 1;
+
+        // Handlers for the coalescing types A to D, each logging what it was given
+        static std::vector<EventSubscription> LogCoalesceTypes(EventManager& eventManager, DeliveryLog& log)
+        {
+            std::vector<EventSubscription> subscriptions;
+            for (const char* pName : { "TestCoalesceA", "TestCoalesceB", "TestCoalesceC", "TestCoalesceD" })
+            {
+                const char letter = pName[kCoalesceLetter];
+                subscriptions.push_back(eventManager.AddHandler(pName, { 0, [&log, letter](const Event& event)
+                {
+                    const auto* pPayload = event.GetComponent<SequencePayload>();
+                    log.emplace_back(letter, event.GetTarget(), pPayload ? pPayload->GetSequence() : 0);
+                } }));
+            }
+            return subscriptions;
+        }
+
+        static void PushCoalesce(EventManager& eventManager, const char* pName, int target, uint32_t value)
+        {
+            Event event(Event::EventType(pName, Event::kPriorityNormal), target);
+            event.AddComponent<SequencePayload>(value);
+            eventManager.PushEvent(event);
+        }
+
+        static bool SumSequences(Event& pending, const Event& incoming, FrameArena&)
+        {
+            const uint32_t sum = pending.GetComponent<SequencePayload>()->GetSequence() + incoming.GetComponent<SequencePayload>()->GetSequence();
+            pending.AddComponent<SequencePayload>(sum);
+            return true;
+        }
+
+        // The newest event for a target survives and is queued behind what was pushed before it
+        static bool TestCoalesceLastWins()
+        {
+            EventManager eventManager(nullptr);
+            DeliveryLog log;
+            const auto subscriptions = LogCoalesceTypes(eventManager, log);
+            eventManager.SetCoalescePolicy("TestCoalesceA", EventManager::CoalescePolicy::kLastWins);
+
+            PushCoalesce(eventManager, "TestCoalesceA", 1, 1);
+            PushCoalesce(eventManager, "TestCoalesceA", 2, 1);
+            PushCoalesce(eventManager, "TestCoalesceD", 0, 0);
+            PushCoalesce(eventManager, "TestCoalesceA", 1, 2);
+            PushCoalesce(eventManager, "TestCoalesceA", 1, 3);
+            eventManager.ProcessEvents();
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            const DeliveryLog expected = { { 'A', 2, 1 }, { 'D', 0, 0 }, { 'A', 1, 3 } };
+            return log == expected && eventManager.GetCoalescedCount() == 2 && eventManager.GetProcessedCount() == 3;
+        }
+
+        // Superseded events are out of the queue, they are not dispatched, counted or charged to the budget
+        static bool TestCoalesceLastWinsNotCharged()
+        {
+            EventManager eventManager(nullptr);
+            DeliveryLog log;
+            const auto subscriptions = LogCoalesceTypes(eventManager, log);
+            eventManager.SetCoalescePolicy("TestCoalesceA", EventManager::CoalescePolicy::kLastWins);
+            eventManager.SetProcessBudget({ 0.0, 2, Event::kPriorityHigh, 0 });
+
+            for (uint32_t i = 0; i < 6; ++i)
+            {
+                PushCoalesce(eventManager, "TestCoalesceA", 1, i);
+            }
+            PushCoalesce(eventManager, "TestCoalesceD", 0, 0);
+            PushCoalesce(eventManager, "TestCoalesceD", 0, 1);
+
+            eventManager.ProcessEvents();
+            const EventManager::BacklogReport first = eventManager.GetBacklogReport();
+            const bool isCharged = first.m_processed == 2 && first.m_carriedOver == 1
+                && first.m_bucketDepth[EventQueue::GetBucketIndex(Event::kPriorityNormal)] == 1;
+
+            eventManager.ProcessEvents();
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            const DeliveryLog expected = { { 'A', 1, 5 }, { 'D', 0, 0 }, { 'D', 0, 1 } };
+            return isCharged && log == expected && eventManager.GetProcessedCount() == 3 && eventManager.GetCoalescedCount() == 5;
+        }
+
+        // Later events for a target fold into the pending one, which keeps its place in the queue
+        static bool TestCoalesceMergePayloads()
+        {
+            EventManager eventManager(nullptr);
+            DeliveryLog log;
+            const auto subscriptions = LogCoalesceTypes(eventManager, log);
+            eventManager.SetCoalescePolicy("TestCoalesceC", EventManager::CoalescePolicy::kMergePayloads, &SumSequences);
+
+            PushCoalesce(eventManager, "TestCoalesceC", 1, 1);
+            PushCoalesce(eventManager, "TestCoalesceD", 0, 0);
+            PushCoalesce(eventManager, "TestCoalesceC", 1, 5);
+            PushCoalesce(eventManager, "TestCoalesceC", 2, 7);
+            PushCoalesce(eventManager, "TestCoalesceC", 1, 10);
+            eventManager.ProcessEvents();
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            const DeliveryLog expected = { { 'C', 1, 16 }, { 'D', 0, 0 }, { 'C', 2, 7 } };
+            return log == expected && eventManager.GetCoalescedCount() == 2;
+        }
+
+        // The first event for a target survives, repeats are dropped until it has been dispatched
+        static bool TestCoalesceDedupeByTarget()
+        {
+            EventManager eventManager(nullptr);
+            DeliveryLog log;
+            const auto subscriptions = LogCoalesceTypes(eventManager, log);
+            eventManager.SetCoalescePolicy("TestCoalesceB", EventManager::CoalescePolicy::kDedupeByTarget);
+
+            PushCoalesce(eventManager, "TestCoalesceB", 1, 1);
+            PushCoalesce(eventManager, "TestCoalesceB", 2, 1);
+            PushCoalesce(eventManager, "TestCoalesceB", 1, 2);
+            PushCoalesce(eventManager, "TestCoalesceD", 0, 0);
+            PushCoalesce(eventManager, "TestCoalesceB", 1, 3);
+            eventManager.ProcessEvents();
+
+            // Dispatched, so the next one for the target is queued again
+            PushCoalesce(eventManager, "TestCoalesceB", 1, 9);
+            eventManager.ProcessEvents();
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            const DeliveryLog expected = { { 'B', 1, 1 }, { 'B', 2, 1 }, { 'D', 0, 0 }, { 'B', 1, 9 } };
+            return log == expected && eventManager.GetCoalescedCount() == 2;
+        }
+
+        // Types without a policy keep every event in push order, next to one with a policy that never collides
+        static bool TestCoalesceKeepsFifo()
+        {
+            EventManager eventManager(nullptr);
+            DeliveryLog log;
+            const auto subscriptions = LogCoalesceTypes(eventManager, log);
+            eventManager.SetCoalescePolicy("TestCoalesceA", EventManager::CoalescePolicy::kDedupeByTarget);
+
+            DeliveryLog expected;
+            for (uint32_t i = 0; i < 20; ++i)
+            {
+                // Same target over and over for the types without a policy
+                const char* pName = i % 2 == 0 ? "TestCoalesceC" : "TestCoalesceD";
+                PushCoalesce(eventManager, pName, 1, i);
+                expected.emplace_back(pName[kCoalesceLetter], 1, i);
+
+                if (i % 5 == 0)
+                {
+                    PushCoalesce(eventManager, "TestCoalesceA", static_cast<int>(i), i);
+                    expected.emplace_back('A', static_cast<int>(i), i);
+                }
+            }
+            eventManager.ProcessEvents();
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            return log == expected && eventManager.GetCoalescedCount() == 0;
+        }
+
+        // Ids hashed by the compiler equal the runtime hash, across every tail length and for bytes above 0x7f
+        static bool TestStringIDMatchesRuntime()
+        {
+            // Pinned to the reference Murmur3 (seed 1), so the compile time hash can not drift with the runtime one
+            static_assert(""_sid == 0x514E28B7u && "abc"_sid == 0xAA75E9FFu && "PlayerMoved"_sid == 0x2C73A8E7u,
+                "StringID compile time hash no longer matches Murmur3");
+
+            constexpr StringID kCompiled[] = { ""_sid, "a"_sid, "ab"_sid, "abc"_sid, "abcd"_sid, "TransformComponent"_sid, "\xff\x80\x7f"_sid };
+            const char* pNames[] = { "", "a", "ab", "abc", "abcd", "TransformComponent", "\xff\x80\x7f" };
+
+            bool isMatching = true;
+            for (size_t i = 0; i < std::size(pNames); ++i)
+            {
+                isMatching &= kCompiled[i].GetHash() == Hash::HashString(pNames[i])
+                    && kCompiled[i].GetHash() == Event::EventType::HashEventString(pNames[i]);
+            }
+            return isMatching;
+        }
+
+        // Registering a compile time type's name makes it resolvable, again is harmless. Only kept with
+        // BROKKR_STRING_ID_NAMES, without it nothing resolves
+        static bool TestTypeNameRegistration()
+        {
+            static constexpr Event::EventType kType("TestRegisteredName", Event::kPriorityNormal);
+            const char* pBefore = StringID::Resolve(kType.GetTypeHash());
+
+            kType.RegisterName();
+            kType.RegisterName();
+            const char* pAfter = StringID::Resolve(kType.GetTypeHash());
+
+            // Runtime hashed names register themselves
+            const uint32_t runtimeHash = Event::EventType::HashEventString("TestRuntimeName");
+            const char* pRuntime = StringID::Resolve(runtimeHash);
+
+            if constexpr (BROKKR_STRING_ID_NAMES != 0)
+            {
+                return std::strcmp(pBefore, "") == 0 && std::strcmp(pAfter, "TestRegisteredName") == 0
+                    && std::strcmp(pRuntime, "TestRuntimeName") == 0 && runtimeHash == "TestRuntimeName"_sid;
+            }
+            else
+            {
+                return std::strcmp(pAfter, "") == 0 && std::strcmp(pRuntime, "") == 0 && runtimeHash == "TestRuntimeName"_sid;
+            }
+        }
+
+        // Higher levels come out first and each level keeps push order, pushes between pops included. A priority
+        // between two levels shares the lower level's bucket and its order
+        static bool TestQueuePriorityFifo()
+        {
+            static constexpr unsigned int kPriorities[] =
+            {
+                Event::kPriorityLow, Event::kPriorityMax, Event::kPriorityNormal, Event::kPriorityMin,
+                Event::kPriorityHigh, 700, Event::kPriorityNormal, Event::kPriorityMax
+            };
+            constexpr uint32_t kRounds = 6;
+
+            EventQueue queue;
+            std::vector<std::pair<size_t, uint32_t>> expected;
+            uint32_t sequence = 0;
+            const auto push = [&queue, &expected, &sequence](unsigned int priority)
+            {
+                Event event(Event::EventType("TestQueue", priority));
+                event.AddComponent<SequencePayload>(sequence);
+                queue.Push(event);
+                expected.emplace_back(EventQueue::GetBucketIndex(priority), sequence++);
+            };
+
+            for (uint32_t round = 0; round < kRounds; ++round)
+            {
+                for (const unsigned int priority : kPriorities)
+                {
+                    push(priority);
+                }
+            }
+
+            // Stable sort by bucket is the order the queue must give back
+            std::stable_sort(expected.begin(), expected.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+
+            std::vector<std::pair<size_t, uint32_t>> popped;
+            Event event(Event::EventType("TestQueue", Event::kPriorityNormal));
+            while (queue.Pop(event))
+            {
+                popped.emplace_back(EventQueue::GetBucketIndex(event.GetPriorityLevel()), event.GetComponent<SequencePayload>()->GetSequence());
+
+                // Pushed while the queue drains: a Max one goes behind the Max ones still queued, a Min one last
+                if (popped.size() == 3)
+                {
+                    push(Event::kPriorityMax);
+                    push(Event::kPriorityMin);
+                    const auto maxEnd = std::find_if(expected.begin() + 3, expected.end(), [](const auto& entry) { return entry.first != 0; });
+                    std::rotate(maxEnd, expected.end() - 2, expected.end() - 1);
+                }
+            }
+
+            return popped == expected && queue.IsEmpty() && EventQueue::GetBucketIndex(700) == EventQueue::GetBucketIndex(Event::kPriorityNormal)
+                && EventQueue::GetBucketIndex(Event::kPriorityMax) == 0 && EventQueue::GetBucketIndex(Event::kPriorityMin) == EventQueue::kBucketCount - 1;
+        }
+
+        // Pushes count budget test events starting at first, normal priority unless given another
+        static void PushBudgetEvents(EventManager& eventManager, uint32_t first, uint32_t count, unsigned int priority = Event::kPriorityNormal)
+        {
+            const Event::EventType type("TestBudget", priority);
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                Event event(type);
+                event.AddComponent<SequencePayload>(i);
+                eventManager.PushEvent(event);
+            }
+        }
+
+        // Stops at the event budget, the rest carries over in order ahead of newer events, high priority always drains
+        static bool TestBudgetCarriesOverInOrder()
+        {
+            EventManager eventManager(nullptr);
+            std::vector<uint32_t> order;
+            const auto subscription = eventManager.AddHandler("TestBudget", { 0, [&order](const Event& event)
+            {
+                order.push_back(event.GetComponent<SequencePayload>()->GetSequence());
+            } });
+
+            eventManager.SetProcessBudget({ 0.0, 10, Event::kPriorityHigh, 0 });
+            PushBudgetEvents(eventManager, 0, 25);
+            eventManager.ProcessEvents();
+
+            const size_t normalBucket = EventQueue::GetBucketIndex(Event::kPriorityNormal);
+            const EventManager::BacklogReport first = eventManager.GetBacklogReport();
+            const bool isStopped = order.size() == 10 && first.m_processed == 10 && first.m_carriedOver == 15
+                && first.m_bucketDepth[normalBucket] == 15 && first.m_carryFrames == 1 && first.m_peakCarriedOver == 15;
+
+            // Newer normal events wait behind the backlog, the high ones go past the budget
+            PushBudgetEvents(eventManager, 100, 5);
+            PushBudgetEvents(eventManager, 200, 12, Event::kPriorityHigh);
+            eventManager.ProcessEvents();
+            eventManager.ProcessEvents();
+            eventManager.ProcessEvents();
+            eventManager.RemoveHandler(subscription);
+
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < 10; ++i) { expected.push_back(i); }
+            for (uint32_t i = 200; i < 212; ++i) { expected.push_back(i); }
+            for (uint32_t i = 10; i < 25; ++i) { expected.push_back(i); }
+            for (uint32_t i = 100; i < 105; ++i) { expected.push_back(i); }
+
+            const EventManager::BacklogReport& last = eventManager.GetBacklogReport();
+            return isStopped && order == expected && last.m_carriedOver == 0 && last.m_carryFrames == 0
+                && last.m_peakCarriedOver == 20 && last.m_milliseconds >= 0.0;
+        }
+
+        // The payload arena is only reset by a ProcessEvents that ends with the queue empty
+        static bool TestBudgetArenaReset()
+        {
+            EventManager eventManager(nullptr);
+            eventManager.SetProcessBudget({ 0.0, 4, Event::kPriorityHigh, 0 });
+
+            const uint32_t values[] = { 1, 2, 3 };
+            PushBudgetEvents(eventManager, 0, 6);
+            [[maybe_unused]] const uint32_t* pCopy = eventManager.GetPayloadArena().Copy(values, 3);
+
+            eventManager.ProcessEvents();
+            const bool isKept = eventManager.GetBacklogReport().m_carriedOver == 2 && eventManager.GetPayloadArena().GetBytesUsed() > 0;
+
+            eventManager.ProcessEvents();
+            return isKept && eventManager.GetBacklogReport().m_carriedOver == 0 && eventManager.GetPayloadArena().GetBytesUsed() == 0;
+        }
+
+        // After m_maxCarryFrames frames in a row with a backlog the next call drains it all
+        static bool TestBudgetForcedFlush()
+        {
+            constexpr uint32_t kEventCount = 100;
+            constexpr uint32_t kMaxCarryFrames = 8;
+
+            EventManager eventManager(nullptr);
+            eventManager.SetProcessBudget({ 0.0, 1, Event::kPriorityHigh, kMaxCarryFrames });
+            PushBudgetEvents(eventManager, 0, kEventCount);
+
+            for (uint32_t frame = 1; frame <= kMaxCarryFrames; ++frame)
+            {
+                eventManager.ProcessEvents();
+                const EventManager::BacklogReport& report = eventManager.GetBacklogReport();
+                if (report.m_processed != 1 || report.m_carryFrames != frame || report.m_carriedOver != kEventCount - frame)
+                {
+                    return false;
+                }
+            }
+
+            eventManager.ProcessEvents();
+            const EventManager::BacklogReport& report = eventManager.GetBacklogReport();
+            return report.m_processed == kEventCount - kMaxCarryFrames && report.m_carriedOver == 0 && report.m_carryFrames == 0
+                && report.m_peakCarriedOver == kEventCount - 1 && eventManager.GetProcessedCount() == kEventCount;
+        }
+
+        struct ChannelItem
+        {
+            int m_entityId;
+            uint32_t m_sequence;
+        };
+
+        // Every subscriber gets the whole batch in one call, one contiguous array in push order
+        static bool TestChannelBatchOrder()
+        {
+            constexpr uint32_t kItemCount = 1000;
+
+            struct Receiver
+            {
+                std::vector<std::pair<const ChannelItem*, size_t>> m_batches;
+                bool m_inOrder = true;
+
+                void OnItems(const ChannelItem* pItems, size_t count)
+                {
+                    m_batches.emplace_back(pItems, count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        m_inOrder &= pItems[i].m_sequence == i && pItems[i].m_entityId == static_cast<int>(i % 7);
+                    }
+                }
+            };
+
+            EventManager eventManager(nullptr);
+            auto& channel = eventManager.GetChannel<ChannelItem>();
+
+            Receiver first;
+            Receiver second;
+            channel.Subscribe<Receiver, &Receiver::OnItems>(&first);
+            channel.Subscribe<Receiver, &Receiver::OnItems>(&second);
+
+            for (uint32_t i = 0; i < kItemCount; ++i)
+            {
+                channel.Push({ static_cast<int>(i % 7), i });
+            }
+            eventManager.ProcessEvents();
+
+            // Nothing new, no second call
+            eventManager.ProcessEvents();
+
+            return first.m_inOrder && second.m_inOrder && first.m_batches.size() == 1 && second.m_batches.size() == 1
+                && first.m_batches[0].second == kItemCount && first.m_batches[0] == second.m_batches[0]
+                && channel.GetPendingCount() == 0;
+        }
+
+        // Batches go out at the start of ProcessEvents, ahead of queued events. What a subscriber pushes as an event
+        // is handled in the same call, what it pushes to a channel waits for the next batch
+        static bool TestChannelDeliveredFirst()
+        {
+            static constexpr Event::EventType kQueuedType("TestChannelQueued", Event::kPriorityMax);
+            static constexpr Event::EventType kFromBatchType("TestChannelFromBatch", Event::kPriorityNormal);
+
+            struct Receiver
+            {
+                EventManager* m_pEventManager = nullptr;
+                std::vector<std::string>* m_pLog = nullptr;
+
+                void OnItems(const ChannelItem* pItems, size_t count)
+                {
+                    m_pLog->push_back("batch " + std::to_string(count));
+                    m_pEventManager->PushEvent(Event(kFromBatchType));
+                    if (pItems[0].m_sequence == 0)
+                    {
+                        m_pEventManager->GetChannel<ChannelItem>().Push({ 0, 1 });
+                    }
+                }
+            };
+
+            EventManager eventManager(nullptr);
+            std::vector<std::string> log;
+            Receiver receiver{ &eventManager, &log };
+            auto& channel = eventManager.GetChannel<ChannelItem>();
+            channel.Subscribe<Receiver, &Receiver::OnItems>(&receiver);
+
+            const EventSubscription subscriptions[] =
+            {
+                eventManager.AddHandler("TestChannelQueued", { 0, [&log](const Event&) { log.emplace_back("queued"); } }),
+                eventManager.AddHandler("TestChannelFromBatch", { 0, [&log](const Event&) { log.emplace_back("from batch"); } })
+            };
+
+            // The event is queued first and at the highest priority, the batch still goes before it
+            eventManager.PushEvent(Event(kQueuedType));
+            channel.Push({ 0, 0 });
+            channel.Push({ 1, 0 });
+            eventManager.ProcessEvents();
+            const bool isSecondBatchWaiting = channel.GetPendingCount() == 1;
+            eventManager.ProcessEvents();
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            const std::vector<std::string> expected = { "batch 2", "queued", "from batch", "batch 1", "from batch" };
+            return isSecondBatchWaiting && log == expected;
+        }
+
+        // Counts handler calls and the hits they were handed
+        struct CollisionCounter
+        {
+            uint32_t m_events = 0;
+            uint32_t m_hits = 0;
+
+            static void OnCollision(void* pContext, const Event& event)
+            {
+                auto* pCounter = static_cast<CollisionCounter*>(pContext);
+                const CollisionPayload* pPayload = event.GetComponent<CollisionPayload>();
+                ++pCounter->m_events;
+                pCounter->m_hits += pPayload ? pPayload->GetHitCount() : 0;
+            }
+        };
+
+        // Once the queue and the payload arena are warm, pushing and processing collision events does no heap work
+        static bool TestCollisionNoAllocations()
+        {
+            static constexpr Event::EventType kCollisionType("TestCollision", Event::kPriorityNormal);
+            constexpr uint32_t kFrameCount = 4;
+            constexpr uint32_t kEventsPerFrame = 100;
+            constexpr int kHits[] = { 3, 5, 8, 13 };
+
+            if (!AllocationTracker::IsTracking())
+            {
+                std::cout << "  allocation tracking is off in this build, nothing to check\n";
+                return true;
+            }
+
+            EventManager eventManager(nullptr);
+            CollisionCounter counter;
+            const auto subscription = eventManager.AddHandler("TestCollision", Event::kPriorityNormal, EventDelegate::FromCallback(&CollisionCounter::OnCollision, &counter));
+
+            // Same shape as PhysicsManager::MoveNotify: one arena copy of the hit list shared by every event of the move
+            uint64_t warmAllocations = 0;
+            for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+            {
+                if (frame == 1)
+                {
+                    warmAllocations = AllocationTracker::GetAllocationCount();
+                }
+
+                const int* pHits = eventManager.GetPayloadArena().Copy(kHits, std::size(kHits));
+                for (uint32_t i = 0; i < kEventsPerFrame; ++i)
+                {
+                    Event event(kCollisionType);
+                    event.AddComponent<CollisionPayload>(nullptr, pHits, static_cast<uint32_t>(std::size(kHits)), Vector2<float>(1.f, 0.f));
+                    eventManager.PushEvent(event);
+                }
+                eventManager.ProcessEvents();
+            }
+
+            const uint64_t allocations = AllocationTracker::GetAllocationCount() - warmAllocations;
+            eventManager.RemoveHandler(subscription);
+
+            return allocations == 0 && counter.m_events == kFrameCount * kEventsPerFrame
+                && counter.m_hits == kFrameCount * kEventsPerFrame * static_cast<uint32_t>(std::size(kHits));
+        }
+
+        // Push and dispatch cost over many event types with a few handlers each, best of several rounds
+        static bool BenchmarkDispatch()
+        {
+            constexpr size_t kTypeCount = 1000;
+            constexpr size_t kHandlersPerType = 4;
+            constexpr size_t kEventCount = 200000;
+            constexpr int kRoundCount = 10;
+
+            // EventType keeps the name pointer, the strings outlive it
+            std::vector<std::string> names;
+            std::vector<Event::EventType> types;
+            names.reserve(kTypeCount);
+            types.reserve(kTypeCount);
+
+            EventManager eventManager(nullptr);
+            uint64_t callCount = 0;
+            std::vector<EventSubscription> subscriptions;
+            for (size_t i = 0; i < kTypeCount; ++i)
+            {
+                names.push_back("TestBenchmark" + std::to_string(i));
+                types.emplace_back(names.back().c_str(), Event::kPriorityNormal);
+                for (size_t handler = 0; handler < kHandlersPerType; ++handler)
+                {
+                    subscriptions.push_back(eventManager.AddHandler(types.back().GetTypeHash(), static_cast<int>(handler),
+                        EventDelegate::FromCallback([](void* pContext, const Event&) { ++*static_cast<uint64_t*>(pContext); }, &callCount)));
+                }
+            }
+
+            double bestMilliseconds = 0.0;
+            for (int round = 0; round < kRoundCount; ++round)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < kEventCount; ++i)
+                {
+                    eventManager.PushEvent(Event(types[i % kTypeCount]));
+                }
+                eventManager.ProcessEvents();
+                const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                bestMilliseconds = round == 0 ? milliseconds : std::min(bestMilliseconds, milliseconds);
+            }
+
+            for (const auto& subscription : subscriptions)
+            {
+                eventManager.RemoveHandler(subscription);
+            }
+
+            std::cout << "  EventManager push and process " << bestMilliseconds << "ms for " << kEventCount << " events over "
+                << kTypeCount << " types x " << kHandlersPerType << " handlers, best of " << kRoundCount << "\n";
+
+            return callCount == kEventCount * kHandlersPerType * kRoundCount;
+        }
+
+    public:
+
+        static void RegisterEventManagerTests(UnitTestSystem* pTestSystem)
+        {
+            pTestSystem->AddTest("EventManager StringIDMatchesRuntime", TestStringIDMatchesRuntime);
+            pTestSystem->AddTest("EventManager TypeNameRegistration", TestTypeNameRegistration);
+            pTestSystem->AddTest("EventManager QueuePriorityFifo", TestQueuePriorityFifo);
+            pTestSystem->AddTest("EventManager ConcurrentPushStress", TestConcurrentPushStress);
+            pTestSystem->AddTest("EventManager ConcurrentPushDeterministic", TestConcurrentPushDeterministic);
+            pTestSystem->AddTest("EventManager WaveEntityOrder", TestWaveEntityOrder);
+            pTestSystem->AddTest("EventManager WaveMatchesSerial", TestWaveMatchesSerial);
+            pTestSystem->AddTest("EventManager WavePriorityOrder", TestWavePriorityOrder);
+            pTestSystem->AddTest("EventManager WaveSerialFallback", TestWaveSerialFallback);
+            pTestSystem->AddTest("EventManager CoalesceLastWins", TestCoalesceLastWins);
+            pTestSystem->AddTest("EventManager CoalesceLastWinsNotCharged", TestCoalesceLastWinsNotCharged);
+            pTestSystem->AddTest("EventManager CoalesceMergePayloads", TestCoalesceMergePayloads);
+            pTestSystem->AddTest("EventManager CoalesceDedupeByTarget", TestCoalesceDedupeByTarget);
+            pTestSystem->AddTest("EventManager CoalesceKeepsFifo", TestCoalesceKeepsFifo);
+            pTestSystem->AddTest("EventManager BudgetCarriesOverInOrder", TestBudgetCarriesOverInOrder);
+            pTestSystem->AddTest("EventManager BudgetArenaReset", TestBudgetArenaReset);
+            pTestSystem->AddTest("EventManager BudgetForcedFlush", TestBudgetForcedFlush);
+            pTestSystem->AddTest("EventManager ChannelBatchOrder", TestChannelBatchOrder);
+            pTestSystem->AddTest("EventManager ChannelDeliveredFirst", TestChannelDeliveredFirst);
+            pTestSystem->AddTest("EventManager CollisionNoAllocations", TestCollisionNoAllocations);
+            pTestSystem->AddTest("EventManager BenchmarkDispatch", BenchmarkDispatch);
+        }
+    };
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Core/FrameScheduler.h"
+#include "UnitTests/UnitTestSystem.h"
+
+namespace Brokkr
+{
+    class FrameSchedulerTest
+    {
+        using Phase = FrameScheduler::Phase;
+
+        // Stage context, appends its name to the shared run order
+        struct Probe
+        {
+            std::vector<std::string>* m_pOrder;
+            const char* m_pName;
+        };
+
+        static void RunProbe(void* pContext)
+        {
+            const Probe* pProbe = static_cast<Probe*>(pContext);
+            pProbe->m_pOrder->emplace_back(pProbe->m_pName);
+        }
+
+        [[nodiscard]] static const FrameScheduler::StageTiming* FindTiming(const FrameScheduler& scheduler, const char* pName)
+        {
+            for (const FrameScheduler::StageTiming& timing : scheduler.GetStageTimings())
+            {
+                if (std::strcmp(timing.m_pName, pName) == 0)
+                {
+                    return &timing;
+                }
+            }
+
+            return nullptr;
+        }
+
+        [[nodiscard]] static bool HasLevel(const FrameScheduler& scheduler, const char* pName, size_t level)
+        {
+            const FrameScheduler::StageTiming* pTiming = FindTiming(scheduler, pName);
+            return pTiming != nullptr && pTiming->m_level == level;
+        }
+
+        [[nodiscard]] static size_t RunIndex(const std::vector<std::string>& order, const char* pName)
+        {
+            return static_cast<size_t>(std::find(order.begin(), order.end(), pName) - order.begin());
+        }
+
+        [[nodiscard]] static bool IsCycleStage(const FrameScheduler& scheduler, const char* pName)
+        {
+            const auto& stages = scheduler.GetCycleStages();
+            return std::any_of(stages.begin(), stages.end(), [pName](const char* pStage) { return std::strcmp(pStage, pName) == 0; });
+        }
+
+        static void RunFrame(FrameScheduler& scheduler, Phase phase)
+        {
+            scheduler.BeginFrame();
+            scheduler.RunPhase(phase);
+            scheduler.EndFrame();
+        }
+
+        // A second stage under a taken name is refused, the first one keeps running
+        static bool TestDuplicateNameRefused()
+        {
+            std::vector<std::string> order;
+            Probe first{ &order, "First" };
+            Probe second{ &order, "Second" };
+
+            FrameScheduler scheduler;
+            if (!scheduler.AddStage("Stage", Phase::kSimulation, &RunProbe, &first)
+                || scheduler.AddStage("Stage", Phase::kSimulation, &RunProbe, &second))
+            {
+                return false;
+            }
+
+            if (!scheduler.Build() || scheduler.GetStageTimings().size() != 1)
+            {
+                return false;
+            }
+
+            RunFrame(scheduler, Phase::kSimulation);
+            return order == std::vector<std::string>{ "First" };
+        }
+
+        // Build fails, the cycle and the stage waiting on it are reported, the phase still runs in registration order
+        static bool TestCycleReported()
+        {
+            std::vector<std::string> order;
+            Probe a{ &order, "A" };
+            Probe b{ &order, "B" };
+            Probe c{ &order, "C" };
+            Probe free{ &order, "Free" };
+
+            FrameScheduler scheduler;
+            scheduler.AddStage("A", Phase::kSimulation, &RunProbe, &a);
+            scheduler.AddStage("B", Phase::kSimulation, &RunProbe, &b);
+            scheduler.AddStage("C", Phase::kSimulation, &RunProbe, &c);
+            scheduler.AddStage("Free", Phase::kSimulation, &RunProbe, &free);
+            scheduler.AddDependency("A", "B");
+            scheduler.AddDependency("B", "A");
+            scheduler.AddDependency("C", "A");
+
+            if (scheduler.Build())
+            {
+                return false;
+            }
+
+            if (scheduler.GetCycleStages().size() != 3 || !IsCycleStage(scheduler, "A") || !IsCycleStage(scheduler, "B")
+                || !IsCycleStage(scheduler, "C") || IsCycleStage(scheduler, "Free"))
+            {
+                return false;
+            }
+
+            RunFrame(scheduler, Phase::kSimulation);
+            return order == std::vector<std::string>{ "A", "B", "C", "Free" };
+        }
+
+        // One level past the deepest stage waited on, dependencies across phases ignored
+        static bool TestLevelAssignment()
+        {
+            std::vector<std::string> order;
+            Probe input{ &order, "Input" };
+            Probe physics{ &order, "Physics" };
+            Probe audio{ &order, "Audio" };
+            Probe late{ &order, "Late" };
+            Probe free{ &order, "Free" };
+            Probe draw{ &order, "Draw" };
+
+            FrameScheduler scheduler;
+            scheduler.AddStage("Late", Phase::kSimulation, &RunProbe, &late);
+            scheduler.AddStage("Physics", Phase::kSimulation, &RunProbe, &physics);
+            scheduler.AddStage("Input", Phase::kSimulation, &RunProbe, &input);
+            scheduler.AddStage("Audio", Phase::kSimulation, &RunProbe, &audio);
+            scheduler.AddStage("Free", Phase::kSimulation, &RunProbe, &free);
+            scheduler.AddStage("Draw", Phase::kRender, &RunProbe, &draw);
+            scheduler.AddDependency("Physics", "Input");
+            scheduler.AddDependency("Audio", "Input");
+            scheduler.AddDependency("Late", "Physics");
+            scheduler.AddDependency("Late", "Audio");
+            scheduler.AddDependency("Late", "Input");
+            scheduler.AddDependency("Draw", "Late");
+
+            if (!scheduler.Build() || !scheduler.GetCycleStages().empty())
+            {
+                return false;
+            }
+
+            if (!HasLevel(scheduler, "Input", 0) || !HasLevel(scheduler, "Free", 0) || !HasLevel(scheduler, "Physics", 1)
+                || !HasLevel(scheduler, "Audio", 1) || !HasLevel(scheduler, "Late", 2) || !HasLevel(scheduler, "Draw", 0))
+            {
+                return false;
+            }
+
+            RunFrame(scheduler, Phase::kSimulation);
+            if (order.size() != 5)
+            {
+                return false;
+            }
+
+            return RunIndex(order, "Input") < RunIndex(order, "Physics") && RunIndex(order, "Input") < RunIndex(order, "Audio")
+                && RunIndex(order, "Physics") < RunIndex(order, "Late") && RunIndex(order, "Audio") < RunIndex(order, "Late");
+        }
+
+        // A dependency on a stage that was never added is skipped, the stage still runs
+        static bool TestUnknownDependencySkipped()
+        {
+            std::vector<std::string> order;
+            Probe stage{ &order, "Stage" };
+            Probe after{ &order, "After" };
+
+            FrameScheduler scheduler;
+            scheduler.AddStage("Stage", Phase::kSimulation, &RunProbe, &stage);
+            scheduler.AddStage("After", Phase::kSimulation, &RunProbe, &after);
+            scheduler.AddDependency("Stage", "Missing");
+            scheduler.AddDependency("Missing", "Stage");
+            scheduler.AddDependency("After", "Stage");
+
+            if (!scheduler.Build() || !HasLevel(scheduler, "Stage", 0) || !HasLevel(scheduler, "After", 1))
+            {
+                return false;
+            }
+
+            RunFrame(scheduler, Phase::kSimulation);
+            return order == std::vector<std::string>{ "Stage", "After" };
+        }
+
+    public:
+        static void RegisterFrameSchedulerTests(UnitTestSystem* pTestSystem)
+        {
+            pTestSystem->AddTest("FrameScheduler DuplicateNameRefused", TestDuplicateNameRefused);
+            pTestSystem->AddTest("FrameScheduler CycleReported", TestCycleReported);
+            pTestSystem->AddTest("FrameScheduler LevelAssignment", TestLevelAssignment);
+            pTestSystem->AddTest("FrameScheduler UnknownDependencySkipped", TestUnknownDependencySkipped);
+        }
+    };
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core/FrameTimer.h"
+#include "Input/InputSystem.h"
+#include "UnitTests/ScopedTestFile.h"
+#include "UnitTests/UnitTestSystem.h"
+
+namespace Brokkr
+{
+    class InputSystemTest
+    {
+        inline static constexpr int kFrameCount = 50;
+        inline static constexpr int32_t kKey = 'w';
+
+        // Frame i: a key goes down on 10, up on 20, the mouse moves every 3rd, steps cycle 0..2
+        static int StepsFor(int frame) { return frame % 3; }
+
+        static void PushFrameInput(InputSystem& input, int frame)
+        {
+            if (frame == 10 || frame == 20)
+            {
+                InputEvent event;
+                event.m_type = frame == 10 ? InputEventType::kKeyDown : InputEventType::kKeyUp;
+                event.m_key = kKey;
+                input.PushEvent(event);
+            }
+
+            if (frame % 3 == 0)
+            {
+                InputEvent event;
+                event.m_type = InputEventType::kMouseMove;
+                event.m_x = frame;
+                event.m_y = -frame;
+                input.PushEvent(event);
+            }
+        }
+
+        // Key state along the way, the frame's events
+        struct FrameState
+        {
+            bool m_isKeyDown;
+            bool m_wasKeyPressed;
+            int32_t m_mouseX;
+            size_t m_events;
+        };
+
+        static FrameState GetState(const InputSystem& input)
+        {
+            return { input.IsKeyDown(kKey), input.WasKeyPressed(kKey), input.GetMouseX(), input.GetFrameEvents().size() };
+        }
+
+        // The replay gives back every frame's events, state and steps, then ends
+        static bool TestRecordReplay()
+        {
+            const ScopedTestFile recording("InputSystemTest.binp");
+            const std::string& path = recording.GetPath();
+            std::vector<FrameState> recorded;
+
+            {
+                InputSystem input(nullptr);
+                if (!input.StartRecording(path, { 1234, 60.0 }))
+                {
+                    return false;
+                }
+
+                for (int frame = 0; frame < kFrameCount; ++frame)
+                {
+                    input.PollEvents();
+                    PushFrameInput(input, frame);
+                    recorded.push_back(GetState(input));
+                    input.EndFrame(StepsFor(frame));
+                }
+                input.StopRecording();
+            }
+
+            InputSystem replay(nullptr);
+            InputSystem::SessionInfo info;
+            if (!replay.StartReplay(path, info) || info.m_seed != 1234 || info.m_ticksPerSecond != 60.0)
+            {
+                return false;
+            }
+
+            for (int frame = 0; frame < kFrameCount; ++frame)
+            {
+                if (replay.HasReplayEnded())
+                {
+                    return false;
+                }
+
+                replay.PollEvents();
+                PushFrameInput(replay, frame);     // ignored, live input does not reach a replay
+
+                const FrameState state = GetState(replay);
+                const FrameState& expected = recorded[frame];
+                if (state.m_isKeyDown != expected.m_isKeyDown || state.m_wasKeyPressed != expected.m_wasKeyPressed
+                    || state.m_mouseX != expected.m_mouseX || state.m_events != expected.m_events
+                    || replay.GetReplaySteps() != StepsFor(frame))
+                {
+                    return false;
+                }
+                replay.EndFrame(replay.GetReplaySteps());
+            }
+
+            return replay.HasReplayEnded() && recorded[10].m_wasKeyPressed && !recorded[20].m_isKeyDown;
+        }
+
+        // A replayed frame runs its recorded steps whatever the accumulator holds
+        static bool TestScriptedSteps()
+        {
+            FrameTimer timer;
+            timer.SetTickRate(60.0);
+
+            // More than the catch up limit, then none at all
+            timer.SetMaxCatchUpSteps(2);
+            for (const int expected : { 3, 0 })
+            {
+                timer.BeginFrame();
+                timer.SetStepsThisFrame(expected);
+
+                int steps = 0;
+                while (timer.ConsumeStep())
+                {
+                    ++steps;
+                }
+
+                if (steps != expected || timer.GetStepsThisFrame() != expected)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    public:
+
+        static void RegisterInputSystemTests(UnitTestSystem* pTestSystem)
+        {
+            pTestSystem->AddTest("InputSystem RecordReplay", TestRecordReplay);
+            pTestSystem->AddTest("InputSystem ScriptedSteps", TestScriptedSteps);
+        }
+    };
+}
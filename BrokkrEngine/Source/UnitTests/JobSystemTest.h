@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "JobSystem/JobSystem.h"
+#include "UnitTests/UnitTestSystem.h"
+
+namespace Brokkr
+{
+    class JobSystemTest
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Every index visited exactly once
+        static bool TestParallelForCoverage()
+        {
+            JobSystem jobSystem(nullptr);
+
+            for (const size_t count : { size_t(1), size_t(7), size_t(1000), size_t(100003) })
+            {
+                std::vector<std::atomic<int>> visits(count);
+                jobSystem.ParallelFor(count, 16, [&visits](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        ++visits[i];
+                    }
+                });
+
+                for (const auto& visit : visits)
+                {
+                    if (visit.load() != 1)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // A RunAfter job sees every job of its dependency finished, main thread jobs stay on the main thread
+        static bool TestDependenciesAndAffinity()
+        {
+            JobSystem jobSystem(nullptr);
+
+            struct Context
+            {
+                std::atomic<int> m_finished{ 0 };
+                int m_seenByContinuation = -1;
+                std::thread::id m_mainThread = std::this_thread::get_id();
+                bool m_ranOnMain = false;
+            } context;
+
+            constexpr int kJobCount = 200;
+            JobCounter first;
+            JobCounter second;
+
+            for (int i = 0; i < kJobCount; ++i)
+            {
+                jobSystem.Run([](void* pContext) { ++static_cast<Context*>(pContext)->m_finished; }, &context, &first);
+            }
+
+            jobSystem.RunAfter(first, [](void* pContext)
+            {
+                auto* pThis = static_cast<Context*>(pContext);
+                pThis->m_seenByContinuation = pThis->m_finished.load();
+            }, &context, &second);
+
+            jobSystem.RunAfter(first, [](void* pContext)
+            {
+                auto* pThis = static_cast<Context*>(pContext);
+                pThis->m_ranOnMain = std::this_thread::get_id() == pThis->m_mainThread;
+            }, &context, &second, JobSystem::Affinity::kMainThread);
+
+            jobSystem.Wait(second);
+
+            return context.m_seenByContinuation == kJobCount && context.m_ranOnMain;
+        }
+
+        // Once per participant, each on its own thread
+        static bool TestBroadcast()
+        {
+            JobSystem jobSystem(nullptr);
+
+            struct Context
+            {
+                JobSystem* m_pJobSystem;
+                std::vector<int> m_hits;
+                std::vector<std::thread::id> m_threads;
+            } context{ &jobSystem, std::vector<int>(jobSystem.GetParticipantCount(), 0), std::vector<std::thread::id>(jobSystem.GetParticipantCount()) };
+
+            jobSystem.Broadcast([](void* pContext, size_t participant)
+            {
+                auto* pThis = static_cast<Context*>(pContext);
+                if (pThis->m_pJobSystem->GetCurrentParticipant() == participant)
+                {
+                    ++pThis->m_hits[participant];
+                }
+                pThis->m_threads[participant] = std::this_thread::get_id();
+            }, &context);
+
+            for (size_t i = 0; i < context.m_hits.size(); ++i)
+            {
+                for (size_t j = i + 1; j < context.m_threads.size(); ++j)
+                {
+                    if (context.m_threads[i] == context.m_threads[j])
+                    {
+                        return false;
+                    }
+                }
+
+                if (context.m_hits[i] != 1)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Small tasks, the case a frame is made of: the job system against a new std::thread per task
+        static bool BenchmarkAgainstThreadPerTask()
+        {
+            constexpr size_t kTaskCount = 2000;
+            constexpr int kWorkPerTask = 2000;
+
+            struct Task
+            {
+                double m_result = 0.0;
+
+                void Run()
+                {
+                    double value = 0.0;
+                    for (int i = 1; i <= kWorkPerTask; ++i)
+                    {
+                        value += std::sqrt(static_cast<double>(i));
+                    }
+                    m_result = value;
+                }
+            };
+
+            std::vector<Task> naiveTasks(kTaskCount);
+            std::vector<Task> jobTasks(kTaskCount);
+
+            const auto naiveStart = Clock::now();
+            {
+                // Threads are joined in batches the size of the machine so they do not all exist at once
+                const size_t batch = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+                std::vector<std::thread> threads;
+                for (size_t begin = 0; begin < kTaskCount; begin += batch)
+                {
+                    for (size_t i = begin; i < std::min(begin + batch, kTaskCount); ++i)
+                    {
+                        threads.emplace_back([&naiveTasks, i]() { naiveTasks[i].Run(); });
+                    }
+                    for (auto& thread : threads)
+                    {
+                        thread.join();
+                    }
+                    threads.clear();
+                }
+            }
+            const double naiveMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - naiveStart).count();
+
+            JobSystem jobSystem(nullptr);
+            const auto jobStart = Clock::now();
+            {
+                JobCounter counter;
+                for (auto& task : jobTasks)
+                {
+                    jobSystem.Run([](void* pContext) { static_cast<Task*>(pContext)->Run(); }, &task, &counter);
+                }
+                jobSystem.Wait(counter);
+            }
+            const double jobMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - jobStart).count();
+
+            std::cout << "  JobSystem " << jobMilliseconds << "ms vs thread per task " << naiveMilliseconds << "ms for "
+                << kTaskCount << " tasks on " << jobSystem.GetParticipantCount() << " threads\n";
+
+            for (size_t i = 0; i < kTaskCount; ++i)
+            {
+                if (naiveTasks[i].m_result != jobTasks[i].m_result)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    public:
+
+        static void RegisterJobSystemTests(UnitTestSystem* pTestSystem)
+        {
+            pTestSystem->AddTest("JobSystem ParallelForCoverage", TestParallelForCoverage);
+            pTestSystem->AddTest("JobSystem DependenciesAndAffinity", TestDependenciesAndAffinity);
+            pTestSystem->AddTest("JobSystem Broadcast", TestBroadcast);
+            pTestSystem->AddTest("JobSystem BenchmarkAgainstThreadPerTask", BenchmarkAgainstThreadPerTask);
+        }
+    };
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/FrameScheduler.h"
+#include "Profiler/FrameStatistics.h"
+#include "Profiler/HitchDetector.h"
+#include "Profiler/Profiler.h"
+#include "Utility/BinaryStream.h"
+#include "UnitTests/ScopedTestFile.h"
+#include "UnitTests/UnitTestSystem.h"
+
+namespace Brokkr
+{
+    class ProfilerTest
+    {
+        using Clock = std::chrono::steady_clock;
+
+        inline static constexpr int kThreadCount = 3;
+        inline static constexpr int kZonesPerThread = 100;
+
+        // The Profiler's continuous recording as a test found it, put back on every way out of the test
+        class ProfilerStateScope
+        {
+            uint32_t m_continuousHolders = Profiler::GetContinuousRecordingHolders();
+
+        public:
+            ~ProfilerStateScope()
+            {
+                while (Profiler::GetContinuousRecordingHolders() > m_continuousHolders)
+                {
+                    Profiler::EndContinuousRecording();
+                }
+                while (Profiler::GetContinuousRecordingHolders() < m_continuousHolders)
+                {
+                    Profiler::BeginContinuousRecording();
+                }
+            }
+        };
+
+        // One frame of zones on the main thread and a few others, captured and written as path
+        static void CaptureOneFrame(Profiler::Format format, const std::string& path)
+        {
+            Profiler::RequestCapture(1, format, path);
+            Profiler::EndFrame();   // starts the capture
+
+            std::vector<std::thread> threads;
+            for (int i = 0; i < kThreadCount; ++i)
+            {
+                threads.emplace_back([]()
+                {
+                    Profiler::SetThreadName("Profiler Test Thread");
+                    for (int zone = 0; zone < kZonesPerThread; ++zone)
+                    {
+                        BROKKR_PROFILE_SCOPE("Test \"Zone\"");
+                    }
+                });
+            }
+
+            {
+                BROKKR_PROFILE_SCOPE("Test Outer");
+                BROKKR_PROFILE_SCOPE("Test Inner");
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            Profiler::EndFrame();   // collects and writes
+        }
+
+        // Every zone of every thread ends up in the trace, names escaped
+        static bool TestChromeTrace()
+        {
+            if (Profiler::IsCapturing())
+            {
+                return true;
+            }
+
+            const ScopedTestFile output("ProfilerTest.json");
+            const std::string& path = output.GetPath();
+            CaptureOneFrame(Profiler::Format::kChromeTrace, path);
+            if (Profiler::GetLastCapturePath() != path)
+            {
+                return false;
+            }
+
+            std::ifstream file(path);
+            std::stringstream contents;
+            contents << file.rdbuf();
+            const std::string trace = contents.str();
+
+            size_t zones = 0;
+            for (size_t at = trace.find("\"name\":\"Test \\\"Zone\\\"\""); at != std::string::npos; at = trace.find("\"name\":\"Test \\\"Zone\\\"\"", at + 1))
+            {
+                ++zones;
+            }
+
+            return zones == kThreadCount * kZonesPerThread
+                && trace.find("\"name\":\"Test Inner\"") != std::string::npos
+                && trace.find("\"thread_name\"") != std::string::npos
+                && Profiler::GetDroppedZones() == 0;
+        }
+
+        // Reads back the header and the zone count of the binary format
+        static bool TestBinary()
+        {
+            if (Profiler::IsCapturing())
+            {
+                return true;
+            }
+
+            const ScopedTestFile output("ProfilerTest.bprof");
+            const std::string& path = output.GetPath();
+            CaptureOneFrame(Profiler::Format::kBinary, path);
+
+            BinaryReader reader;
+            if (!reader.LoadFromFile(path.c_str()))
+            {
+                return false;
+            }
+
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint32_t frames = 0;
+            uint64_t captureStart = 0;
+            reader.Read(magic);
+            reader.Read(version);
+            reader.Read(frames);
+            reader.Read(captureStart);
+            if (magic != Profiler::kBinaryMagic || version != Profiler::kBinaryVersion || frames != 1)
+            {
+                return false;
+            }
+
+            uint32_t threadCount = 0;
+            reader.Read(threadCount);
+            for (uint32_t i = 0; i < threadCount; ++i)
+            {
+                uint32_t index = 0;
+                std::string name;
+                reader.Read(index);
+                reader.ReadString(name);
+            }
+
+            uint32_t nameCount = 0;
+            reader.Read(nameCount);
+            std::vector<std::string> names(nameCount);
+            for (auto& name : names)
+            {
+                reader.ReadString(name);
+            }
+
+            uint32_t zoneCount = 0;
+            reader.Read(zoneCount);
+            size_t testZones = 0;
+            for (uint32_t i = 0; i < zoneCount; ++i)
+            {
+                uint32_t nameIndex = 0;
+                uint32_t thread = 0;
+                uint64_t start = 0;
+                uint64_t duration = 0;
+                reader.Read(nameIndex);
+                reader.Read(thread);
+                reader.Read(start);
+                reader.Read(duration);
+                if (nameIndex >= names.size())
+                {
+                    return false;
+                }
+                testZones += names[nameIndex] == "Test \"Zone\"" ? 1 : 0;
+            }
+
+            return !reader.HasFailed() && reader.GetRemaining() == 0 && testZones == kThreadCount * kZonesPerThread;
+        }
+
+        // Threads that ended are gone once their zones are in the capture, and their names with them
+        static bool TestEndedThreadsReleased()
+        {
+            if (Profiler::IsCapturing() || Profiler::IsContinuousRecording())
+            {
+                return true;
+            }
+
+            const ScopedTestFile output("ProfilerTest.json");
+            const std::string& path = output.GetPath();
+            CaptureOneFrame(Profiler::Format::kChromeTrace, path);     // the main thread has its buffer after this
+            const size_t threadCount = Profiler::GetThreadCount();
+
+            // Named but never recorded, there was no ring to give back
+            std::thread([]() { Profiler::SetThreadName("Profiler Named Thread"); }).join();
+            const bool isNamedReleased = Profiler::GetThreadCount() == threadCount;
+
+            CaptureOneFrame(Profiler::Format::kChromeTrace, path);
+            std::ifstream file(path);
+            std::stringstream contents;
+            contents << file.rdbuf();
+            const std::string trace = contents.str();
+
+            return isNamedReleased && Profiler::GetThreadCount() == threadCount
+                && trace.find("\"name\":\"Test \\\"Zone\\\"\"") != std::string::npos
+                && trace.find("Profiler Test Thread") == std::string::npos
+                && trace.find("Profiler Named Thread") == std::string::npos;
+        }
+
+        // What a zone costs while recording and while idle
+        static bool BenchmarkZoneOverhead()
+        {
+            if (Profiler::IsCapturing())
+            {
+                return true;
+            }
+
+            constexpr int kZoneCount = 20000;   // under a ring, nothing dropped
+
+            const auto idleStart = Clock::now();
+            for (int i = 0; i < kZoneCount; ++i)
+            {
+                BROKKR_PROFILE_SCOPE("Benchmark Zone");
+            }
+            const double idleNanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - idleStart).count() / kZoneCount;
+
+            const ScopedTestFile output("ProfilerBenchmark.bprof");
+            Profiler::RequestCapture(1, Profiler::Format::kBinary, output.GetPath());
+            Profiler::EndFrame();
+
+            const auto recordingStart = Clock::now();
+            for (int i = 0; i < kZoneCount; ++i)
+            {
+                BROKKR_PROFILE_SCOPE("Benchmark Zone");
+            }
+            const double recordingNanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - recordingStart).count() / kZoneCount;
+
+            Profiler::EndFrame();
+
+            std::cout << "  Profiler zone " << recordingNanoseconds << "ns recording, " << idleNanoseconds << "ns idle\n";
+            return Profiler::GetDroppedZones() == 0;
+        }
+
+        // Steady 1ms frames with one spike: one hitch, dumped with the frames around it and their zones
+        static bool TestHitchDetection()
+        {
+            if (Profiler::IsCapturing() || Profiler::IsContinuousRecording())
+            {
+                return true;
+            }
+
+            constexpr size_t kWindow = 60;
+            constexpr size_t kFramesAfter = 5;
+            constexpr uint64_t kSpikeFrame = 80;
+
+            const ProfilerStateScope profilerState;
+            const ScopedTestFile output("HitchTest/");
+            FrameScheduler scheduler;
+            scheduler.Build();
+
+            HitchDetector detector;
+            detector.Configure({ kWindow, 2.0, 4.0, kFramesAfter, output.GetPath() });
+            detector.SetEnabled(true);
+
+            uint64_t events = 0;
+            for (uint64_t frame = 1; frame <= kSpikeFrame + kFramesAfter; ++frame)
+            {
+                {
+                    BROKKR_PROFILE_SCOPE("Hitch Test Frame");
+                }
+                Profiler::EndFrame();
+
+                events += frame == kSpikeFrame ? 500 : 10;
+                const double milliseconds = frame == kSpikeFrame ? 12.0 : 1.0 + 0.1 * static_cast<double>(frame % 3);
+                detector.EndFrame({ frame * 1'000'000, milliseconds, events, 0, 0 }, scheduler);
+            }
+
+            std::stringstream window;
+            detector.WriteWindow(window);
+            const std::string trace = window.str();
+            detector.SetEnabled(false);
+
+            return detector.GetHitchCount() == 1
+                && !detector.GetLastDumpPath().empty()
+                && trace.find("\"name\":\"Hitch\"") != std::string::npos
+                && trace.find("\"events\":500") != std::string::npos
+                && trace.find("\"name\":\"Hitch Test Frame\"") != std::string::npos
+                && !Profiler::IsContinuousRecording();
+        }
+
+        // A fast game doubling its frame time is not a hitch under the floor
+        static bool TestHitchMinimum()
+        {
+            if (Profiler::IsCapturing() || Profiler::IsContinuousRecording())
+            {
+                return true;
+            }
+
+            const ProfilerStateScope profilerState;
+            const ScopedTestFile output("HitchTest/");
+            FrameScheduler scheduler;
+            scheduler.Build();
+
+            HitchDetector detector;
+            detector.Configure({ 60, 2.0, 4.0, 5, output.GetPath() });
+            detector.SetEnabled(true);
+
+            for (uint64_t frame = 1; frame <= 100; ++frame)
+            {
+                detector.EndFrame({ frame * 1'000'000, frame % 10 == 0 ? 3.0 : 0.5, 0, 0, 0 }, scheduler);
+            }
+
+            detector.SetEnabled(false);
+            return detector.GetHitchCount() == 0;
+        }
+
+        // Every enabled detector keeps the Profiler recording, disabling one leaves the other's recording alone
+        static bool TestHitchDetectorsShareRecording()
+        {
+            if (Profiler::IsCapturing() || Profiler::IsContinuousRecording())
+            {
+                return true;
+            }
+
+            const ProfilerStateScope profilerState;
+            HitchDetector first;
+            HitchDetector second;
+            first.SetEnabled(true);
+            second.SetEnabled(true);
+            first.SetEnabled(true);
+
+            first.SetEnabled(false);
+            const bool isKeptBySecond = Profiler::IsContinuousRecording() && Profiler::IsRecording();
+
+            first.SetEnabled(false);
+            const bool isStillKept = Profiler::IsContinuousRecording();
+
+            second.SetEnabled(false);
+            return isKeptBySecond && isStillKept && !Profiler::IsContinuousRecording() && !Profiler::IsRecording();
+        }
+
+        // Nearest rank over 1..100, and the deltas of the running totals
+        static bool TestFrameStatistics()
+        {
+            FrameScheduler scheduler;
+            scheduler.Build();
+
+            FrameStatistics statistics;
+            statistics.Reserve(100);
+            for (uint64_t frame = 1; frame <= 100; ++frame)
+            {
+                statistics.AddFrame({ frame * 1'000'000, static_cast<double>(101 - frame), frame * 7, 0, 0 }, scheduler);
+            }
+
+            const FrameStatistics::Summary summary = statistics.GetFrameSummary();
+            std::stringstream json;
+            statistics.WriteJSON(json);
+
+            return summary.m_min == 1.0 && summary.m_p50 == 50.0 && summary.m_p95 == 95.0 && summary.m_p99 == 99.0
+                && summary.m_max == 100.0 && summary.m_mean == 50.5
+                && json.str().find("\"events\":{\"mean\":6.93") != std::string::npos;
+        }
+
+    public:
+
+        static void RegisterProfilerTests(UnitTestSystem* pTestSystem)
+        {
+            pTestSystem->AddTest("Profiler ChromeTrace", TestChromeTrace);
+            pTestSystem->AddTest("Profiler Binary", TestBinary);
+            pTestSystem->AddTest("Profiler EndedThreadsReleased", TestEndedThreadsReleased);
+            pTestSystem->AddTest("Profiler BenchmarkZoneOverhead", BenchmarkZoneOverhead);
+            pTestSystem->AddTest("Profiler HitchDetection", TestHitchDetection);
+            pTestSystem->AddTest("Profiler HitchMinimum", TestHitchMinimum);
+            pTestSystem->AddTest("Profiler HitchDetectorsShareRecording", TestHitchDetectorsShareRecording);
+            pTestSystem->AddTest("Profiler FrameStatistics", TestFrameStatistics);
+        }
+    };
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace Brokkr
+{
+    // A file or directory a test writes, removed when the test returns whichever way it leaves.
+    // Declare it before anything that opens the file so the file is closed first
+    class ScopedTestFile
+    {
+        std::string m_path;
+
+    public:
+        explicit ScopedTestFile(std::string path) : m_path(std::move(path)) {}
+        ScopedTestFile(const ScopedTestFile&) = delete;
+        ScopedTestFile& operator=(const ScopedTestFile&) = delete;
+
+        ~ScopedTestFile()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(m_path, error);
+        }
+
+        [[nodiscard]] const std::string& GetPath() const { return m_path; }
+    };
+}
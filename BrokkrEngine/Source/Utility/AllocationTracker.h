@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+/////////////////////////////////////////////////
+//          Allocation Tracker
+//
+// Counts every allocation that goes through the global operator new, so a frame's allocations can be told apart
+// from the ones before it. Only the running totals are kept, take the difference between two points.
+//
+//  Example Use:
+//
+//      const uint64_t before = AllocationTracker::GetAllocationCount();
+//      pSceneManager->ProcessStateChange();
+//      const uint64_t allocations = AllocationTracker::GetAllocationCount() - before;
+//
+// With BROKKR_TRACK_ALLOCATIONS on (debug and release builds by default, release is what benchmarks run) this file
+// replaces the global operator new and delete, every allocation then costs one relaxed atomic add. Off, as in dist
+// builds, the counts stay 0 and IsTracking() says so.
+/////////////////////////////////////////////////
+
+#ifndef BROKKR_TRACK_ALLOCATIONS
+#if defined(DEBUG) || defined(RELEASE)
+#define BROKKR_TRACK_ALLOCATIONS 1
+#else
+#define BROKKR_TRACK_ALLOCATIONS 0
+#endif
+#endif
+
+namespace Brokkr
+{
+    class AllocationTracker
+    {
+    public:
+        [[nodiscard]] static constexpr bool IsTracking() { return BROKKR_TRACK_ALLOCATIONS != 0; }
+
+        // Since the program started, from every thread
+        [[nodiscard]] static uint64_t GetAllocationCount();
+        [[nodiscard]] static uint64_t GetAllocatedBytes();
+    };
+}
@@ -0,0 +1,130 @@
+#include "BinaryStream.h"
+
+#include <fstream>
+
+void Brokkr::BinaryWriter::WriteBytes(const void* pData, size_t size)
+{
+    const auto pBytes = static_cast<const uint8_t*>(pData);
+    m_buffer.insert(m_buffer.end(), pBytes, pBytes + size);
+}
+
+void Brokkr::BinaryWriter::WriteString(const std::string& str)
+{
+    Write(static_cast<uint32_t>(str.size()));
+    WriteBytes(str.data(), str.size());
+}
+
+size_t Brokkr::BinaryWriter::BeginBlock()
+{
+    const size_t mark = m_buffer.size();
+    Write(static_cast<uint32_t>(0)); // patched in EndBlock
+    return mark;
+}
+
+void Brokkr::BinaryWriter::EndBlock(size_t mark)
+{
+    const auto blockSize = static_cast<uint32_t>(m_buffer.size() - mark - sizeof(uint32_t));
+    std::memcpy(m_buffer.data() + mark, &blockSize, sizeof(uint32_t));
+}
+
+void Brokkr::BinaryWriter::FlushIfFull()
+{
+    if (m_pSink && m_buffer.size() >= m_flushThreshold)
+    {
+        Flush();
+    }
+}
+
+bool Brokkr::BinaryWriter::Flush()
+{
+    if (!m_pSink)
+    {
+        return false;
+    }
+
+    m_pSink->write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+
+    if (!m_pSink->good())
+    {
+        m_failed = true;
+    }
+
+    return !m_failed;
+}
+
+bool Brokkr::BinaryWriter::SaveToFile(const char* filePath)
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    return file.good();
+}
+
+bool Brokkr::BinaryReader::LoadFromFile(const char* filePath)
+{
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        m_failed = true;
+        return false;
+    }
+
+    const std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    m_buffer.resize(static_cast<size_t>(size));
+    m_offset = 0;
+
+    if (!file.read(reinterpret_cast<char*>(m_buffer.data()), size))
+    {
+        m_failed = true;
+        return false;
+    }
+
+    m_failed = false;
+    return true;
+}
+
+bool Brokkr::BinaryReader::ReadBytes(void* pData, size_t size)
+{
+    if (m_failed || size > GetRemaining())
+    {
+        m_failed = true;
+        return false;
+    }
+
+    std::memcpy(pData, m_buffer.data() + m_offset, size);
+    m_offset += size;
+    return true;
+}
+
+bool Brokkr::BinaryReader::ReadString(std::string& str)
+{
+    uint32_t size = 0;
+    if (!Read(size) || size > GetRemaining())
+    {
+        m_failed = true;
+        return false;
+    }
+
+    str.assign(reinterpret_cast<const char*>(m_buffer.data() + m_offset), size);
+    m_offset += size;
+    return true;
+}
+
+bool Brokkr::BinaryReader::Skip(size_t size)
+{
+    if (m_failed || size > GetRemaining())
+    {
+        m_failed = true;
+        return false;
+    }
+
+    m_offset += size;
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////
+//          Binary Stream
+//
+//  Little helpers for the binary snapshot format. Everything that goes through
+//  Write / Read has to be trivially copyable so it can be moved as raw bytes,
+//  components pack their data into a POD struct and write it in one go.
+//
+//  Example Use:
+//
+//    BinaryWriter writer;
+//    writer.Write(mySnapshotStruct);
+//    writer.WriteString(m_textureName);
+//    writer.SaveToFile("Save.bin");
+//
+//    BinaryReader reader;
+//    reader.LoadFromFile("Save.bin");
+//    reader.Read(mySnapshotStruct);
+//    reader.ReadString(m_textureName);
+//
+//  Blocks are size prefixed so a reader can skip data it does not understand.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class BinaryWriter
+    {
+        std::vector<uint8_t> m_buffer;
+        std::ostream* m_pSink = nullptr;
+        size_t m_flushThreshold = 0;
+        bool m_failed = false;
+
+    public:
+        BinaryWriter() = default;
+
+        // Streams to pSink once the buffer grows past flushThreshold (see FlushIfFull)
+        BinaryWriter(std::ostream* pSink, size_t flushThreshold)
+            : m_pSink(pSink)
+            , m_flushThreshold(flushThreshold)
+        {
+            m_buffer.reserve(flushThreshold);
+        }
+
+        template<typename PodType>
+        void Write(const PodType& value)
+        {
+            static_assert(std::is_trivially_copyable_v<PodType>, "BinaryWriter only writes trivially copyable types");
+            WriteBytes(&value, sizeof(PodType));
+        }
+
+        void WriteBytes(const void* pData, size_t size);
+        void WriteString(const std::string& str);
+
+        // Reserve room for a block size, returns the mark EndBlock needs
+        [[nodiscard]] size_t BeginBlock();
+        void EndBlock(size_t mark);
+
+        // Only flushes between blocks, anything still open stays in memory to be patched
+        void FlushIfFull();
+        bool Flush();
+
+        bool SaveToFile(const char* filePath);
+
+        [[nodiscard]] const std::vector<uint8_t>& GetBuffer() const { return m_buffer; }
+        [[nodiscard]] bool HasFailed() const { return m_failed; }
+    };
+
+    class BinaryReader
+    {
+        std::vector<uint8_t> m_buffer;
+        size_t m_offset = 0;
+        bool m_failed = false;
+
+    public:
+        BinaryReader() = default;
+        explicit BinaryReader(std::vector<uint8_t> buffer) : m_buffer(std::move(buffer)) {}
+
+        bool LoadFromFile(const char* filePath);
+
+        template<typename PodType>
+        bool Read(PodType& value)
+        {
+            static_assert(std::is_trivially_copyable_v<PodType>, "BinaryReader only reads trivially copyable types");
+            return ReadBytes(&value, sizeof(PodType));
+        }
+
+        bool ReadBytes(void* pData, size_t size);
+        bool ReadString(std::string& str);
+        bool Skip(size_t size);
+
+        [[nodiscard]] size_t GetOffset() const { return m_offset; }
+        [[nodiscard]] size_t GetRemaining() const { return m_buffer.size() - m_offset; }
+
+        // Any read past the end marks the reader failed, further reads do nothing
+        [[nodiscard]] bool HasFailed() const { return m_failed; }
+    };
+}
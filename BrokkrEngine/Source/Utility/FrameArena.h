@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////
+//          Frame Arena
+//
+// Bump allocator for data that only lives until the end of the frame (large event payloads, hit lists).
+// Allocation is a pointer bump, nothing is freed on its own, Reset hands everything back at once.
+// Blocks are kept between frames so a warmed up arena never touches the heap.
+//
+//  Example Use:
+//
+//      const int* pIds = arena.Copy(hitIds.data(), hitIds.size());
+//      ...
+//      arena.Reset(); // once nothing can point into it anymore
+//
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    class FrameArena
+    {
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> m_pMemory;
+            size_t m_size = 0;
+        };
+
+        std::vector<Block> m_blocks;
+        size_t m_blockIndex = 0;
+        size_t m_offset = 0;
+        size_t m_blockSize;
+        size_t m_bytesUsed = 0;
+
+    public:
+        explicit FrameArena(size_t blockSize = 16 * 1024) : m_blockSize(blockSize) {}
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // Only for types that need no destructor, the arena never runs one
+        template <typename Type, typename ... Args>
+        Type* Create(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<Type>, "FrameArena never runs destructors");
+            return new (Allocate(sizeof(Type), alignof(Type))) Type(std::forward<Args>(args)...);
+        }
+
+        template <typename Type>
+        Type* Copy(const Type* pSource, size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<Type>, "FrameArena only copies trivially copyable types");
+            if (count == 0)
+            {
+                return nullptr;
+            }
+
+            auto* pDest = static_cast<Type*>(Allocate(sizeof(Type) * count, alignof(Type)));
+            std::memcpy(pDest, pSource, sizeof(Type) * count);
+            return pDest;
+        }
+
+        // Everything allocated so far becomes invalid
+        void Reset();
+
+        [[nodiscard]] size_t GetBytesUsed() const { return m_bytesUsed; }
+        [[nodiscard]] size_t GetCapacity() const;
+    };
+
+    inline void* FrameArena::Allocate(size_t size, size_t alignment)
+    {
+        while (true)
+        {
+            if (m_blockIndex < m_blocks.size())
+            {
+                Block& block = m_blocks[m_blockIndex];
+                const auto base = reinterpret_cast<uintptr_t>(block.m_pMemory.get());
+                const uintptr_t aligned = (base + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+                const size_t newOffset = static_cast<size_t>(aligned - base) + size;
+
+                if (newOffset <= block.m_size)
+                {
+                    m_bytesUsed += newOffset - m_offset;
+                    m_offset = newOffset;
+                    return reinterpret_cast<void*>(aligned);
+                }
+
+                // Move on to the next block, this one is full
+                ++m_blockIndex;
+                m_offset = 0;
+                continue;
+            }
+
+            // Out of blocks, oversized requests get a block of their own size
+            const size_t blockSize = size + alignment > m_blockSize ? size + alignment : m_blockSize;
+            m_blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+        }
+    }
+
+    inline void FrameArena::Reset()
+    {
+        m_blockIndex = 0;
+        m_offset = 0;
+        m_bytesUsed = 0;
+    }
+
+    inline size_t FrameArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const auto& block : m_blocks)
+        {
+            capacity += block.m_size;
+        }
+        return capacity;
+    }
+}
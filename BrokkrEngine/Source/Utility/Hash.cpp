@@ -1,5 +1,7 @@
 #include "Hash.h"
 
+#include <cstring>
+
 // Source: https://stackoverflow.com/questions/1057036/please-explain-murmur-hash <- best source explanation i found
 // https://en.wikipedia.org/wiki/MurmurHash#Algorithm <- good info
 // https://github.com/veegee/mmh3 MurmurHash3: a Python library for MurmurHash (MurmurHash3)
@@ -66,12 +68,7 @@ uint32_t Brokkr::Hash::Murmur3Hash(const void* key, const size_t len, const uint
     return hash;
 }
 
-uint32_t Brokkr::Hash::Murmur3HashFinalizer(uint32_t hash)
+uint32_t Brokkr::Hash::HashString(const char* str)
 {
-    hash ^= hash >> 16;
-    hash *= 0x85ebca6b;
-    hash ^= hash >> 13;
-    hash *= 0xc2b2ae35;
-    hash ^= hash >> 16;
-    return hash;
+    return Murmur3Hash(str, std::strlen(str), kDefaultSeed);
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 #define CIRCULAR_SHIFT_LEFT_32_BITS(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
@@ -9,8 +10,88 @@ namespace Brokkr
     {
     public:
         static uint32_t Murmur3Hash(const void* key, const size_t len, const uint32_t seed);
+
+        // Murmur3 of a null terminated string with the engine wide seed
+        static uint32_t HashString(const char* str);
+
+        // Same result as Murmur3Hash, written so it can run at compile time (see StringID.h)
+        static constexpr uint32_t Murmur3HashConstexpr(const char* str, size_t len, uint32_t seed);
+        static constexpr size_t StringLength(const char* str);
+
+        inline static constexpr uint32_t kDefaultSeed = 1;
     private:
-        static uint32_t Murmur3HashFinalizer(uint32_t hash);
+        static constexpr uint32_t Murmur3HashFinalizer(uint32_t hash);
     };
+
+    constexpr uint32_t Hash::Murmur3HashConstexpr(const char* str, size_t len, uint32_t seed)
+    {
+        constexpr uint32_t kC1 = 0xcc9e2d51;
+        constexpr uint32_t kC2 = 0x1b873593;
+
+        uint32_t hash = seed;
+        const size_t nblocks = len / 4;
+
+        // Blocks are read byte by byte in little endian order, which is what the runtime version's uint32 loads see
+        for (size_t i = 0; i < nblocks; ++i)
+        {
+            const size_t offset = i * 4;
+            uint32_t k = static_cast<uint32_t>(static_cast<uint8_t>(str[offset]))
+                | static_cast<uint32_t>(static_cast<uint8_t>(str[offset + 1])) << 8
+                | static_cast<uint32_t>(static_cast<uint8_t>(str[offset + 2])) << 16
+                | static_cast<uint32_t>(static_cast<uint8_t>(str[offset + 3])) << 24;
+
+            k *= kC1;
+            k = CIRCULAR_SHIFT_LEFT_32_BITS(k, 15);
+            k *= kC2;
+
+            hash ^= k;
+            hash = CIRCULAR_SHIFT_LEFT_32_BITS(hash, 13);
+            hash = hash * 5 + 0xe6546b64;
+        }
+
+        const size_t tail = nblocks * 4;
+        const size_t remaining = len & 3;
+        if (remaining > 0)
+        {
+            uint32_t k = 0;
+            if (remaining == 3)
+            {
+                k ^= static_cast<uint32_t>(static_cast<uint8_t>(str[tail + 2])) << 16;
+            }
+            if (remaining >= 2)
+            {
+                k ^= static_cast<uint32_t>(static_cast<uint8_t>(str[tail + 1])) << 8;
+            }
+            k ^= static_cast<uint32_t>(static_cast<uint8_t>(str[tail]));
+
+            k *= kC1;
+            k = CIRCULAR_SHIFT_LEFT_32_BITS(k, 15);
+            k *= kC2;
+            hash ^= k;
+        }
+
+        hash ^= static_cast<uint32_t>(len);
+        return Murmur3HashFinalizer(hash);
+    }
+
+    constexpr size_t Hash::StringLength(const char* str)
+    {
+        size_t length = 0;
+        while (str[length] != '\0')
+        {
+            ++length;
+        }
+        return length;
+    }
+
+    constexpr uint32_t Hash::Murmur3HashFinalizer(uint32_t hash)
+    {
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6b;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35;
+        hash ^= hash >> 16;
+        return hash;
+    }
 }
 
@@ -1,10 +1,22 @@
 #include "IDGenerator.h"
 #include <chrono>
 
+namespace
+{
+    int s_counter = 0;
+}
+
 int Brokkr::IDGenerator::GenerateUniqueID()
 {
-    static int counter = 0;
-    return ++counter;
+    return ++s_counter;
+}
+
+void Brokkr::IDGenerator::ReserveID(int id)
+{
+    if (id > s_counter)
+    {
+        s_counter = id;
+    }
 }
 
 std::string Brokkr::IDGenerator::GenerateID(const std::string& name)
@@ -29,6 +29,9 @@ namespace Brokkr
     {
     public:
         static int GenerateUniqueID();
+
+        // Makes sure GenerateUniqueID never hands out id again, used when restoring saved ids
+        static void ReserveID(int id);
         static std::string GenerateID(const std::string& name);
     };
 }
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/////////////////////////////////////////////////
+//          Pool Allocator
+//
+//  Fixed size slab allocator for one type. Memory is grabbed in chunks of
+//  kSlotsPerChunk slots and handed out from a free list, so objects of the
+//  same type sit next to each other and freeing is just a push on the list.
+//
+//  Example Use:
+//
+//    PoolAllocator<Foo> pool;
+//    Foo* pFoo = new (pool.Allocate()) Foo();
+//
+//    pFoo->~Foo();
+//    pool.Deallocate(pFoo);
+//
+//  Only hands out raw memory, constructing and destroying is up to the caller.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    struct PoolStats
+    {
+        size_t m_liveCount = 0;         // slots currently handed out
+        size_t m_peakCount = 0;         // most slots handed out at once
+        size_t m_capacity = 0;          // slots owned across all chunks
+        size_t m_chunkAllocations = 0;  // times the pool had to go to the heap
+        size_t m_allocations = 0;       // total Allocate calls
+    };
+
+    template<typename Type, size_t kSlotsPerChunk = 64>
+    class PoolAllocator
+    {
+        static_assert(kSlotsPerChunk > 0, "Pool chunks need at least one slot");
+
+        union Slot
+        {
+            Slot* m_pNext;
+            alignas(Type) unsigned char m_storage[sizeof(Type)];
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> m_chunks;
+        Slot* m_pFreeList = nullptr;
+        PoolStats m_stats;
+
+    public:
+        PoolAllocator() = default;
+
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        [[nodiscard]] void* Allocate()
+        {
+            if (m_pFreeList == nullptr)
+            {
+                AddChunk();
+            }
+
+            Slot* pSlot = m_pFreeList;
+            m_pFreeList = pSlot->m_pNext;
+
+            ++m_stats.m_allocations;
+            ++m_stats.m_liveCount;
+            if (m_stats.m_liveCount > m_stats.m_peakCount)
+            {
+                m_stats.m_peakCount = m_stats.m_liveCount;
+            }
+
+            return pSlot->m_storage;
+        }
+
+        void Deallocate(void* pMemory)
+        {
+            if (pMemory == nullptr)
+            {
+                return;
+            }
+
+            auto* pSlot = reinterpret_cast<Slot*>(pMemory);
+            pSlot->m_pNext = m_pFreeList;
+            m_pFreeList = pSlot;
+
+            --m_stats.m_liveCount;
+        }
+
+        // Puts every slot back on the free list in address order so the next batch of
+        // allocations comes out contiguous. Only valid once nothing is alive.
+        bool Reset()
+        {
+            if (m_stats.m_liveCount != 0)
+            {
+                return false;
+            }
+
+            m_pFreeList = nullptr;
+
+            // Walk backwards so the list starts at the first slot of the first chunk
+            for (auto chunk = m_chunks.rbegin(); chunk != m_chunks.rend(); ++chunk)
+            {
+                for (size_t i = kSlotsPerChunk; i-- > 0;)
+                {
+                    (*chunk)[i].m_pNext = m_pFreeList;
+                    m_pFreeList = &(*chunk)[i];
+                }
+            }
+
+            return true;
+        }
+
+        // Hands the chunks back to the heap. Only valid once nothing is alive.
+        bool Release()
+        {
+            if (m_stats.m_liveCount != 0)
+            {
+                return false;
+            }
+
+            m_chunks.clear();
+            m_pFreeList = nullptr;
+            m_stats.m_capacity = 0;
+            return true;
+        }
+
+        [[nodiscard]] const PoolStats& GetStats() const { return m_stats; }
+
+    private:
+        void AddChunk()
+        {
+            m_chunks.emplace_back(std::make_unique<Slot[]>(kSlotsPerChunk));
+            Slot* pChunk = m_chunks.back().get();
+
+            for (size_t i = kSlotsPerChunk; i-- > 0;)
+            {
+                pChunk[i].m_pNext = m_pFreeList;
+                m_pFreeList = &pChunk[i];
+            }
+
+            m_stats.m_capacity += kSlotsPerChunk;
+            ++m_stats.m_chunkAllocations;
+        }
+    };
+}
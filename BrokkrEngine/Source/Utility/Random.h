@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <limits>
 #include <random>
 
@@ -19,6 +20,13 @@ public:
         s_RandomEngine.seed(std::random_device()());
     }
 
+    // Same seed, same numbers: headless benchmarks and replays
+    static void Init(uint32_t seed)
+    {
+        s_RandomEngine.seed(seed);
+        s_Distribution.reset();
+    }
+
     static float Float()
     {
         return static_cast<float>(s_Distribution(s_RandomEngine)) / static_cast<float>(std::numeric_limits<uint32_t>::infinity());
@@ -0,0 +1,55 @@
+#include "StringID.h"
+
+#if BROKKR_STRING_ID_NAMES
+#include <cassert>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    // Copies of the names, callers may hand in strings that do not live forever
+    std::unordered_map<uint32_t, std::string>& GetNameTable()
+    {
+        static std::unordered_map<uint32_t, std::string> s_names;
+        return s_names;
+    }
+
+    std::mutex& GetNameTableLock()
+    {
+        static std::mutex s_lock;
+        return s_lock;
+    }
+}
+#endif
+
+Brokkr::StringID Brokkr::StringID::FromString(const char* str)
+{
+    const StringID id(str, Hash::StringLength(str));
+    Register(id.m_hash, str);
+    return id;
+}
+
+void Brokkr::StringID::Register([[maybe_unused]] uint32_t hash, [[maybe_unused]] const char* pName)
+{
+#if BROKKR_STRING_ID_NAMES
+    std::lock_guard lock(GetNameTableLock());
+
+    const auto [it, isNew] = GetNameTable().try_emplace(hash, pName);
+    assert((isNew || it->second == pName) && "StringID hash collision, rename one of the two");
+#endif
+}
+
+const char* Brokkr::StringID::Resolve([[maybe_unused]] uint32_t hash)
+{
+#if BROKKR_STRING_ID_NAMES
+    std::lock_guard lock(GetNameTableLock());
+
+    const auto it = GetNameTable().find(hash);
+    if (it != GetNameTable().end())
+    {
+        return it->second.c_str();
+    }
+#endif
+    return "";
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "Hash.h"
+
+/////////////////////////////////////////////////
+//          String ID
+//
+// A name reduced to its 32 bit Murmur3 hash. Built from a literal the hash is worked out by the compiler, so
+// static event, component and asset names cost nothing at runtime. Same hash as Hash::HashString and
+// Event::EventType::HashEventString, ids made either way compare equal.
+//
+//  Example Use:
+//
+//      inline static constexpr StringID kMoved = "PlayerMoved"_sid;
+//      inline static constexpr uint32_t kSnapshotID = "TransformComponent"_sid;
+//
+//      StringID id = StringID::FromString(pNameFromXml);   // runtime strings, registered for Resolve
+//
+// With BROKKR_STRING_ID_NAMES on (debug builds by default) the ids made at runtime, and the compile time event
+// types their owners register (Event::EventType::RegisterName), are kept in a reverse table so a hash seen in a
+// debugger or a log can be turned back into its name.
+/////////////////////////////////////////////////
+
+#ifndef BROKKR_STRING_ID_NAMES
+#if defined(DEBUG)
+#define BROKKR_STRING_ID_NAMES 1
+#else
+#define BROKKR_STRING_ID_NAMES 0
+#endif
+#endif
+
+namespace Brokkr
+{
+    class StringID
+    {
+        uint32_t m_hash = 0;
+
+    public:
+        constexpr StringID() = default;
+        constexpr StringID(const char* str, size_t length) : m_hash(Hash::Murmur3HashConstexpr(str, length, Hash::kDefaultSeed)) {}
+
+        // Stops at the first '\0', so a char buffer hashes its text and not whatever is left in it
+        template <size_t Size>
+        explicit constexpr StringID(const char(&str)[Size]) : StringID(str, TextLength(str, Size)) {}
+
+        [[nodiscard]] static constexpr StringID FromHash(uint32_t hash) { StringID id; id.m_hash = hash; return id; }
+
+        // Runtime strings, hashed and added to the reverse table
+        [[nodiscard]] static StringID FromString(const char* str);
+
+        [[nodiscard]] constexpr uint32_t GetHash() const { return m_hash; }
+        constexpr operator uint32_t() const { return m_hash; }
+
+        constexpr bool operator==(const StringID& other) const { return m_hash == other.m_hash; }
+        constexpr bool operator!=(const StringID& other) const { return m_hash != other.m_hash; }
+
+        // Reverse table, both are no-ops without BROKKR_STRING_ID_NAMES.
+        // Register asserts if two different names end up with the same hash.
+        static void Register(uint32_t hash, const char* pName);
+
+        // The registered name, or "" if there is none
+        [[nodiscard]] static const char* Resolve(uint32_t hash);
+
+    private:
+        [[nodiscard]] static constexpr size_t TextLength(const char* str, size_t size)
+        {
+            size_t length = 0;
+            while (length < size && str[length] != '\0')
+            {
+                ++length;
+            }
+            return length;
+        }
+    };
+
+    inline namespace StringIDLiterals
+    {
+        constexpr StringID operator""_sid(const char* str, size_t length)
+        {
+            return StringID(str, length);
+        }
+    }
+}
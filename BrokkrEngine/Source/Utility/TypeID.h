@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/////////////////////////////////////////////////
+//          Type ID
+//
+// Small dense index per C++ type, handed out the first time a type asks for it.
+// Cheaper than typeid / dynamic_cast and usable as an array index.
+//
+//  Example Use:
+//
+//      if (m_payloadType == TypeID::Get<CollisionPayload>())
+//
+// Indices are only stable for one run of the program, never save them.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    using TypeIndex = uint32_t;
+
+    class TypeID
+    {
+        inline static std::atomic<TypeIndex> s_nextIndex{ 0 };
+
+    public:
+        inline static constexpr TypeIndex kInvalid = UINT32_MAX;
+
+        template <typename Type>
+        static TypeIndex Get()
+        {
+            static const TypeIndex s_index = s_nextIndex.fetch_add(1, std::memory_order_relaxed);
+            return s_index;
+        }
+
+        // How many types have been handed an index so far
+        [[nodiscard]] static TypeIndex GetCount() { return s_nextIndex.load(std::memory_order_relaxed); }
+    };
+}
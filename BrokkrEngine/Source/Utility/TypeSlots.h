@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+
+#include "TypeID.h"
+
+/////////////////////////////////////////////////
+//          Type Slots
+//
+// Pointer per C++ type, stored at the type's TypeID index so a lookup is one bounds check and one load.
+// Used by the system containers (CoreSystems, AssetManager, XMLManager) in place of a dynamic_cast scan,
+// they keep owning the objects, this only points at them.
+//
+//  Example Use:
+//
+//      TypeSlots<System> m_slots;
+//      m_slots.Set<EventManager>(pEventManager);
+//      EventManager* pEvents = m_slots.Get<EventManager>();
+//
+// Types are found by the exact type they were set as, asking for a base class finds nothing.
+/////////////////////////////////////////////////
+
+namespace Brokkr
+{
+    template <typename Base>
+    class TypeSlots
+    {
+        std::vector<Base*> m_slots;
+
+    public:
+        template <typename Type>
+        void Set(Type* pObject)
+        {
+            const TypeIndex index = TypeID::Get<Type>();
+            if (index >= m_slots.size())
+            {
+                m_slots.resize(static_cast<size_t>(index) + 1, nullptr);
+            }
+            m_slots[index] = pObject;
+        }
+
+        template <typename Type>
+        [[nodiscard]] Type* Get() const
+        {
+            const TypeIndex index = TypeID::Get<Type>();
+            if (index >= m_slots.size())
+            {
+                return nullptr;
+            }
+
+            // The slot was filled through Set<Type>, so it holds a Type
+            return static_cast<Type*>(m_slots[index]);
+        }
+
+        template <typename Type>
+        void Remove()
+        {
+            const TypeIndex index = TypeID::Get<Type>();
+            if (index < m_slots.size())
+            {
+                m_slots[index] = nullptr;
+            }
+        }
+
+        void Clear() { m_slots.clear(); }
+    };
+}
@@ -1,5 +1,7 @@
 #include "EntityXMLParser.h"
 
+#include <sstream>
+
 #include "ColliderComponent.h"
 #include "tinyxml2.h"
 #include "TransformComponent.h"
@@ -58,7 +60,22 @@ Brokkr::GameEntity* Brokkr::EntityXMLParser::BuildEntity(const std::string& enti
         if (std::string(nameAttr) == entityName)
         {
             // Create a new entity
-            GameEntity* pEntity = m_pCoreSystems->GetCoreSystem<GameEntityManager>()->GetNextEntityAvailable();
+            const auto pEntityManager = m_pCoreSystems->GetCoreSystem<GameEntityManager>();
+            GameEntity* pEntity = pEntityManager->GetNextEntityAvailable();
+
+            // Optional comma separated tags i.e. tags="Solid,Wall"
+            if (const char* tagsAttr = entityElement->Attribute("tags"))
+            {
+                std::stringstream tags(tagsAttr);
+                std::string tag;
+                while (std::getline(tags, tag, ','))
+                {
+                    if (!tag.empty())
+                    {
+                        pEntityManager->AddEntityTag(pEntity, tag);
+                    }
+                }
+            }
 
             // Loop through the components of the element
             for (tinyxml2::XMLElement* pComponentElement = entityElement->FirstChildElement();
@@ -66,6 +66,7 @@ bool Brokkr::XMLManager::Parse(const char* fileName) const
 
 void Brokkr::XMLManager::Destroy()
 {
+    m_parserSlots.Clear();
     m_parsers.clear();
 }
 
@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <vector>
 #include <Core/Core.h>
+#include "Utility/TypeSlots.h"
 
 
 namespace tinyxml2
@@ -31,6 +32,7 @@ namespace Brokkr
     class XMLManager final : public System
     {
         std::vector<std::unique_ptr<XMLParser>> m_parsers;
+        TypeSlots<XMLParser> m_parserSlots;
         std::unordered_map<std::string, std::string> m_xmlPaths;
 
     public:
@@ -59,26 +61,17 @@ namespace Brokkr
 
             // Add the parser to the vector
             m_parsers.emplace_back(std::move(newParserType));
+            m_parserSlots.Set<ParserType>(result);
 
             // Return a pointer
             return result;
         }
 
+        // Found by the exact type it was added as, nullptr if there is none
         template <typename ParserType>
         ParserType* GetParser()
         {
-            // Iterate through all components in the vector
-            for (auto& parser : m_parsers)
-            {
-                // If the cast is successful
-                if (ParserType* target = dynamic_cast<ParserType*>(parser.get()))
-                {
-                    return target;
-                }
-            }
-
-            // If no type is found
-            return nullptr;
+            return m_parserSlots.Get<ParserType>();
         }
     };
 }
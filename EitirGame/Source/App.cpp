@@ -8,8 +8,18 @@
 #include "2DRendering/SDLWindowSystem.h"
 #include "AssetManager/AssetManager.h"
 #include "Entity/GameEntityManager/GameEntityManager.h"
+#include "Input/InputSystem.h"
+#include "JobSystem/JobSystem.h"
+#include "Profiler/Profiler.h"
 #include "GameComponents/GameComponentReg.h"
 #include "Scenes/GameScene.h"
+#include "UnitTests/ComponentPoolTest.h"
+#include "UnitTests/EntityManagerTest.h"
+#include "UnitTests/EventManagerTest.h"
+#include "UnitTests/FrameSchedulerTest.h"
+#include "UnitTests/InputSystemTest.h"
+#include "UnitTests/JobSystemTest.h"
+#include "UnitTests/ProfilerTest.h"
 #include "UnitTests/UnitTest.h"
 #include "XMLManager/XMLManager.h"
 
@@ -23,12 +33,16 @@ class GameCoreSystem final : public Brokkr::CoreSystems
 	Brokkr::PhysicsManager* m_pPhysicsManager2D = nullptr;
 	Brokkr::XMLManager* m_pXmlManager = nullptr;
 	Brokkr::EventManager* m_pEventManager = nullptr;
+	Brokkr::JobSystem* m_pJobSystem = nullptr;
+	Brokkr::InputSystem* m_pInputSystem = nullptr;
 
 public:
 
 	void Build()
 	{
+		m_pJobSystem = AddCoreSystem<Brokkr::JobSystem>();
 		m_pEventManager = AddCoreSystem<Brokkr::EventManager>();
+		m_pInputSystem = AddCoreSystem<Brokkr::InputSystem>();
 
 		m_pXmlManager = AddCoreSystem<Brokkr::XMLManager>();
 		m_pSceneManager = AddCoreSystem<Brokkr::SceneManager>();
@@ -39,7 +53,10 @@ public:
 		//auto pMainWindow = m_pSdlWindowManager->AddWindow<Brokkr::SDLWindow>(Brokkr::EngineDefinitions::GAME_WINDOW_NAME, 1024, 768);
 		//auto pMainRenderer = m_pSdlWindowManager->GetRendererForWindow(pMainWindow);
 
-	    auto pMainWindow = m_pSdlWindowManager->AddVulkanRenderedWindow<Brokkr::SDLWindow>(Brokkr::EngineDefinitions::GAME_WINDOW_NAME, 1024, 768);
+		// Headless draws nothing, the window only exists for what expects one (SDL events, asset loading)
+	    auto pMainWindow = IsHeadless()
+			? m_pSdlWindowManager->AddHeadlessWindow<Brokkr::SDLWindow>(Brokkr::EngineDefinitions::GAME_WINDOW_NAME, 1024, 768)
+			: m_pSdlWindowManager->AddVulkanRenderedWindow<Brokkr::SDLWindow>(Brokkr::EngineDefinitions::GAME_WINDOW_NAME, 1024, 768);
 		auto pMainRenderer = m_pSdlWindowManager->GetRendererForWindow(pMainWindow);
 
 		m_pAssetManager = AddCoreSystem<Brokkr::AssetManager>(pMainRenderer, pMainWindow, Brokkr::EngineDefinitions::ASSETS_PATH);
@@ -55,20 +72,35 @@ public:
 		m_pXmlManager->Init();
 		m_pAssetManager->Init();
 		m_pSceneManager->Init();
+		m_pEntityManager->Init();
 
 		CoreSystems* thisCoreEngine = static_cast<CoreSystems*>(this);
 		m_pSceneManager->AddState("GameState", std::make_unique<GameScene>(thisCoreEngine));
 
+		m_pEventManager->SetJobSystem(m_pJobSystem);
 		m_pPhysicsManager2D->Init();
 		GameComponentsReg::ComponentReg(m_pXmlManager->GetParser<Brokkr::EntityXMLParser>());
+		GameComponentsReg::SnapshotReg(m_pEntityManager);
 		Brokkr::UnitTest::RegisterEngineVector2Tests(m_pUnitTestSystem);
+		Brokkr::EventManagerTest::RegisterEventManagerTests(m_pUnitTestSystem);
+		Brokkr::JobSystemTest::RegisterJobSystemTests(m_pUnitTestSystem);
+		Brokkr::FrameSchedulerTest::RegisterFrameSchedulerTests(m_pUnitTestSystem);
+		Brokkr::ProfilerTest::RegisterProfilerTests(m_pUnitTestSystem);
+		Brokkr::InputSystemTest::RegisterInputSystemTests(m_pUnitTestSystem);
+		Brokkr::ComponentPoolTest::RegisterComponentPoolTests(m_pUnitTestSystem);
+		Brokkr::EntityManagerTest::RegisterEntityManagerTests(m_pUnitTestSystem, thisCoreEngine);
+
+		BuildFrameSchedule();
 
 	}
 
 	void RunTests()
 	{
-
-		m_pUnitTestSystem->RunTests();
+		// Not ahead of benchmarks, recordings and replays unless --tests asks for them
+		if (GetRunOptions().IsRunningTests())
+		{
+			m_pUnitTestSystem->RunTests();
+		}
 	}
 
 	void Run()
@@ -76,20 +108,10 @@ public:
 		m_pEventManager->ProcessEvents();
 		m_pSceneManager->SetActiveState("GameState");
 
+		// Stage order comes from the systems themselves, see FrameScheduler
 		while (isRunning)
 		{
-			m_pSdlWindowManager->ClearRenders();
-
-			Update(); // Engine Update logic
-			// m_pInputManager->Update(&windowEvent); // update input system
-
-			m_pSceneManager->UpdateActiveState();
-			m_pEntityManager->UpdateEntities();
-			m_pPhysicsManager2D->ProcessUpdate();
-			m_pEntityManager->LateUpdateEntities();
-			m_pEntityManager->RenderEntities();
-			m_pEventManager->ProcessEvents();
-			m_pSdlWindowManager->Render();
+			RunFrame();
 		}
 
 	}
@@ -104,13 +126,19 @@ void GameCoreSystem::Destroy()
 	m_pSdlWindowManager = nullptr;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+	// --profile[=frames] records the first frames, F11 in game does the same at any time
+	Brokkr::Profiler::ConfigureFromCommandLine(argc, argv);
 
 	std::cout << "Welcome to Val Game!\n";
 	auto game = GameCoreSystem();
 	auto gameComponents = GameComponentsReg();
 
+	// --headless [--frames=N] [--seed=N] runs a fixed benchmark and prints frame time percentiles,
+	// --record=path / --replay=path capture a session and play it back, --tests runs the unit tests for those too,
+	// see RunOptions
+	game.SetRunOptions(Brokkr::RunOptions::FromCommandLine(argc, argv));
 
 	game.Build();
 	game.Initialize();
@@ -4,6 +4,7 @@
 #include "Tinyxml2.h"
 #include "../KinematicComponent.h"
 #include "Entity/GameEntityManager/GameEntityManager.h"
+#include "Utility/BinaryStream.h"
 #include "XMLManager/Parsers/EntityXMLParser/EntityXMLParser.h"
 
 void AgentController::ApplyForce(Brokkr::Vector2<float> steeringForce)
@@ -87,3 +88,39 @@ void AgentController::CreateComponent(Brokkr::GameEntity* entity, tinyxml2::XMLE
     // create SpriteComponent using texture name
     entity->AddComponent<AgentController>(coreSystems, targetOne,  mSpeed * 100.0f, mAcceleration * 100.0f, mAngVel * 100.0f, mAndAcceleration * 100.0f);
 }
+
+namespace
+{
+    struct AgentSnapshot
+    {
+        float m_maxSpeed;
+        float m_maxAcceleration;
+        float m_maxAngVel;
+        float m_maxAngAcceleration;
+    };
+}
+
+void AgentController::Serialize(Brokkr::BinaryWriter& writer) const
+{
+    writer.WriteString(m_targetName);
+    writer.Write(AgentSnapshot{ maxSpeed, maxAcceleration, maxAngVel, maxAngAcceleration });
+}
+
+void AgentController::RegisterSnapshotFunction(Brokkr::GameEntityManager* pEntityManager)
+{
+    pEntityManager->RegisterSnapshotCreationFunction(kSnapshotID, RestoreComponent);
+}
+
+void AgentController::RestoreComponent(Brokkr::GameEntity* entity, Brokkr::BinaryReader& reader, Brokkr::CoreSystems* coreSystems)
+{
+    std::string targetName;
+    AgentSnapshot snapshot{};
+
+    if (!reader.ReadString(targetName) || !reader.Read(snapshot))
+    {
+        return;
+    }
+
+    // Values were saved already scaled so they go straight back in
+    entity->AddComponent<AgentController>(coreSystems, targetName, snapshot.m_maxSpeed, snapshot.m_maxAcceleration, snapshot.m_maxAngVel, snapshot.m_maxAngAcceleration);
+}
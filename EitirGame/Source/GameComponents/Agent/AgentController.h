@@ -5,9 +5,16 @@
 #include "Entity/GameEntity/GameEntity.h"
 #include "Entity/GameEntity/Component/Component.h"
 #include "Entity/GameEntity/Component/ColliderComponent/ColliderComponent.h"
+#include "Utility/StringID.h"
 
 class KinematicComponent;
 
+namespace Brokkr
+{
+    class GameEntityManager;
+    class BinaryReader;
+}
+
 class AgentController final : public Brokkr::Component
 {
     // Ownership of components
@@ -63,7 +70,15 @@ public:
     void FindPlayer();
 
 
+    // Snapshot, the KinematicComponent is not saved since Init creates it
+    [[nodiscard]] virtual uint32_t GetSnapshotID() const override { return kSnapshotID; }
+    virtual void Serialize(Brokkr::BinaryWriter& writer) const override;
+
     // Static registration function
     static void RegisterCreationFunction(Brokkr::EntityXMLParser* parser);
     static void CreateComponent(Brokkr::GameEntity* entity, tinyxml2::XMLElement* element, Brokkr::CoreSystems* coreSystems);
+    static void RegisterSnapshotFunction(Brokkr::GameEntityManager* pEntityManager);
+    static void RestoreComponent(Brokkr::GameEntity* entity, Brokkr::BinaryReader& reader, Brokkr::CoreSystems* coreSystems);
+
+    inline static constexpr uint32_t kSnapshotID = Brokkr::StringID("AgentController");
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include "Agent/AgentController.h"
+#include "Entity/GameEntityManager/GameEntityManager.h"
 #include "XMLManager/Parsers/EntityXMLParser/EntityXMLParser.h"
 
 class GameComponentsReg
@@ -9,4 +10,9 @@ public:
     {
         AgentController::RegisterCreationFunction(parser);
     }
+
+    static void SnapshotReg(Brokkr::GameEntityManager* pEntityManager)
+    {
+        AgentController::RegisterSnapshotFunction(pEntityManager);
+    }
 };